@@ -0,0 +1,85 @@
+/* Autosaver.cpp
+ *
+ * Saves snapshots of a text to a file on a worker thread.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include "Autosaver.hpp"
+#include "FileWriter.hpp"
+
+//EFFECTS: Starts the worker thread.
+Autosaver::Autosaver()
+  : busy(false), stopping(false), worker(&Autosaver::run, this) {}
+
+//EFFECTS: Finishes the jobs handed over so far, then stops the worker.
+Autosaver::~Autosaver() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  changed.notify_all();
+  worker.join();
+}
+
+//MODIFIES: *this
+//EFFECTS:  Arranges for snapshot to be saved to the file at path,
+//          which gets the permissions in mode.
+void Autosaver::save(const std::string &path, TextSnapshot snapshot,
+                     mode_t mode) {
+  hand_over(Job{path, true, std::move(snapshot), mode});
+}
+
+//MODIFIES: *this
+//EFFECTS:  Arranges for the file at path to be removed.
+void Autosaver::remove(const std::string &path) {
+  hand_over(Job{path, false, TextSnapshot(), 0});
+}
+
+//EFFECTS: Waits until the jobs handed over so far are done.
+void Autosaver::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this]() { return jobs.empty() && !busy; });
+}
+
+// Adds job, replacing any job for the same file that has not started.
+void Autosaver::hand_over(Job job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+                              [&job](const Job &waiting) {
+                                return waiting.path == job.path;
+                              }),
+               jobs.end());
+    jobs.push_back(std::move(job));
+  }
+  changed.notify_all();
+}
+
+// Runs jobs until stopping with none left.
+void Autosaver::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    changed.wait(lock, [this]() { return !jobs.empty() || stopping; });
+    if (jobs.empty()) {
+      return;
+    }
+    Job job = std::move(jobs.front());
+    jobs.pop_front();
+    busy = true;
+    lock.unlock();            // the disk is only touched without the lock
+    if (job.save) {
+      FileWriter output(job.path, job.mode);
+      job.snapshot.for_each_chunk([&output](std::string_view chunk) {
+        return output.write(chunk);
+      });
+      output.close();
+    } else {
+      std::remove(job.path.c_str());
+    }
+    lock.lock();
+    busy = false;
+    changed.notify_all();
+  }
+}
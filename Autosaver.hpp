@@ -0,0 +1,70 @@
+#ifndef AUTOSAVER_HPP
+#define AUTOSAVER_HPP
+/* Autosaver.hpp
+ *
+ * Saves snapshots of a text to a file on a worker thread, so that the
+ * thread that edits the text never waits for the disk.
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <sys/types.h>
+#include "TextBuffer.hpp"
+
+class Autosaver {
+  //OVERVIEW: A worker thread and the jobs handed to it: saving a
+  //          snapshot to a file, or removing a file. Jobs run in the
+  //          order they were handed over, except that a new job for a
+  //          file replaces one for the same file that has not started,
+  //          so only the latest snapshot of a text is ever written.
+  //          Saves go through FileWriter, so the file always holds a
+  //          whole snapshot, and a failed save is left for the next one.
+public:
+  //EFFECTS: Starts the worker thread.
+  Autosaver();
+
+  //EFFECTS: Finishes the jobs handed over so far, then stops the worker.
+  ~Autosaver();
+
+  // disable copying
+  Autosaver(const Autosaver&) = delete;
+  Autosaver& operator=(const Autosaver&) = delete;
+
+  //MODIFIES: *this
+  //EFFECTS:  Arranges for snapshot to be saved to the file at path,
+  //          which gets the permissions in mode.
+  void save(const std::string &path, TextSnapshot snapshot, mode_t mode);
+
+  //MODIFIES: *this
+  //EFFECTS:  Arranges for the file at path to be removed.
+  void remove(const std::string &path);
+
+  //EFFECTS: Waits until the jobs handed over so far are done.
+  void wait();
+
+private:
+  struct Job {
+    std::string path;
+    bool save;                // save snapshot to path, or remove path
+    TextSnapshot snapshot;
+    mode_t mode;              // permissions of a saved file
+  };
+
+  std::mutex mutex;                   // guards everything below
+  std::condition_variable changed;    // signaled when the state changes
+  std::deque<Job> jobs;               // waiting to be started
+  bool busy;                          // whether a job is running
+  bool stopping;                      // whether the destructor was called
+  std::thread worker;                 // started last, stopped first
+
+  // Adds job, replacing any job for the same file that has not started.
+  void hand_over(Job job);
+
+  // Runs jobs until stopping with none left.
+  void run();
+};
+
+#endif // AUTOSAVER_HPP
@@ -0,0 +1,156 @@
+#ifndef DISPLAY_HPP
+#define DISPLAY_HPP
+/* Display.hpp
+ *
+ * Where FEMTO shows its screen and reads its keys from: the terminal
+ * (see Terminal.hpp), or a headless display in memory that takes its
+ * keys from a script, for running the editor in tests and benchmarks
+ * without a TTY.
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Screen.hpp"
+
+class Display {
+  //OVERVIEW: Shows frames of a Screen and supplies keys, with the key
+  //          codes of curses (e.g. KEY_UP).
+public:
+  // Thrown by read_key() when there are no more keys to read.
+  struct EndOfInput {};
+
+  virtual ~Display() {}
+
+  //MODIFIES: *this
+  //EFFECTS:  Gets the display ready. With raw, control keys are read
+  //          as keys instead of being handled by the terminal.
+  virtual void start(bool raw) = 0;
+
+  //MODIFIES: *this, screen
+  //EFFECTS:  Clears the display and resets screen to the display's
+  //          size. Returns the number of bytes sent to the display.
+  virtual std::size_t reset(Screen &screen) = 0;
+
+  //MODIFIES: *this, screen
+  //EFFECTS:  Shows the cells of screen that changed since the last
+  //          frame and records them as shown. Returns the number of
+  //          bytes sent to the display.
+  virtual std::size_t present(Screen &screen) = 0;
+
+  //MODIFIES: *this
+  //EFFECTS:  Waits for and returns the next key, or throws EndOfInput
+  //          if there will be none.
+  virtual int read_key() = 0;
+
+  //MODIFIES: *this
+  //EFFECTS:  Waits up to seconds for a key to be ready to read, and
+  //          returns whether one is.
+  virtual bool wait_for_key(double seconds) = 0;
+
+  //MODIFIES: *this
+  //EFFECTS:  Alerts the user.
+  virtual void beep() = 0;
+
+  //MODIFIES: *this
+  //EFFECTS:  Gives the display back the way start() found it.
+  virtual void stop() = 0;
+};
+
+class HeadlessDisplay : public Display {
+  //OVERVIEW: A display of a fixed size that only keeps the last frame
+  //          in memory, with keys read from a script. Nothing is sent
+  //          anywhere, so present() counts each changed cell as a byte.
+public:
+  //REQUIRES: rows >= 0, cols >= 0
+  //EFFECTS:  Creates a display of the given size with no keys to read.
+  HeadlessDisplay(int rows_in, int cols_in)
+    : rows(rows_in), cols(cols_in), shown(nullptr), next_key(0),
+      beep_count(0) {}
+
+  //MODIFIES: *this
+  //EFFECTS:  Adds key to the end of the script.
+  void press(int key) {
+    keys.push_back(key);
+  }
+
+  //MODIFIES: *this
+  //EFFECTS:  Adds the characters of text to the end of the script.
+  void type(const std::string &text) {
+    for (char c : text) {
+      press(static_cast<unsigned char>(c));
+    }
+  }
+
+  //EFFECTS: Returns the number of keys not read yet.
+  int keys_left() const {
+    return keys.size() - next_key;
+  }
+
+  //REQUIRES: 0 <= y < rows of the display, a frame has been presented
+  //EFFECTS:  Returns the characters shown in row y.
+  std::string row(int y) const {
+    std::string text;
+    for (int x = 0; x < shown->cols(); ++x) {
+      text.push_back(shown->shown_at(y, x) & Screen::CHARACTER);
+    }
+    return text;
+  }
+
+  //REQUIRES: (y, x) is on the display, a frame has been presented
+  //EFFECTS:  Returns the cell shown at (y, x).
+  Screen::Cell cell(int y, int x) const {
+    return shown->shown_at(y, x);
+  }
+
+  //EFFECTS: Returns how many times beep() was called.
+  int beeps() const {
+    return beep_count;
+  }
+
+  void start(bool) override {}
+
+  std::size_t reset(Screen &screen) override {
+    screen.reset(rows, cols);
+    shown = &screen;
+    return 0;
+  }
+
+  std::size_t present(Screen &screen) override {
+    std::size_t changed = 0;
+    screen.changes([&changed](int, int, int count) {
+      changed += count;
+    });
+    screen.presented();
+    shown = &screen;
+    return changed;
+  }
+
+  int read_key() override {
+    if (next_key == keys.size()) {
+      throw EndOfInput();
+    }
+    return keys[next_key++];
+  }
+
+  // Keys come from the script at once or not at all, so this never
+  // waits.
+  bool wait_for_key(double) override {
+    return next_key < keys.size();
+  }
+
+  void beep() override {
+    ++beep_count;
+  }
+
+  void stop() override {}
+
+private:
+  int rows, cols;
+  const Screen *shown;        // screen of the last frame
+  std::vector<int> keys;      // script of keys to read
+  std::size_t next_key;       // index in keys of the next key to read
+  int beep_count;
+};
+
+#endif // DISPLAY_HPP
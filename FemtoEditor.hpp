@@ -0,0 +1,1551 @@
+#ifndef FEMTOEDITOR_HPP
+#define FEMTOEDITOR_HPP
+/**
+ * FEMTO: FEMTO Editor for Manipulating Text Ostensibly
+ *
+ * Based on E0 from Carnegie Mellon University
+ *
+ * E0 Authors: William Lovas and Robert Simmons (CMU)
+ * E0 C++ Port: Saquib Razak (University of Michigan)
+ * FEMTO Author: Amir Kamil (University of Michigan)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <ncurses.h>
+#include <sys/stat.h>
+#include "TextBuffer.hpp"
+#include "Autosaver.hpp"
+#include "Display.hpp"
+#include "FileWriter.hpp"
+#include "Highlighter.hpp"
+#include "MappedFile.hpp"
+#include "MatchIndex.hpp"
+#include "Regex.hpp"
+#include "Screen.hpp"
+
+#ifndef FEMTO_INPUT_MODE // default to terminal input mode
+#  define FEMTO_INPUT_MODE TERMINAL
+#endif
+
+// What every BasicFemtoEditor has in common, whatever its text is.
+class FemtoEditorBase {
+public:
+  static constexpr const char *version = "2.80";
+
+  enum InputMode {
+    TERMINAL, // terminal interprets control keys
+    RAW       // control keys are passed uninterpreted to FEMTO
+  };
+
+  // Files at least this large are opened in a piece table over the
+  // mapped file (see femto.cpp), which reads only the parts that are
+  // looked at, so opening one takes the same time whatever its size.
+  static const long LARGE_FILE = 64 << 20;
+
+  // Returns whether the file at path is at least LARGE_FILE bytes.
+  static bool is_large_file(const std::string &path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && info.st_size >= LARGE_FILE;
+  }
+
+  // Bytes sent to the terminal, over all frames and per frame, and the
+  // time spent drawing and sending frames.
+  struct RenderStats {
+    long frames = 0;
+    long bytes = 0;
+    long last_frame_bytes = 0;
+    long max_frame_bytes = 0;
+    double seconds = 0;
+  };
+};
+
+// An editor whose text is an EditText, which is a BasicTextBuffer.
+// FemtoEditor uses TextBuffer, built with the engine chosen at compile
+// time.
+template <typename EditText>
+class BasicFemtoEditor : public FemtoEditorBase {
+public:
+  // Initialize the editor with the given file and input mode, and
+  // show it on the given display. The display must outlive the editor.
+  BasicFemtoEditor(std::string filename_in, InputMode input_mode_in,
+              Display &display_in)
+    : baseline(1), cursor_row(1), filename(filename_in),
+      modified(false), percentage(0), status("initial"), regex_search(false),
+      generation(0),
+      autosave_interval(AUTOSAVE_TIMEOUT), autosave_time(clock_t::now()),
+      changed_since_autosave(false), recovery_checked(false),
+      input_mode(input_mode_in), display(display_in) {
+    bool loaded = filename.empty() || read_file();
+    display.start(input_mode == RAW);
+    setup_windows();
+    if (!loaded) {
+      // start a new file instead, so that saving cannot overwrite the
+      // one that was refused
+      set_message("ERROR: " + shorten_string(filename)
+                  + " is too large to edit", "File too large");
+      filename.clear();
+    }
+  }
+
+  // disable copying
+  BasicFemtoEditor(const BasicFemtoEditor&) = delete;
+  BasicFemtoEditor& operator=(const BasicFemtoEditor&) = delete;
+
+  // Give the display back. The swap file is only needed if the editor
+  // never gets here, so it is removed.
+  ~BasicFemtoEditor() {
+    if (!filename.empty()) {
+      autosaver.remove(swap_filename());
+    }
+    display.stop();
+  }
+
+  // Main interaction loop -- respond to user input until the user
+  // exits or the display runs out of input. The first time, offers to
+  // recover the text from a swap file left behind by an editor that
+  // did not exit.
+  void interact() {
+    try {
+      if (!recovery_checked) {
+        recovery_checked = true;
+        offer_recovery();
+      }
+      do {
+        autosave();
+        render_all();
+        show_highlights();
+      } while (handle_edit_input(display.read_key()));
+    } catch (const Display::EndOfInput&) {
+      // nothing more to do
+    }
+  }
+
+  // Save a snapshot of modified text to the swap file at most this
+  // often, or never if seconds < 0.
+  void set_autosave_interval(double seconds) {
+    autosave_interval = seconds;
+  }
+
+  // Wait until the autosaves started so far are on disk.
+  void wait_for_autosave() {
+    autosaver.wait();
+  }
+
+  const RenderStats &render_stats() const {
+    return stats;
+  }
+
+  // Scans for the matches to highlight on the canvas, finished and
+  // cancelled by edits, and the time the highlighter spent on them.
+  Highlighter::Stats highlight_stats() const {
+    return highlighter.stats();
+  }
+
+private:
+  using clock_t = std::chrono::steady_clock;
+  static constexpr double MESSAGE_TIMEOUT = 5; // time in seconds
+  static constexpr double AUTOSAVE_TIMEOUT = 10; // time in seconds
+  static const int AUTOSAVE_COPY_LIMIT = 64 << 20; // most bytes copied to
+                                                   // take a snapshot
+  static const std::size_t MAX_SHORT_STRING_LENGTH = 20;
+  static const std::size_t SAVE_BLOCK = 8 << 20; // bytes per write on save
+  static const std::size_t SCAN_START = 64 << 10; // bytes of a large file
+                                                  // checked for CRs
+  static constexpr double HIGHLIGHT_WAIT = 0.001; // time in seconds
+  static constexpr int HIGHLIGHT_MARGIN = 256; // characters searched on
+                                               // either side of the
+                                               // columns shown
+  static constexpr int HIGHLIGHT_LIMIT = 1 << 20; // most characters copied
+                                                  // for the highlighter
+
+  struct KeyBindings {
+    static const int EXIT1 = 24; // ^X
+    static const int EXIT2 = 17; // ^Q
+    static const int SAVE1 = 1; // ^A
+    static const int SAVE2 = 19; // ^S
+    static const int SAVE3 = 15; // ^O - pico/nano binding
+    static const int REFRESH = 12; // ^L
+    static const int FIND1 = 6; // ^F
+    static const int FIND2 = 23; // ^W - pico/nano binding
+    static const int FIND_BACKWARD = 18; // ^R
+    static const int REGEX_TOGGLE = 20; // ^T, in the search prompt
+    static const int REPLACE = 5; // ^E
+    static const int GOTO = 7; // ^G
+    static const int CUT = 11; // ^K
+    static const int UNCUT = 21; // ^U
+    static const int CANCEL = 14; // ^N
+    static const int INTERRUPT = 3; // ^C
+    static const int ESCAPE = 27;
+    static const int DELETE = 4; // ^D
+    static const int BACKSPACE2 = 127;
+    static const int BACKSPACE3 = '\b';
+    static const int NEWLINE = '\n';
+    static const int CARRIAGE_RETURN = '\r';
+    static const int WORD_LEFT1 = 542; // ^left on MacOS
+    static const int WORD_LEFT2 = 546; // ^left on Windows
+    static const int WORD_LEFT3 = 547; // ^left on MacOS (raw)
+    static const int WORD_RIGHT1 = 557; // ^right on MacOS
+    static const int WORD_RIGHT2 = 561; // ^right on Windows
+    static const int WORD_RIGHT3 = 562; // ^right on MacOS (raw)
+    static const int PAGE_DOWN = 526; // ^down on Windows
+    static const int PAGE_UP = 567; // ^up on Windows
+    static const int IGNORE1 = -1; // sent when mucking with the window
+    static const int IGNORE2 = 410; // sent when mucking with the window
+    static const int MIN_CHAR = 1;
+    static const int MAX_CHAR = 126;
+
+    static constexpr bool is_exit(int c) {
+      return c == EXIT1 || c == EXIT2 || c == INTERRUPT;
+    }
+    static constexpr bool is_save(int c) {
+      return c == SAVE1 || c == SAVE2 || c == SAVE3;
+    }
+    static constexpr bool is_refresh(int c) {
+      return c == REFRESH;
+    }
+    static constexpr bool is_goto(int c) {
+      return c == GOTO;
+    }
+    static constexpr bool is_find(int c) {
+      return c == FIND1 || c == FIND2;
+    }
+    static constexpr bool is_find_backward(int c) {
+      return c == FIND_BACKWARD;
+    }
+    static constexpr bool is_replace(int c) {
+      return c == REPLACE;
+    }
+    static constexpr bool is_regex_toggle(int c) {
+      return c == REGEX_TOGGLE;
+    }
+    static constexpr bool is_cut(int c) {
+      return c == CUT;
+    }
+    static constexpr bool is_uncut(int c) {
+      return c == UNCUT;
+    }
+    static constexpr bool is_cancel(int c) {
+      return c == CANCEL || c == INTERRUPT || c == ESCAPE;
+    }
+    static constexpr bool is_up(int c) {
+      return c == KEY_UP; // ncurses constant
+    }
+    static constexpr bool is_down(int c) {
+      return c == KEY_DOWN; // ncurses constant
+    }
+    static constexpr bool is_pageup(int c) {
+      return c == KEY_PPAGE /* ncurses constant */ || c == PAGE_UP;
+    }
+    static constexpr bool is_pagedown(int c) {
+      return c == KEY_NPAGE /* ncurses constant */ || c == PAGE_DOWN;
+    }
+    static constexpr bool is_enter(int c) {
+      return c == KEY_ENTER // ncurses constant
+        || c == NEWLINE || c == CARRIAGE_RETURN;
+    }
+    static constexpr bool is_backspace(int c) {
+      return c == KEY_BACKSPACE // ncurses constant
+        || c == BACKSPACE2 || c == BACKSPACE3;
+    }
+    static constexpr bool is_delete(int c) {
+      return c == KEY_DC /* ncurses constant */ || c == DELETE;
+    }
+    static constexpr bool is_left(int c) {
+      return c == KEY_LEFT; // ncurses constant
+    }
+    static constexpr bool is_right(int c) {
+      return c == KEY_RIGHT; // ncurses constant
+    }
+    static constexpr bool is_home(int c) {
+      return c == KEY_HOME; // ncurses constant
+    }
+    static constexpr bool is_end(int c) {
+      return c == KEY_END; // ncurses constant
+    }
+    static constexpr bool is_word_left(int c) {
+      return c == WORD_LEFT1 || c == WORD_LEFT2 || c == WORD_LEFT3;
+    }
+    static constexpr bool is_word_right(int c) {
+      return c == WORD_RIGHT1 || c == WORD_RIGHT2 || c == WORD_RIGHT3;
+    }
+    static constexpr bool is_ignore(int c) {
+      return c == IGNORE1 || c == IGNORE2;
+    }
+  };
+
+  // The minibuffer only ever holds a line of input, so it always uses a
+  // gap buffer, whatever engine EditText is built with.
+  using MiniTextBuffer = BasicTextBuffer<GapBuffer<char>>;
+
+  template <typename Text>
+  struct Buffer {
+    Text text;
+    Screen::Pane *window;
+    bool reverse;        // whether Screen::REVERSE is set on the window
+    std::string long_prefix; // prefix string before placing characters
+    std::string short_prefix; // shorter prefix for narrow windows
+    int view_row;        // cursor row
+    int view_column;     // first text column to show in cursor row
+    char left_overflow_marker;
+    char right_overflow_marker;
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    // Set prefixes to the given values.
+    void set_prefix(const std::string &long_prefix_in,
+                    const std::string &short_prefix_in) {
+      long_prefix = long_prefix_in;
+      short_prefix = short_prefix_in;
+    }
+
+    // Get appropriate prefix given window size.
+    std::string& get_prefix() {
+      // compare window size to tab + overflow markers
+      if (static_cast<int>(long_prefix.size()) > window->width() - 10) {
+        return short_prefix;
+      } else {
+        return long_prefix;
+      }
+    }
+
+    // Compute the new view column based on the cursor and move the
+    // text buffer to that position.
+    // REQUIRES: femto.text.get_row() == cursor_row
+    void recompute_view_column(BasicFemtoEditor &femto, int cursor_row,
+                               int cursor_column) {
+      if (cursor_row != view_row || cursor_column < view_column) {
+        view_row = cursor_row;
+        view_column = 0; // recompute from the left
+      }
+      text.move_to_column(view_column);
+      std::string &prefix = get_prefix();
+      int window_width = window->width() - prefix.size() - 1;
+      // column in the window where current character will be written
+      int window_column = (view_column != 0 ? 1 : 0);
+      for (; text.get_column() <= cursor_column
+             && !text.is_at_end() // handle end of buffer
+             && text.get_row() == cursor_row; // handle end of row
+           text.forward()) {
+        char c = text.data_at_cursor();
+        window_column += femto.display_width(window_column, c);
+        if (window_column > window_width && c != '\n') {
+          // slide view column to the right
+          window_width = window->width() - prefix.size() -  1;
+          int remaining = window_width - 1; //right overflow marker
+          // max of current char + 4 chars to the left of current
+          for (int i = 0, ichar = text.data_at_cursor();
+               i < 5 && remaining - femto.display_width(0, ichar) >= 0;
+               remaining -= femto.display_width(0, ichar), ++i,
+                 text.backward(), ichar = text.data_at_cursor());
+          text.forward(); // we went back too far by one character
+          view_column = text.get_column();
+          // set window column after current character
+          window_column =
+            1 + femto.display_width(1, text.data_at_cursor());
+        }
+      }
+      if (text.get_row() != cursor_row) { // we moved to the next row
+        text.up();
+      }
+      text.move_to_column(view_column);
+    }
+  };
+
+  Buffer<EditText> editbuffer = {{}, nullptr, false, "", "", 1, 0, '$', '$'};
+  Buffer<MiniTextBuffer> minibuffer = {{}, nullptr, true, "", "", 1, 0, '<', '>'};
+  int baseline;         // row of top line in canvas
+  int cursor_row;
+
+  // What the canvas currently shows, so that a frame only redraws the
+  // rows that can differ from the previous one.
+  struct Viewport {
+    int baseline;       // row of top line when drawn, 0 if nothing is drawn
+    int cursor_row;     // row that was drawn with the cursor in it
+  };
+  Viewport drawn = {0, 0};
+  std::string filename;
+  bool modified;        // whether or not the text has been modified
+  int percentage;       // how far in the text the cursor is
+  std::string status;   // file modification status
+  std::string message;  // info/error message
+  std::chrono::time_point<clock_t> message_time;
+  std::string cut_value;
+  std::string previous_search;
+  bool regex_search;    // whether searches are for regular expressions
+  MatchIndex matches;   // of previous_search, kept up to date by frames
+  Highlighter highlighter; // finds the matches of highlight_search near
+                           // the canvas on a thread of its own
+  std::shared_ptr<const Search> highlight_search; // the highlighter's copy
+                                                  // of the last search
+  long generation;      // of the text and highlight_search, counting edits
+  Highlighter::Result requested;  // window handed to the highlighter
+  Highlighter::Result highlights; // matches found, underlined on the canvas
+  std::weak_ptr<const MappedFile> source; // mapped file the text may read
+  Autosaver autosaver;  // writes the swap file in the background
+  double autosave_interval;
+  std::chrono::time_point<clock_t> autosave_time; // of the last snapshot
+  bool changed_since_autosave;
+  bool recovery_checked;
+  Screen screen{0, 0};  // everything is drawn here, then presented
+  RenderStats stats;
+  Screen::Pane canvas;
+  Screen::Pane top_bar;
+  Screen::Pane overflow_bar;
+  Screen::Pane message_bar;
+  Screen::Pane bottom_bar;
+  bool input_mode;
+  Display &display;
+  int char_widths[256]; // onscreen width of each character
+
+  // Clear the display and lay the windows out to fit it.
+  void setup_windows(bool highlight_canvas_cursor = true) {
+    display.reset(screen);
+    int ncols = screen.cols();
+    int nlines = screen.rows();
+    canvas = {&screen,
+              2           /* top: skip top padding/status bar */,
+              0           /* left: same as screen */,
+              nlines - 4  /* lines: 4 for padding/status info */,
+              ncols       /* cols: same as screen */};
+    top_bar = {&screen, 0, 0, 1 /* lines */, ncols};
+    overflow_bar = {&screen, 1, 0, 1 /* lines */, ncols};
+    message_bar = {&screen, nlines - 2, 0, 1 /* lines */, ncols};
+    bottom_bar = {&screen, nlines - 1, 0, 1 /* lines */, ncols};
+    editbuffer.window = &canvas;
+    minibuffer.window = &bottom_bar;
+    compute_character_widths();
+    drawn.baseline = 0; // the canvas was reset, so redraw all of it
+    render_all(highlight_canvas_cursor); // render everything
+  }
+
+  // Compute onscreen character widths.
+  void compute_character_widths() {
+    for (int i = 0; i <= KeyBindings::MAX_CHAR; ++i) {
+      canvas.blank();
+      canvas.move_to(0, 0);
+      canvas.add(i);
+      char_widths[i] = canvas.cursor_x();
+    }
+    // Remaining chars are escaped
+    for (unsigned i = static_cast<unsigned>(KeyBindings::MAX_CHAR + 1);
+         i < 256; ++i) {
+      char buf[11];
+      std::snprintf(buf, sizeof(buf) / sizeof(char), "%o", i);
+      char_widths[i] = 1 + std::strlen(buf);
+    }
+    // Special handling for backspace and delete
+    char_widths[static_cast<unsigned char>('\b')] = 2;
+    char_widths[static_cast<unsigned char>('\x7f')] = 2;
+  }
+
+  // Render all windows.
+  void render_all(bool highlight_canvas_cursor = true) {
+    auto start = clock_t::now();
+    render_canvas(highlight_canvas_cursor);
+    render_top_bars();
+    render_message_bar();
+    render_bottom_bar();
+    present();
+    stats.seconds += std::chrono::duration<double>(clock_t::now()
+                                                   - start).count();
+  }
+
+  // Render the minibuffer prompt, with the canvas cursor unhighlighted
+  // if unhighlight is true.
+  void render_prompt(bool unhighlight = false) {
+    auto start = clock_t::now();
+    if (unhighlight) {
+      render_canvas(false);
+    }
+    render_minibuffer();
+    present();
+    stats.seconds += std::chrono::duration<double>(clock_t::now()
+                                                   - start).count();
+  }
+
+  // Send what changed on the screen since the last frame.
+  void present() {
+    long bytes = display.present(screen);
+    ++stats.frames;
+    stats.bytes += bytes;
+    stats.last_frame_bytes = bytes;
+    stats.max_frame_bytes = std::max(stats.max_frame_bytes, bytes);
+  }
+
+  // Handle an input character in the edit buffer. Returns whether or
+  // not interaction should continue.
+  bool handle_edit_input(int c) {
+    clear_message();
+    if (KeyBindings::is_exit(c)) {
+      return !handle_exit();
+    } else if (KeyBindings::is_save(c)) {
+      set_modified(!handle_save(), true);
+    } else if (KeyBindings::is_goto(c)) {
+      handle_goto();
+    } else if (KeyBindings::is_find(c)) {
+      handle_find();
+    } else if (KeyBindings::is_find_backward(c)) {
+      handle_find(true);
+    } else if (KeyBindings::is_replace(c)) {
+      set_modified(handle_replace());
+    } else if (KeyBindings::is_cut(c)) {
+      return handle_cut();
+    } else if (KeyBindings::is_uncut(c)) {
+      handle_uncut();
+    } else if (KeyBindings::is_up(c)) {
+      editbuffer.text.up();
+    } else if (KeyBindings::is_down(c)) {
+      editbuffer.text.down();
+    } else if (KeyBindings::is_pageup(c)) {
+      move_page(2 - canvas.height());
+    } else if (KeyBindings::is_pagedown(c)) {
+      move_page(canvas.height() - 2);
+    } else {
+      set_modified(handle_buffer_input(editbuffer, c,
+                                       KeyBindings::MIN_CHAR,
+                                       KeyBindings::MAX_CHAR));
+    }
+    return true;
+  }
+
+  // Handle an input character for the given buffer. Returns whether
+  // or not the buffer was modified.
+  template <typename Text>
+  bool handle_buffer_input(Buffer<Text> &buffer, int c,
+                           int min_char, int max_char,
+                           bool highlight_canvas_cursor = true) {
+    if (KeyBindings::is_refresh(c)) {
+      setup_windows(highlight_canvas_cursor);
+    } else if (KeyBindings::is_delete(c)) {
+      return buffer.text.remove();
+    } else if (KeyBindings::is_backspace(c)) {
+      if (buffer.text.backward()) { // make sure there is a character
+        buffer.text.remove();
+        return true;
+      }
+    } else if (KeyBindings::is_left(c)) {
+      buffer.text.backward();
+    } else if (KeyBindings::is_right(c)) {
+      buffer.text.forward();
+    } else if (KeyBindings::is_home(c)) {
+      buffer.text.move_to_row_start();
+    } else if (KeyBindings::is_end(c)) {
+      buffer.text.move_to_row_end();
+    } else if (KeyBindings::is_enter(c)) {
+      buffer.text.insert('\n'); // convert to newline
+      return true;
+    } else if (KeyBindings::is_word_left(c)) {
+      // skip over alphanumeric characters
+      while (is_alphanumeric(buffer) && buffer.text.backward());
+      // skip over non-alphanumeric characters
+      while (!is_alphanumeric(buffer) && buffer.text.backward());
+    } else if (KeyBindings::is_word_right(c)) {
+      // skip over alphanumeric characters
+      while (is_alphanumeric(buffer) && buffer.text.forward());
+      // skip over non-alphanumeric characters
+      while (!is_alphanumeric(buffer) && buffer.text.forward());
+    } else if (KeyBindings::is_ignore(c)) { // do nothing
+    } else if (min_char <= c && c <= max_char) {
+      buffer.text.insert(c);
+      return true;
+    } else {
+      display.beep(); // reject and alert the user
+    }
+    return false;
+  }
+
+  // Determine whether the cursor is over an alphanumeric character.
+  template <typename Text>
+  bool is_alphanumeric(Buffer<Text> &buffer) {
+    return !buffer.text.is_at_end()
+      && ((buffer.text.data_at_cursor() >= 'a'
+           && buffer.text.data_at_cursor() <= 'z')
+          || (buffer.text.data_at_cursor() >= 'A'
+              && buffer.text.data_at_cursor() <= 'Z')
+          || (buffer.text.data_at_cursor() >= '0'
+              && buffer.text.data_at_cursor() <= '9'));
+  }
+
+  // Read a line number in the minibuffer and go to that line.
+  void handle_goto() {
+    minibuffer.set_prefix("Goto line (^N to cancel): ", "Goto: ");
+    clear_line(minibuffer);
+    get_minibuffer_input('0', '9');
+    std::string input = minibuffer.text.stringify();
+    if (!input.empty()) {
+      try {
+        int target = std::stoi(input);
+        goto_line(target);
+      } catch (const std::out_of_range&) {
+        set_message("ERROR: Invalid integer", "Invalid integer");
+      }
+    } else {
+      set_message("Canceled", "Canceled");
+    }
+  }
+
+  // Read user input in the minibuffer. Return whether input was
+  // not canceled. Keys for which handle_key returns true are handled
+  // there instead.
+  bool get_minibuffer_input(int min_char, int max_char,
+                            const std::function<bool(int)> &handle_key
+                              = nullptr) {
+    render_prompt(true); // unhighlight cursor
+    int input;
+    while (!KeyBindings::is_enter(input = display.read_key())
+           && !KeyBindings::is_cancel(input)) {
+      if (!handle_key || !handle_key(input)) {
+        handle_buffer_input(minibuffer, input, min_char, max_char, false);
+      }
+      render_prompt();
+    }
+    if (KeyBindings::is_cancel(input)) {
+      clear_line(minibuffer);
+      return false;
+    }
+    return true;
+  }
+
+  // Go to the start of a specific line in the text, or of the last
+  // line if there are fewer.
+  void goto_line(int target) {
+    editbuffer.text.seek_row(std::max(target, 1));
+  }
+
+  // Show the prompt for a search string, or for a regular expression
+  // in regex mode, to find (backward) or to replace.
+  void set_search_prompt(bool backward, bool replace = false) {
+    std::string prefix = replace ? (regex_search ? "Regex replace" : "Replace")
+                                 : (regex_search ? "Regex search" : "Search");
+    if (backward) {
+      prefix += " backward";
+    }
+    prefix += regex_search ? " (^T text, ^N to cancel)"
+                           : " (^T regex, ^N to cancel)";
+    if (!previous_search.empty()) {
+      prefix += " [" + previous_search + "]: ";
+    } else {
+      prefix += ": ";
+    }
+    std::string short_prefix = regex_search ? "Regex" : "Search";
+    if (replace) {
+      short_prefix = regex_search ? "Regex repl" : "Replace";
+    }
+    minibuffer.set_prefix(prefix,
+                          short_prefix + (backward ? " back: " : ": "));
+  }
+
+  // Read a search string in the minibuffer, or the previous one if
+  // none is typed, and make it the previous search. REGEX_TOGGLE
+  // switches between searching for a string and for a regular
+  // expression. Returns whether a search was read.
+  bool read_search(std::string &search, bool backward, bool replace = false) {
+    set_search_prompt(backward, replace);
+    clear_line(minibuffer);
+    auto toggle_regex = [this, backward, replace](int c) {
+      if (!KeyBindings::is_regex_toggle(c)) {
+        return false;
+      }
+      regex_search = !regex_search;
+      set_search_prompt(backward, replace);
+      return true;
+    };
+    if (!get_minibuffer_input(KeyBindings::MIN_CHAR, KeyBindings::MAX_CHAR,
+                              toggle_regex)) {
+      set_message("Canceled", "Canceled");
+      return false;
+    }
+    search = minibuffer.text.stringify();
+    if (search.empty() && previous_search.empty()) {
+      set_message("Canceled", "Canceled");
+      return false;
+    } else if (search.empty()) {
+      search = previous_search;
+    }
+    previous_search = search;
+    return true;
+  }
+
+  // Compile search as a string or, in regex mode, a regular expression.
+  // Returns null, with an error message, if it is not a valid one.
+  std::shared_ptr<const Search> compile_search(const std::string &search) {
+    try {
+      if (regex_search) {
+        return std::make_shared<RegexSearch>(search);
+      }
+      return std::make_shared<SubstringSearch>(search);
+    } catch (const RegexSearch::SyntaxError &error) {
+      set_message("ERROR: Invalid regex: " + error.reason, "Invalid regex");
+      return nullptr;
+    }
+  }
+
+  // Highlight the matches of search, a valid search in the current
+  // mode, from now on. The highlighter gets a search of its own, as a
+  // RegexSearch must not be used by two threads at once.
+  void highlight_matches_of(const std::string &search) {
+    if (!highlight_search || highlight_search->pattern() != search
+        || highlight_search->is_regex() != regex_search) {
+      highlight_search = compile_search(search);
+      ++generation; // the highlights found so far are of another search
+    }
+  }
+
+  // Read a search string in the minibuffer, attempt to find it after
+  // the cursor (or before it, searching backward), and if it is found,
+  // go to that location and show which match it is. REGEX_TOGGLE
+  // switches between searching for a string and for a regular
+  // expression (see RegexSearch for the syntax).
+  void handle_find(bool backward = false) {
+    std::string search;
+    if (!read_search(search, backward)) {
+      return;
+    }
+    const Search *indexed = matches.search();
+    if (!indexed || indexed->pattern() != search
+        || indexed->is_regex() != regex_search) {
+      std::shared_ptr<const Search> compiled = compile_search(search);
+      if (!compiled) {
+        return;
+      }
+      // the last frame took the edit buffer's changes, so there are none
+      matches.rebuild(compiled, editbuffer.text);
+    }
+    highlight_matches_of(search);
+
+    int count = matches.count();
+    if (count == 0) {
+      set_message("\"" + shorten_string(search) + "\" not found",
+                  "Not found");
+      return;
+    }
+    // the match after the cursor, or before it, wrapping around
+    int old_index = editbuffer.text.get_index();
+    int k = backward ? matches.count_before(old_index) - 1
+                     : matches.count_before(old_index + 1);
+    bool wrapped = k < 0 || k == count;
+    k = (k + count) % count;
+    editbuffer.text.seek_index(matches.position(k));
+    std::string of = std::to_string(k + 1) + " of " + std::to_string(count);
+    if (wrapped) {
+      set_message("Search wrapped, match " + of, "Wrapped, " + of);
+    } else {
+      set_message("Match " + of, of);
+    }
+  }
+
+  // Read a search string and a replacement in the minibuffer and
+  // replace every match in the text, as with handle_find(). The matches
+  // are found in one pass and replaced in one edit, however many there
+  // are; where string matches overlap, only the first is replaced.
+  // Returns whether the text was modified.
+  bool handle_replace() {
+    std::string search;
+    if (!read_search(search, false, true)) {
+      return false;
+    }
+    std::shared_ptr<const Search> compiled = compile_search(search);
+    if (!compiled) {
+      return false;
+    }
+    highlight_matches_of(search);
+    minibuffer.set_prefix("Replace with (^N to cancel): ", "With: ");
+    clear_line(minibuffer);
+    if (!get_minibuffer_input(KeyBindings::MIN_CHAR, KeyBindings::MAX_CHAR)) {
+      set_message("Canceled", "Canceled");
+      return false;
+    }
+    std::string replacement = minibuffer.text.stringify();
+
+    std::vector<std::pair<int, int>> ranges;
+    int end = 0; // of the last match to replace
+    compiled->find_all(editbuffer.text, 0, editbuffer.text.size(),
+                       [&ranges, &end](int at, int length) {
+      if (at >= end) {
+        ranges.emplace_back(at, length);
+        end = at + length;
+      }
+      return true;
+    });
+    if (ranges.empty()) {
+      set_message("\"" + shorten_string(search) + "\" not found",
+                  "Not found");
+      return false;
+    }
+    // the next search finds its matches again rather than have the next
+    // frame read all the replaced text to keep them up to date
+    matches.clear();
+    editbuffer.text.replace_all(ranges, replacement);
+    std::string count = std::to_string(ranges.size());
+    set_message("Replaced " + count
+                  + (ranges.size() == 1 ? " occurrence" : " occurrences"),
+                "Replaced " + count);
+    return true;
+  }
+
+  // Clear the contents of the current line and return the contents.
+  template <typename Text>
+  std::string clear_line(Buffer<Text> &buffer) {
+    std::string line;
+    buffer.text.move_to_row_start();
+    while (!buffer.text.is_at_end()) {
+      char c = buffer.text.data_at_cursor();
+      line.push_back(c);
+      if (c == '\n') {
+        break;
+      }
+      buffer.text.forward();
+    }
+    // remove the whole line, newline included, in one go
+    buffer.text.move_to_row_start();
+    buffer.text.remove(line.size());
+    return line;
+  }
+
+  // Remove each line as long as CUT is input, saving them in
+  // cut_value. Handles the input following the last CUT and returns
+  // the result.
+  bool handle_cut() {
+    std::string new_cut_value;
+    int input = KeyBindings::CUT;
+    while (KeyBindings::is_cut(input)) {
+      std::string line = clear_line(editbuffer);
+      if (line.empty()) {
+        set_message("Nothing to cut", "Nothing to cut");
+      }
+      new_cut_value += line;
+      set_modified(!new_cut_value.empty()); // update status before
+      render_all();                         // re-rendering
+      input = display.read_key();
+    }
+    if (!new_cut_value.empty()) {
+      cut_value = new_cut_value;
+    }
+    return handle_edit_input(input); // handle last user input
+  }
+
+  // Insert cut_value into the buffer with a single bulk insert.
+  void handle_uncut() {
+    editbuffer.text.insert(cut_value);
+    set_modified(!cut_value.empty());
+    if (cut_value.empty()) {
+      set_message("Nothing to uncut", "Nothing to uncut");
+    }
+  }
+
+  // Mark buffer as modified if argument is true.
+  void set_modified(bool modify = true, bool force_overwrite = false) {
+    if (modify) {
+      modified = true;
+      changed_since_autosave = true;
+      status = "modified";
+    } else if (force_overwrite) {
+      modified = modify;
+    }
+  }
+
+  // Set message state and time.
+  void set_message(const std::string &long_message,
+                   const std::string &short_message) {
+    if (static_cast<int>(long_message.size()) + 4 // [ and ] markers
+        > message_bar.width()) {
+      message = short_message;
+    } else {
+      message = long_message;
+    }
+    message_time = clock_t::now();
+  }
+
+  // Clear message state.
+  void clear_message() {
+    if (!message.empty() // clear message after timeout has passed
+        && static_cast<std::chrono::duration<double>>( // seconds
+             clock_t::now() - message_time
+           ).count() > MESSAGE_TIMEOUT) {
+      message = "";
+    }
+  }
+
+  // Handle pageup and pagedown events.
+  void move_page(int offset) {
+    // move cursor first, keeping its column; seek stops at the first
+    // and last rows
+    editbuffer.text.seek(std::max(baseline + offset, 1),
+                         editbuffer.text.get_column());
+    // set new baseline
+    if (editbuffer.text.get_row() == 1) {
+      baseline = 1;
+    } else if (editbuffer.text.get_row() < baseline + offset) {
+      // page down at the bottom should not change view
+    } else {
+      baseline = editbuffer.text.get_row();
+    }
+  }
+
+  // Return shortened string (e.g. for filenames or messages).
+  std::string shorten_string(const std::string &original,
+                             std::size_t limit = MAX_SHORT_STRING_LENGTH) {
+    std::string result = original;
+    if (original.size() > limit) {
+      result = "...";
+      result += original.substr(original.size() - limit + result.size());
+    }
+    return result;
+  }
+
+  // Handle save dialogue.
+  bool handle_save() {
+    minibuffer.set_prefix("File to write (^N to cancel): ", "Save as: ");
+    clear_line(minibuffer);
+    // add existing filename to minibuffer
+    minibuffer.text.insert(filename);
+    get_minibuffer_input(KeyBindings::MIN_CHAR, KeyBindings::MAX_CHAR);
+    std::string file_to_write = minibuffer.text.stringify();
+    if (!file_to_write.empty()) {
+      return write_file(file_to_write);
+    } else {
+      set_message("Canceled", "Canceled");
+      return !modified;
+    }
+  }
+
+  // Handle exit confirmation.
+  bool handle_exit() {
+    if (modified) {
+      minibuffer.set_prefix("Save modified buffer before "
+                            "exiting? (Y)es/(N)o/(C)ancel ",
+                            "Save? (Y/N/C) ");
+      clear_line(minibuffer);
+      render_prompt(true); // unhighlight cursor
+      while (true) {
+        int c = display.read_key();
+        if (c == 'y' || c == 'Y') {
+          return handle_save();
+        } else if (c == 'n' || c == 'N') {
+          return true;
+        } else if (c == 'c' || c == 'C' || KeyBindings::is_cancel(c)) {
+          set_message("Canceled", "Canceled");
+          return false;
+        } else {
+          display.beep(); // reject and alert the user
+        }
+      }
+    }
+    return true;
+  }
+
+  // Render the status/overflow bars at the top.
+  void render_top_bars() {
+    const char *femto_info = " U-M FEMTO ";
+    std::string file_info = (modified ? "** " : "-- ");
+    file_info +=
+      (filename.empty() ? "<new file>" :
+       shorten_string(filename, std::min<int>(MAX_SHORT_STRING_LENGTH,
+                                              top_bar.width() - 3)));
+    file_info += " ";
+    std::string position_info =
+      std::to_string(percentage) + "% ("
+      + std::to_string(editbuffer.text.get_row()) + ","
+      + std::to_string(editbuffer.text.get_column()) + ") ";
+    reset_bar(top_bar);
+    overflow_bar.blank();
+    int info_length = std::strlen(femto_info) + file_info.size()
+      + position_info.size() + status.size();
+    if (info_length <= top_bar.width()) {
+      top_bar.add(femto_info);
+    }
+    top_bar.add(file_info.c_str());
+    if (info_length - int(std::strlen(femto_info)) <= top_bar.width()) {
+      top_bar.add(position_info.c_str());
+      top_bar.add(status.c_str());
+    } else {
+      reset_bar(overflow_bar);
+      overflow_bar.add(position_info.c_str());
+      overflow_bar.add(status.c_str());
+      overflow_bar.attributes_off(Screen::REVERSE);
+    }
+    top_bar.attributes_off(Screen::REVERSE);
+  }
+
+  // Reset given bar to be blank, with default position and attributes.
+  void reset_bar(Screen::Pane &bar) {
+    bar.blank();
+    for (int i = 0; i < bar.width(); ++i) {
+      bar.add(' '|Screen::STANDOUT);
+    }
+    bar.move_to(0, 0);
+    bar.attributes_on(Screen::REVERSE);
+  }
+
+  // Render the message bar near the bottom.
+  void render_message_bar() {
+    message_bar.blank();
+    if (!message.empty()) {
+      // center message
+      int remaining = message_bar.width() - message.size() - 4;
+      message_bar.move_to(0, remaining / 2);
+      message_bar.attributes_on(Screen::REVERSE);
+      message_bar.add("[ ");
+      message_bar.add(message.c_str());
+      message_bar.add(" ]");
+      message_bar.attributes_off(Screen::REVERSE);
+    }
+  }
+
+  // Render the command/minibuffer bar at the bottom.
+  void render_bottom_bar() {
+    reset_bar(bottom_bar);
+    bottom_bar.add(" ^X exit | ^F find | ^R find back | ^E replace | ^A save"
+            " | ^K cut | ^U uncut | ^G goto | ^L redraw");
+    bottom_bar.attributes_off(Screen::REVERSE);
+  }
+
+  // Render the minibuffer at the bottom.
+  void render_minibuffer() {
+    reset_bar(bottom_bar);
+    int old_column = minibuffer.text.get_column();
+    render_row(minibuffer, 1, old_column, true);
+    bottom_bar.attributes_off(Screen::REVERSE);
+    minibuffer.text.move_to_column(old_column); // restore position
+    if (minibuffer.text.is_at_end()) {
+      bottom_bar.add(' '|Screen::NORMAL);
+    }
+  }
+
+  // Render the canvas with the text data. Only the rows that can look
+  // different from the last frame are redrawn: the rows the cursor left
+  // and entered, the rows in the buffer's change log, and, when an edit
+  // added or removed rows, every row from the edit down. Scrolling
+  // redraws the whole canvas. Each redrawn row is found through the line
+  // index, so the cost of a frame depends on the rows redrawn and not on
+  // the size of the file. The change log is also where the index of
+  // search matches learns about edits, and where the highlights learn
+  // that they are out of date: the rows redrawn after an edit show none
+  // until the highlighter has scanned the text again.
+  void render_canvas(bool highlight_cursor = true) {
+    rebase();
+
+    // save current position
+    int old_row = editbuffer.text.get_row();
+    int old_column = editbuffer.text.get_column();
+    bool at_end = editbuffer.text.is_at_end();
+    percentage = at_end ? 100 :
+      100LL * editbuffer.text.get_index() / editbuffer.text.size();
+
+    // rows past the canvas need not have been found yet
+    int row_count = editbuffer.text.rows_up_to(baseline + canvas.height());
+    int size = editbuffer.text.size();
+    int shifted_from = std::numeric_limits<int>::max(); // rows that moved
+    int first_changed = shifted_from, last_changed = 0;
+    for (const TextChange &change : editbuffer.text.changes()) {
+      if (change.removed_rows != change.inserted_rows) {
+        shifted_from = std::min(shifted_from, change.row);
+      }
+      first_changed = std::min(first_changed, change.row);
+      if (change.index + change.inserted == size) {
+        // it runs to the end, like one that replaces the whole buffer,
+        // whose rows are only those found so far
+        last_changed = std::numeric_limits<int>::max();
+      } else {
+        last_changed = std::max(last_changed,
+                                change.row + change.inserted_rows);
+      }
+    }
+    matches.update(editbuffer.text.changes(), editbuffer.text);
+    if (!editbuffer.text.changes().empty()) {
+      ++generation;
+    }
+    editbuffer.text.clear_changes();
+    if (drawn.baseline != baseline) {
+      canvas.blank();
+      shifted_from = baseline;
+    }
+
+    const std::vector<std::pair<int, int>> *marked =
+      highlights.generation == generation ? &highlights.matches : nullptr;
+    // display as many rows as fit on the canvas, starting at baseline
+    for (int row = baseline; row < baseline + canvas.height(); ++row) {
+      if (row < shifted_from && (row < first_changed || row > last_changed)
+          && row != old_row && row != drawn.cursor_row) {
+        continue; // unchanged since the last frame
+      }
+      canvas.move_to(row - baseline, 0);
+      canvas.clear_to_eol();
+      if (row > row_count) {
+        continue; // past the last row: leave blank
+      }
+      editbuffer.text.seek_row(row); // move to start of target row
+      render_row(editbuffer, old_row, old_column, highlight_cursor, marked);
+      if (row == old_row && highlight_cursor && at_end) {
+        // add highlighted cursor at the end of the buffer
+        canvas.add(' '|Screen::STANDOUT);
+      }
+    }
+    drawn = {baseline, old_row};
+    request_highlights();
+
+    // restore previous position
+    editbuffer.text.seek(old_row, old_column);
+  }
+
+  // Handle character escaping when displaying to the given window.
+  void escape_char(Screen::Pane *window, char display,
+                   Screen::Cell attributes) {
+    if (display == '\b' || display == '\x7f') {
+      // special handling for backspace and delete
+      window->add('^'|attributes);
+      window->add((display == '\b' ? 'H' : '?')|attributes);
+    } else if (static_cast<unsigned char>(display) > KeyBindings::MAX_CHAR) {
+      // escape these with a backslash
+      window->add('\\'|attributes);
+      char buf[11];
+      std::snprintf(buf, sizeof(buf) / sizeof(char), "%o",
+                    static_cast<unsigned char>(display));
+      for (std::size_t i = 0; i < std::strlen(buf); ++i) {
+        window->add(buf[i]|attributes);
+      }
+    } else {
+      window->add(display|attributes);
+    }
+  }
+
+  // Display a character in the window with proper highlighting, and
+  // underlined if it is marked.
+  template <typename Text>
+  void display_char(Buffer<Text> &buffer, char display, bool highlight,
+                    bool marked = false) {
+    if (highlight && buffer.reverse) {
+      buffer.window->attributes_off(Screen::REVERSE);
+      escape_char(buffer.window, display, Screen::NORMAL);
+      buffer.window->attributes_on(Screen::REVERSE);
+    } else if (highlight) {
+      escape_char(buffer.window, display, Screen::STANDOUT);
+    } else {
+      escape_char(buffer.window, display,
+                  marked ? Screen::UNDERLINE : Screen::NORMAL);
+    }
+  }
+
+  // Compute display width of a character written at column x.
+  int display_width(int x, char c) {
+    if (c == '\t') { // special case for tab
+      int width = char_widths[static_cast<unsigned char>(c)];
+      return width - x % width;
+    } else {
+      return char_widths[static_cast<unsigned char>(c)];
+    }
+  }
+
+  // Render the current buffer row in the window, marking the characters
+  // of the matches in marked, if given: (index, length) pairs in order
+  // that do not overlap.
+  template <typename Text>
+  void render_row(Buffer<Text> &buffer, int cursor_row, int cursor_column,
+                  bool highlight_cursor,
+                  const std::vector<std::pair<int, int>> *marked = nullptr) {
+    int init_y = buffer.window->cursor_y(); // initial row
+    render_current_row_prefix(buffer, cursor_row, cursor_column);
+    std::vector<std::pair<int, int>>::const_iterator mark, marks_end;
+    if (marked) {
+      // the first match that ends after the first character shown
+      int first = buffer.text.get_index();
+      mark = std::partition_point(marked->begin(), marked->end(),
+                                  [first](const std::pair<int, int> &match) {
+                                    return match.first + match.second <= first;
+                                  });
+      marks_end = marked->end();
+    }
+    for (int current_row = buffer.text.get_row();
+         !buffer.text.is_at_end()
+           && buffer.text.get_row() == current_row;
+         buffer.text.forward()) {
+      char c = buffer.text.data_at_cursor();
+      // The display character is either ' ' (if it's a newline) or
+      // the char. The display character is what gets highlighted if
+      // the current position is at that point.
+      char display = (c == '\n' || c == '\r') ? ' ' : c;
+      bool highlight = false;
+      if (highlight_cursor
+          && buffer.text.get_row() == cursor_row
+          && buffer.text.get_column() == cursor_column) {
+        highlight = true;
+      }
+      bool in_match = false;
+      if (marked) {
+        int index = buffer.text.get_index();
+        while (mark != marks_end && mark->first + mark->second <= index) {
+          ++mark;
+        }
+        in_match = mark != marks_end && mark->first <= index;
+      }
+
+      int x, y;
+      y = buffer.window->cursor_y(); // current location
+      x = buffer.window->cursor_x();
+      if (c == '\n' && x == buffer.window->width() - 1 && y == init_y) {
+        // Newline (edge case, newline at end of line)
+        display_char(buffer, display, highlight, in_match);
+      } else if (c == '\n' && x < buffer.window->width() - 1) {
+        // Newline (common case)
+        display_char(buffer, display, highlight, in_match);
+        buffer.window->add('\n');
+      } else if (display_width(x, c) >= buffer.window->width() - x) {
+        // Character goes off window
+        display_char(buffer, display, highlight, in_match);
+        buffer.window->move_to(init_y, buffer.window->width() - 1);
+        buffer.window->add(buffer.right_overflow_marker);
+        break;
+      } else {
+        // Show a regular character (common case)
+        display_char(buffer, display, highlight, in_match);
+      }
+    }
+  }
+
+  // Render the start of a row if it is the current row. Moves the
+  // buffer to the first character to be displayed.
+  template <typename Text>
+  void render_current_row_prefix(Buffer<Text> &buffer, int cursor_row,
+                                 int cursor_column) {
+    if (cursor_row == buffer.text.get_row()) {
+      // Show prefix
+      std::string &prefix = buffer.get_prefix();
+      for (std::size_t i = 0; i < prefix.size(); ++i) {
+        display_char(buffer, prefix[i], false);
+      }
+      // Handle showing subset of current line if it is too long
+      buffer.recompute_view_column(*this, cursor_row, cursor_column);
+      if (buffer.view_column != 0) {
+        // not showing line start - add marker
+        display_char(buffer, buffer.left_overflow_marker, false);
+      }
+    }
+  }
+
+  // Hand the highlighter the columns shown of the rows on the canvas,
+  // and of a canvas' worth of rows above and below them to scroll into,
+  // with HIGHLIGHT_MARGIN characters on either side, unless it has them
+  // already, so that the matches in them are ready to be drawn. They are
+  // copied, so the text can be edited during the scan, but only up to
+  // HIGHLIGHT_LIMIT characters, however long the rows are. Rows that are
+  // all short are copied whole.
+  void request_highlights() {
+    if (!highlight_search) {
+      return;
+    }
+    // sets [begin, end) to rows first to last, but the last one's '\n'
+    auto span = [this](int first, int last, int &begin, int &end) {
+      int last_begin;
+      editbuffer.text.seek_row(first);
+      begin = editbuffer.text.get_index();
+      editbuffer.text.seek_row(last);
+      editbuffer.text.row_range(editbuffer.text.get_index(), last_begin,
+                                end);
+    };
+    // calls visit(begin, end) with the columns shown of each row from
+    // first to last, and margin characters on either side of them, until
+    // it returns false
+    auto for_each_part = [this](int first, int last, int margin,
+                                auto visit) {
+      editbuffer.text.seek_row(first);
+      int begin = editbuffer.text.get_index();
+      for (int row = first; row <= last; ++row) {
+        int row_end;
+        editbuffer.text.row_range(begin, begin, row_end);
+        int column = row != editbuffer.view_row ? 0 :
+          std::min(editbuffer.view_column, row_end - begin);
+        if (!visit(std::max(begin, begin + column - margin),
+                   std::min(row_end, begin + column + canvas.width()
+                                       + margin))) {
+          return;
+        }
+        begin = row_end + 1;
+      }
+    };
+    int row_count = editbuffer.text.rows_up_to(baseline
+                                               + 2 * canvas.height());
+    int last_shown = std::min(baseline + canvas.height() - 1, row_count);
+    int begin, end;
+    if (requested.generation == generation) {
+      span(baseline, last_shown, begin, end);
+      bool covered = std::any_of(
+        requested.ranges.begin(), requested.ranges.end(),
+        [begin, end](const std::pair<int, int> &range) {
+          return range.first <= begin && end <= range.second;
+        });
+      if (!covered) {
+        // a row too long to be copied whole may be on the canvas
+        covered = true;
+        for_each_part(baseline, last_shown, 0,
+                      [this, &covered](int begin, int end) {
+          // the last range that starts at or before begin
+          auto range = std::partition_point(
+            requested.ranges.begin(), requested.ranges.end(),
+            [begin](const std::pair<int, int> &r) { return r.first <= begin; });
+          covered = range != requested.ranges.begin()
+                    && end <= std::prev(range)->second;
+          return covered;
+        });
+      }
+      if (covered) {
+        return;
+      }
+    }
+    int first = std::max(baseline - canvas.height(), 1);
+    int last = std::min(last_shown + canvas.height(), row_count);
+    span(first, last, begin, end);
+    std::vector<Highlighter::Part> window;
+    if (end - begin <= std::min((last - first + 1)
+                                  * (canvas.width() + 2 * HIGHLIGHT_MARGIN),
+                                HIGHLIGHT_LIMIT)) {
+      window.push_back({begin, end, 0, std::string()});
+    } else {
+      int copied = 0;
+      for_each_part(first, last, HIGHLIGHT_MARGIN,
+                    [&window, &copied](int begin, int end) {
+        copied += end - begin + 2;
+        if (copied > HIGHLIGHT_LIMIT) {
+          return false;
+        }
+        if (!window.empty() && window.back().end + 1 == begin) {
+          window.back().end = end; // a whole row after one kept to its end
+        } else {
+          window.push_back({begin, end, 0, std::string()});
+        }
+        return true;
+      });
+    }
+    requested.generation = generation;
+    requested.ranges.clear();
+    int size = editbuffer.text.size();
+    for (Highlighter::Part &part : window) {
+      // with the characters around it, for ^ and $
+      part.at = std::max(part.begin - 1, 0);
+      part.text = editbuffer.text.substr(part.at,
+                                         std::min(part.end + 1, size)
+                                           - part.at);
+      requested.ranges.emplace_back(part.begin, part.end);
+    }
+    highlighter.scan(generation, highlight_search, std::move(window));
+  }
+
+  // Until a key is ready, wait for the highlighter, then redraw the
+  // canvas with the matches it found. A key that comes in meanwhile
+  // waits at most HIGHLIGHT_WAIT.
+  void show_highlights() {
+    while (!highlighter.idle() && !display.wait_for_key(0)) {
+      if (highlighter.take(highlights, HIGHLIGHT_WAIT)) {
+        drawn.baseline = 0; // redraw every row, with the matches marked
+        render_all();
+      }
+    }
+  }
+
+  // Move the baseline by half the window if the cursor is offscreen.
+  // Also set the cursor row and reset the view column if needed.
+  void rebase() {
+    if (editbuffer.text.get_row() < baseline
+        || editbuffer.text.get_row() >= baseline + canvas.height()) {
+      baseline =
+        std::max(1, editbuffer.text.get_row() - canvas.height() / 2);
+    }
+    if (editbuffer.text.get_row() != cursor_row) {
+      editbuffer.view_column = 0;
+      cursor_row = editbuffer.text.get_row();
+    }
+  }
+
+  // Name of the swap file that holds autosaves of the file: a hidden
+  // file next to it.
+  std::string swap_filename() const {
+    std::size_t slash = filename.rfind('/');
+    std::size_t base = slash == std::string::npos ? 0 : slash + 1;
+    return filename.substr(0, base) + "." + filename.substr(base) + ".swp";
+  }
+
+  // Permissions of the swap file: no more than the file's own, since it
+  // holds the same text, or just the user's for a new file.
+  mode_t swap_mode() const {
+    struct stat info;
+    if (::stat(filename.c_str(), &info) != 0) {
+      return 0600;
+    }
+    return info.st_mode & 0777;
+  }
+
+  // Hand a snapshot of the text to the autosaver if it changed and the
+  // last one was taken long enough ago; the autosaver writes it out on
+  // its own thread. Most storage shares its blocks with the snapshot,
+  // but std::list and List have to be copied here, so a text in them
+  // too large to copy without holding up typing is not autosaved, and
+  // the message bar says so each time an autosave is missed.
+  void autosave() {
+    if (!changed_since_autosave || filename.empty() || autosave_interval < 0
+        || std::chrono::duration<double>(clock_t::now()
+                                         - autosave_time).count()
+           < autosave_interval) {
+      return;
+    }
+    if (!editbuffer.text.snapshot_is_cheap()
+        && editbuffer.text.size() > AUTOSAVE_COPY_LIMIT) {
+      set_message("Too large to autosave; save with ^S", "Not autosaved");
+      autosave_time = clock_t::now();
+      return;
+    }
+    autosaver.save(swap_filename(), editbuffer.text.snapshot(), swap_mode());
+    autosave_time = clock_t::now();
+    changed_since_autosave = false;
+  }
+
+  // If a swap file at least as new as the file is left over, ask whether
+  // to recover the text from it, and do so, or remove it.
+  void offer_recovery() {
+    struct stat swap_info, file_info;
+    if (filename.empty()
+        || ::stat(swap_filename().c_str(), &swap_info) != 0
+        || (::stat(filename.c_str(), &file_info) == 0
+            && swap_info.st_mtime < file_info.st_mtime)) {
+      return;
+    }
+    minibuffer.set_prefix("Recover unsaved changes from "
+                          + shorten_string(swap_filename())
+                          + "? (Y)es/(N)o ", "Recover? (Y/N) ");
+    clear_line(minibuffer);
+    render_prompt(true); // unhighlight cursor
+    while (true) {
+      int c = display.read_key();
+      if (c == 'y' || c == 'Y') {
+        if (load_file(swap_filename())) {
+          set_modified();
+          set_message("Recovered " + shorten_string(swap_filename()),
+                      "Recovered");
+        } else {
+          set_message("ERROR: " + shorten_string(swap_filename())
+                      + " is too large to edit", "File too large");
+        }
+        break;
+      } else if (c == 'n' || c == 'N' || KeyBindings::is_cancel(c)) {
+        autosaver.remove(swap_filename());
+        break;
+      } else {
+        display.beep(); // reject and alert the user
+      }
+    }
+    clear_line(minibuffer);
+  }
+
+  // Read initial contents of the file. Returns false if it is too large.
+  bool read_file() {
+    return load_file(filename);
+  }
+
+  // Replace the text with the contents of the file at path. Returns
+  // false, leaving the text alone, if the file is too large for the
+  // buffer, whose indices are ints.
+  bool load_file(const std::string &path) {
+    auto file = std::make_shared<const MappedFile>(path);
+    if (!file->is_open()) {
+      editbuffer.text.assign(std::string());
+      return true; // new (or empty) file
+    }
+    std::string_view mapped = file->view();
+    if (mapped.size()
+        > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+      return false;
+    }
+    // A large file is taken to use the line endings its start does, so
+    // that opening it does not read all of it; CRs further on are then
+    // kept as they are.
+    std::size_t from =
+      mapped.size() < static_cast<std::size_t>(LARGE_FILE)
+        ? mapped.find('\r') : mapped.substr(0, SCAN_START).find('\r');
+    if (from == std::string_view::npos) {
+      // Nothing to convert, so the buffer takes the mapping as it is: a
+      // piece table reads it in place, finding its rows as they are
+      // looked at, and everything else copies it. Pages touched while
+      // copying are dropped again, so only the parts that are looked at
+      // later come back into memory.
+      editbuffer.text.assign(mapped, file);
+      file->release();
+      source = file;
+      return true;
+    }
+    // Convert CR and CRLF to just LF, compacting a copy in place. find()
+    // is a memchr scan, and the text between CRs is moved in blocks.
+    std::string contents(mapped);
+    std::size_t length = from;
+    while (from < contents.size()) {
+      contents[length++] = '\n';             // contents[from] is a CR
+      if (++from < contents.size() && contents[from] == '\n') {
+        ++from;
+      }
+      std::size_t next = std::min(contents.find('\r', from),
+                                  contents.size());
+      std::memmove(&contents[length], &contents[from], next - from);
+      length += next - from;
+      from = next;
+    }
+    contents.resize(length);
+    // hand the contents over; the cursor starts at the top
+    editbuffer.text.assign(std::move(contents));
+    return true;
+  }
+
+  // Write the contents of the buffer to the file.
+  bool write_file(const std::string &file_to_write) {
+    // The new contents go to a file of their own that replaces the old
+    // one only once it is all on disk. That also keeps the old file
+    // readable through the mapping the text may still be reading from.
+    auto mapped = source.lock();
+    FileWriter output(file_to_write);
+    // write the storage's blocks straight out instead of copying the
+    // whole buffer into one string first; pages read from the mapping
+    // are dropped again a few MB at a time, so saving does not pull
+    // the whole file into memory
+    editbuffer.text.for_each_chunk([&](std::string_view chunk) {
+      for (std::size_t at = 0; at < chunk.size(); at += SAVE_BLOCK) {
+        std::string_view part = chunk.substr(at, SAVE_BLOCK);
+        if (!output.write(part)) {
+          return false;
+        }
+        if (mapped) {
+          mapped->release(part);
+        }
+      }
+      return true;
+    });
+    if (output.close()) {
+      autosaver.remove(swap_filename()); // the file has it all now
+      changed_since_autosave = false;
+      filename = file_to_write;
+      status = "saved";
+      set_message("Wrote " + shorten_string(file_to_write),
+                  "Wrote file");
+      return true;
+    } else {
+      set_message("ERROR: Unable to write "
+                  + shorten_string(file_to_write),
+                  "Write FAILED");
+    }
+    return !modified;
+  }
+};
+
+using FemtoEditor = BasicFemtoEditor<TextBuffer>;
+
+#endif // FEMTOEDITOR_HPP
@@ -0,0 +1,475 @@
+#include "FemtoEditor.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Rows of a headless display: bars on rows 0-1, the canvas on rows 2-7,
+// the message bar on row 8, and the bottom bar on row 9.
+static const int HEIGHT = 10;
+static const int WIDTH = 40;
+
+// EFFECTS: Returns the name of a scratch file for a test, unique to this
+//          process so that the tests of every engine can run at once.
+static string scratch_file(const string &name) {
+    return "FemtoEditor_tests-" + to_string(::getpid()) + "-" + name
+        + ".tmp";
+}
+
+// EFFECTS: Returns the name of the swap file the editor uses for filename.
+static string swap_file(const string &filename) {
+    return "." + filename + ".swp";
+}
+
+TEST(test_typing_is_rendered) {
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor("", FemtoEditor::TERMINAL, display);
+    display.type("hello\nworld");
+    editor.interact();
+    ASSERT_EQUAL(display.keys_left(), 0);
+    ASSERT_EQUAL(display.row(2), "hello" + string(WIDTH - 5, ' '));
+    ASSERT_EQUAL(display.row(3).substr(0, 6), "world ");
+    ASSERT_EQUAL(display.cell(3, 5), ' '|Screen::STANDOUT); // the cursor
+    ASSERT_TRUE(display.row(0).find("** <new file>") != string::npos);
+    ASSERT_TRUE(display.row(0).find("(2,5)") != string::npos);
+    ASSERT_EQUAL(display.row(9).substr(0, 8), " ^X exit");
+    ASSERT_EQUAL(display.cell(9, 0), ' '|Screen::REVERSE);
+}
+
+TEST(test_overflow_markers) {
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor("", FemtoEditor::TERMINAL, display);
+    string digits;
+    for (int i = 0; i < 100; ++i) {
+        digits.push_back('0' + i % 10);
+    }
+    display.type(digits);
+    display.press(KEY_HOME);
+    editor.interact();
+    ASSERT_EQUAL(display.row(2), digits.substr(0, WIDTH - 1) + "$");
+
+    display.press(KEY_END);         // scrolls the row to show the end
+    editor.interact();
+    string row = display.row(2);
+    ASSERT_EQUAL(row[0], '$');
+    int end = row.find_last_not_of(' ');
+    ASSERT_EQUAL(row.substr(end - 2, 3), "789");
+    ASSERT_EQUAL(display.cell(2, end + 1), ' '|Screen::STANDOUT);
+}
+
+TEST(test_minibuffer_prompt) {
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor("", FemtoEditor::TERMINAL, display);
+    display.type("a\nb\nc");
+    display.press(7);               // ^G
+    display.type("2");
+    editor.interact();              // stops in the middle of the prompt
+    ASSERT_EQUAL(display.row(9).substr(0, 28),
+                 "Goto line (^N to cancel): 2 ");
+    ASSERT_EQUAL(display.cell(2, 0), static_cast<Screen::Cell>('a'));
+
+    display.press(7);               // ^G, from the start again
+    display.type("2\n");
+    display.press(KEY_DOWN);
+    display.press(500);             // not bound to anything
+    editor.interact();
+    ASSERT_EQUAL(display.beeps(), 1);
+    ASSERT_TRUE(display.row(0).find("(3,0)") != string::npos);
+    ASSERT_EQUAL(display.cell(4, 0), 'c'|Screen::STANDOUT);
+}
+
+TEST(test_search_wraps_around) {
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor("", FemtoEditor::TERMINAL, display);
+    display.type("one two\nthree two\nfour");
+    display.press(6);               // ^F
+    display.type("two\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(0).find("(1,4)") != string::npos);
+    ASSERT_TRUE(display.row(8).find("Search wrapped, match 1 of 2")
+                != string::npos);
+
+    display.press(6);               // ^F, with the same string
+    display.type("\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(0).find("(2,6)") != string::npos);
+    ASSERT_EQUAL(display.cell(3, 6), 't'|Screen::STANDOUT);
+    ASSERT_TRUE(display.row(8).find("Match 2 of 2") != string::npos);
+
+    display.press(6);
+    display.type("\n");
+    display.press(6);
+    display.type("five\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(0).find("(1,4)") != string::npos);
+    ASSERT_TRUE(display.row(8).find("not found") != string::npos);
+}
+
+TEST(test_search_backward_counts_edited_matches) {
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor("", FemtoEditor::TERMINAL, display);
+    display.type("ab ab\nab");
+    display.press(18);              // ^R
+    display.type("ab\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(0).find("(2,0)") != string::npos);
+    ASSERT_TRUE(display.row(8).find("Match 3 of 3") != string::npos);
+
+    display.type("ab");             // one more match, ending at the cursor
+    display.press(18);
+    display.type("\n");
+    editor.interact();
+    ASSERT_EQUAL(display.row(3).substr(0, 5), "abab ");
+    ASSERT_TRUE(display.row(0).find("(2,0)") != string::npos);
+    ASSERT_TRUE(display.row(8).find("Match 3 of 4") != string::npos);
+
+    for (int i = 0; i < 3; ++i) {
+        display.press(18);
+        display.type("\n");
+    }
+    editor.interact();
+    ASSERT_TRUE(display.row(0).find("(2,2)") != string::npos);
+    ASSERT_TRUE(display.row(8).find("Search wrapped, match 4 of 4")
+                != string::npos);
+}
+
+TEST(test_regex_search) {
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor("", FemtoEditor::TERMINAL, display);
+    display.type("req-17 ok\nreq-x\nreq-2024 failed");
+    display.press(6);               // ^F
+    display.press(20);              // ^T, for a regular expression
+    display.type("req");
+    editor.interact();              // stops in the middle of the prompt
+    ASSERT_EQUAL(display.row(9).substr(0, 11), "Regex: req ");
+    display.press(6);               // the mode sticks, until ^T again
+    display.press(20);
+    display.type("req");
+    editor.interact();
+    ASSERT_EQUAL(display.row(9).substr(0, 12), "Search: req ");
+    display.press(6);
+    display.press(20);
+    display.type("req-[0-9]+\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(0).find("(1,0)") != string::npos);
+    ASSERT_TRUE(display.row(8).find("Search wrapped, match 1 of 2")
+                != string::npos);
+
+    display.press(6);               // still a regular expression
+    display.type("\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(0).find("(3,0)") != string::npos);
+    ASSERT_TRUE(display.row(8).find("Match 2 of 2") != string::npos);
+
+    display.type("req-9 ");         // a match the index picks up
+    display.press(18);              // ^R
+    display.type("\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(0).find("(3,0)") != string::npos);
+    ASSERT_TRUE(display.row(8).find("Match 2 of 3") != string::npos);
+
+    display.press(6);
+    display.type("req-(\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(0).find("(3,0)") != string::npos);
+    ASSERT_TRUE(display.row(8).find("Invalid regex: missing )")
+                != string::npos);
+}
+
+TEST(test_replace_all) {
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor("", FemtoEditor::TERMINAL, display);
+    display.type("one two\none three\ntwo one");
+    display.press(5);               // ^E
+    display.type("one");
+    editor.interact();              // stops in the middle of the prompt
+    ASSERT_EQUAL(display.row(9).substr(0, 13), "Replace: one ");
+    display.press(5);
+    display.type("one\n1\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(8).find("Replaced 3 occurrences")
+                != string::npos);
+    ASSERT_EQUAL(display.row(2).substr(0, 6), "1 two ");
+    ASSERT_EQUAL(display.row(3).substr(0, 8), "1 three ");
+    ASSERT_EQUAL(display.row(4).substr(0, 6), "two 1 ");
+    ASSERT_TRUE(display.row(0).find("(3,5) modified") != string::npos);
+
+    display.press(5);
+    display.press(20);              // ^T, for a regular expression
+    display.type("t[a-z]+\nT\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(8).find("Replaced 3 occurrences")
+                != string::npos);
+    ASSERT_EQUAL(display.row(2).substr(0, 4), "1 T ");
+    ASSERT_EQUAL(display.row(3).substr(0, 4), "1 T ");
+    ASSERT_EQUAL(display.row(4).substr(0, 4), "T 1 ");
+
+    display.press(5);
+    display.type("x+\n");
+    display.type("y\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(8).find("\"x+\" not found") != string::npos);
+    display.press(5);
+    display.type("(\n");
+    editor.interact();
+    ASSERT_TRUE(display.row(8).find("Invalid regex: missing )")
+                != string::npos);
+    display.press(5);
+    display.type("1\n");
+    display.press(14);              // ^N at the replacement
+    editor.interact();
+    ASSERT_TRUE(display.row(8).find("Canceled") != string::npos);
+    ASSERT_EQUAL(display.row(4).substr(0, 4), "T 1 ");
+}
+
+TEST(test_matches_on_screen_are_underlined) {
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor("", FemtoEditor::TERMINAL, display);
+    display.type("one two\nthree two\nfour");
+    editor.interact();
+    ASSERT_EQUAL(display.cell(2, 5), static_cast<Screen::Cell>('w'));
+    display.press(6);               // ^F
+    display.type("two\n");
+    editor.interact();              // waits for the highlighter at the end
+    ASSERT_EQUAL(display.cell(2, 4), 't'|Screen::STANDOUT); // the cursor
+    ASSERT_EQUAL(display.cell(2, 5), 'w'|Screen::UNDERLINE);
+    ASSERT_EQUAL(display.cell(2, 6), 'o'|Screen::UNDERLINE);
+    ASSERT_EQUAL(display.cell(2, 7), static_cast<Screen::Cell>(' '));
+    ASSERT_EQUAL(display.cell(3, 6), 't'|Screen::UNDERLINE);
+    ASSERT_EQUAL(display.cell(3, 5), static_cast<Screen::Cell>(' '));
+
+    display.type("two ");           // an edit makes one more match
+    editor.interact();
+    ASSERT_EQUAL(display.row(2).substr(0, 12), "one two two ");
+    ASSERT_EQUAL(display.cell(2, 4), 't'|Screen::UNDERLINE);
+    ASSERT_EQUAL(display.cell(2, 8), 't'|Screen::STANDOUT);
+    ASSERT_EQUAL(display.cell(2, 9), 'w'|Screen::UNDERLINE);
+
+    // rows further down are scanned as they come on screen
+    display.press(KEY_DOWN);
+    display.press(KEY_DOWN);
+    display.press(KEY_END);
+    for (int i = 0; i < 30; ++i) {
+        display.type("\nrow two");
+    }
+    editor.interact();              // scrolled to show rows 30 to 33
+    ASSERT_EQUAL(display.row(2).substr(0, 8), "row two ");
+    ASSERT_EQUAL(display.cell(2, 4), 't'|Screen::UNDERLINE);
+    ASSERT_EQUAL(display.cell(5, 4), 't'|Screen::UNDERLINE);
+    ASSERT_TRUE(editor.highlight_stats().scans >= 3);
+}
+
+TEST(test_matches_far_along_a_long_row_are_underlined) {
+    const string filename = scratch_file("long");
+    std::ofstream(filename, std::ios::binary)
+        << "two " << string(5000, 'x') << " two two\nsecond two\n";
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor(filename, FemtoEditor::TERMINAL, display);
+    std::remove(filename.c_str());
+    display.press(KEY_RIGHT);
+    display.press(6);               // ^F, to the second "two" of row 1
+    display.type("two\n");
+    editor.interact();              // waits for the highlighter at the end
+    ASSERT_EQUAL(display.row(2).substr(0, 15), "$xxxxx two two ");
+    ASSERT_EQUAL(display.cell(2, 7), 't'|Screen::STANDOUT); // the cursor
+    ASSERT_EQUAL(display.cell(2, 8), 'w'|Screen::UNDERLINE);
+    ASSERT_EQUAL(display.cell(2, 10), static_cast<Screen::Cell>(' '));
+    ASSERT_EQUAL(display.cell(2, 11), 't'|Screen::UNDERLINE);
+    ASSERT_EQUAL(display.cell(3, 6), static_cast<Screen::Cell>(' '));
+    ASSERT_EQUAL(display.cell(3, 7), 't'|Screen::UNDERLINE);
+}
+
+TEST(test_exit_ends_interaction) {
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor("", FemtoEditor::TERMINAL, display);
+    display.press(24);              // ^X
+    display.type("more keys");
+    editor.interact();
+    ASSERT_EQUAL(display.keys_left(), 9);
+}
+
+TEST(test_load_normalizes_line_endings) {
+    const string filename = scratch_file("load");
+    std::ofstream(filename, std::ios::binary) << "a\r\nb\rc\r\r\nd\r";
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor(filename, FemtoEditor::TERMINAL, display);
+    std::remove(filename.c_str());
+    display.press(KEY_DOWN);
+    editor.interact();
+    ASSERT_EQUAL(display.row(2).substr(0, 2), "a ");
+    ASSERT_EQUAL(display.row(3).substr(0, 2), "b ");
+    ASSERT_EQUAL(display.row(4).substr(0, 2), "c ");
+    ASSERT_EQUAL(display.row(5).substr(0, 2), "  ");
+    ASSERT_EQUAL(display.row(6).substr(0, 2), "d ");
+    ASSERT_EQUAL(display.row(7).substr(0, 2), "  ");
+    ASSERT_EQUAL(display.cell(3, 0), 'b'|Screen::STANDOUT); // the cursor
+}
+
+TEST(test_refuse_file_too_large_to_edit) {
+    const string filename = scratch_file("large");
+    std::ofstream(filename, std::ios::binary) << "x";
+    // sparse, so it takes no space on disk
+    ASSERT_EQUAL(::truncate(filename.c_str(), 1L << 31), 0);
+    {
+        HeadlessDisplay display(HEIGHT, WIDTH);
+        FemtoEditor editor(filename, FemtoEditor::TERMINAL, display);
+        display.type("y");
+        display.press(19);          // ^S, which asks for a name
+        editor.interact();
+        ASSERT_TRUE(display.row(8).find("too large") != string::npos);
+        ASSERT_TRUE(display.row(0).find("<new file>") != string::npos);
+        ASSERT_EQUAL(display.row(9).find(filename), string::npos);
+    }
+    struct stat info;
+    ASSERT_EQUAL(::stat(filename.c_str(), &info), 0);
+    ASSERT_EQUAL(info.st_size, 1L << 31); // left alone
+    std::remove(filename.c_str());
+}
+
+TEST(test_edit_large_file_in_place) {
+    const string filename = scratch_file("mapped");
+    std::ofstream(filename, std::ios::binary) << "one\ntwo\n";
+    ASSERT_FALSE(FemtoEditor::is_large_file(filename));
+    // sparse: a third row of NULs takes it to LARGE_FILE
+    ASSERT_EQUAL(::truncate(filename.c_str(), FemtoEditor::LARGE_FILE), 0);
+    ASSERT_TRUE(FemtoEditor::is_large_file(filename));
+    {
+        HeadlessDisplay display(HEIGHT, WIDTH);
+        BasicFemtoEditor<BasicTextBuffer<PieceTable<char>>>
+            editor(filename, FemtoEditor::TERMINAL, display);
+        display.press(KEY_DOWN);
+        display.type("2");
+        editor.interact();
+        ASSERT_EQUAL(display.row(2).substr(0, 4), "one ");
+        ASSERT_EQUAL(display.row(3).substr(0, 5), "2two ");
+    }
+    std::remove(filename.c_str());
+}
+
+TEST(test_save_over_loaded_file) {
+    const string filename = scratch_file("save");
+    std::ofstream(filename, std::ios::binary) << "one\ntwo\n";
+    {
+        HeadlessDisplay display(HEIGHT, WIDTH);
+        FemtoEditor editor(filename, FemtoEditor::TERMINAL, display);
+        display.press(KEY_DOWN);
+        display.type("2");
+        display.press(19);          // ^S, keeping the file name
+        display.type("\n");
+        display.press(KEY_DOWN);
+        display.type("3");
+        display.press(19);          // and again
+        display.type("\n");
+        editor.interact();
+        ASSERT_EQUAL(display.row(2).substr(0, 4), "one ");
+        ASSERT_EQUAL(display.row(3).substr(0, 5), "2two ");
+        ASSERT_EQUAL(display.row(4).substr(0, 2), "3 ");
+    }
+    std::ifstream input(filename, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(input)),
+                         std::istreambuf_iterator<char>());
+    ASSERT_EQUAL(contents, "one\n2two\n3");
+    std::remove(filename.c_str());
+}
+
+// EFFECTS: Returns the contents of the file at path, or "<none>" if
+//          there is no such file.
+static string contents_of(const string &path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return "<none>";
+    }
+    return string((std::istreambuf_iterator<char>(input)),
+                  std::istreambuf_iterator<char>());
+}
+
+TEST(test_autosave_writes_swap_file) {
+    const string filename = scratch_file("autosave");
+    const string swap = swap_file(filename);
+    std::ofstream(filename, std::ios::binary) << "one\n";
+    {
+        HeadlessDisplay display(HEIGHT, WIDTH);
+        FemtoEditor editor(filename, FemtoEditor::TERMINAL, display);
+        editor.set_autosave_interval(0);
+        editor.interact();
+        editor.wait_for_autosave();
+        ASSERT_EQUAL(contents_of(swap), "<none>"); // nothing changed yet
+        display.type("1");
+        editor.interact();
+        editor.wait_for_autosave();
+        ASSERT_EQUAL(contents_of(swap), "1one\n");
+        ASSERT_EQUAL(contents_of(filename), "one\n");
+        display.press(19);          // ^S, keeping the file name
+        display.type("\n");
+        editor.interact();
+        editor.wait_for_autosave();
+        ASSERT_EQUAL(contents_of(swap), "<none>");
+        display.type("2");
+        editor.interact();
+        editor.wait_for_autosave();
+        ASSERT_EQUAL(contents_of(swap), "12one\n");
+    }
+    ASSERT_EQUAL(contents_of(swap), "<none>"); // removed on the way out
+    ASSERT_EQUAL(contents_of(filename), "1one\n");
+    std::remove(filename.c_str());
+}
+
+TEST(test_swap_file_is_as_private_as_the_file) {
+    const string filename = scratch_file("private");
+    const string swap = swap_file(filename);
+    std::ofstream(filename, std::ios::binary) << "secret\n";
+    ::chmod(filename.c_str(), 0600);
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor(filename, FemtoEditor::TERMINAL, display);
+    editor.set_autosave_interval(0);
+    display.type("1");
+    editor.interact();
+    editor.wait_for_autosave();
+    struct stat info;
+    ASSERT_EQUAL(::stat(swap.c_str(), &info), 0);
+    ASSERT_EQUAL(info.st_mode & 0777, 0600u);
+    std::remove(filename.c_str());
+}
+
+TEST(test_recover_from_swap_file) {
+    const string filename = scratch_file("recover");
+    const string swap = swap_file(filename);
+    std::ofstream(filename, std::ios::binary) << "old\n";
+    std::ofstream(swap, std::ios::binary) << "new\n";
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor(filename, FemtoEditor::TERMINAL, display);
+    display.type("xy");             // x is rejected
+    editor.interact();
+    ASSERT_EQUAL(display.beeps(), 1);
+    ASSERT_EQUAL(display.row(2).substr(0, 4), "new ");
+    ASSERT_EQUAL(display.cell(2, 0), 'n'|Screen::STANDOUT); // the cursor
+    ASSERT_TRUE(display.row(0).find("**") != string::npos); // modified
+    ASSERT_TRUE(display.row(8).find("Recovered") != string::npos);
+    ASSERT_EQUAL(contents_of(filename), "old\n");
+    std::remove(filename.c_str());
+    std::remove(swap.c_str());
+}
+
+TEST(test_decline_recovery) {
+    const string filename = scratch_file("decline");
+    const string swap = swap_file(filename);
+    std::ofstream(filename, std::ios::binary) << "old\n";
+    std::ofstream(swap, std::ios::binary) << "new\n";
+    HeadlessDisplay display(HEIGHT, WIDTH);
+    FemtoEditor editor(filename, FemtoEditor::TERMINAL, display);
+    display.type("n");
+    editor.interact();
+    editor.wait_for_autosave();
+    ASSERT_EQUAL(display.row(2).substr(0, 4), "old ");
+    ASSERT_TRUE(display.row(0).find("**") == string::npos);
+    ASSERT_EQUAL(contents_of(swap), "<none>");
+    std::remove(filename.c_str());
+}
+
+TEST_MAIN()
@@ -0,0 +1,165 @@
+/* FileWriter.cpp
+ *
+ * Saves a file from blocks of text with writev(), through a temporary
+ * file that is synced and renamed over the target.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "FileWriter.hpp"
+
+//EFFECTS: Starts saving to path, through a temporary file next to the
+//         file path names.
+FileWriter::FileWriter(const std::string &path)
+  : FileWriter(path, nullptr) {}
+
+//EFFECTS: Starts saving to path, with the permissions in mode.
+FileWriter::FileWriter(const std::string &path, mode_t mode)
+  : FileWriter(path, &mode) {}
+
+// Starts saving to path, with the permissions in *mode if mode is not
+// null.
+FileWriter::FileWriter(const std::string &path, const mode_t *mode)
+  : fd(-1), failed(false),
+    buffer(static_cast<char *>(std::aligned_alloc(ALIGNMENT, BUFFER_SIZE)),
+           &std::free),
+    buffered(0), size(0), started(0) {
+  // replace what a symbolic link points to, not the link
+  char *resolved = ::realpath(path.c_str(), nullptr);
+  target = resolved ? resolved : path;
+  std::free(resolved);
+  temp = target + ".femto-XXXXXX";
+  fd = ::mkstemp(&temp[0]);
+  if (fd < 0 || !buffer) {
+    failed = true;
+    return;
+  }
+  // mkstemp() makes the file private; give it the permissions asked
+  // for, or else the target's
+  struct stat info;
+  mode_t permissions;
+  if (mode) {
+    permissions = *mode;
+  } else if (::stat(target.c_str(), &info) == 0) {
+    permissions = info.st_mode & 07777;
+  } else {
+    mode_t mask = ::umask(0);
+    ::umask(mask);
+    permissions = 0666 & ~mask;
+  }
+  ::fchmod(fd, permissions);
+}
+
+//EFFECTS: Abandons the save, unless close() was called.
+FileWriter::~FileWriter() {
+  if (fd >= 0) {
+    ::close(fd);
+    ::unlink(temp.c_str());
+  }
+}
+
+//MODIFIES: *this, the file system
+//EFFECTS: Appends block to the file. Returns false if anything failed.
+bool FileWriter::write(std::string_view block) {
+  if (failed) {
+    return false;
+  }
+  if (block.size() >= LARGE_BLOCK) {
+    return flush(block);
+  }
+  if (buffered + block.size() > BUFFER_SIZE && !flush()) {
+    return false;
+  }
+  std::memcpy(buffer.get() + buffered, block.data(), block.size());
+  buffered += block.size();
+  return true;
+}
+
+//MODIFIES: *this, the file system
+//EFFECTS: Writes what is left and, if all of it is on disk, replaces
+//         the target with the new file. Returns whether it did.
+bool FileWriter::close() {
+  if (fd < 0) {
+    return false;
+  }
+  flush();
+  // one sync for the whole file, before the rename makes it the target
+  if (!failed && ::fsync(fd) != 0) {
+    failed = true;
+  }
+  if (::close(fd) != 0) {
+    failed = true;
+  }
+  fd = -1;
+  if (!failed && ::rename(temp.c_str(), target.c_str()) != 0) {
+    failed = true;
+  }
+  if (failed) {
+    ::unlink(temp.c_str());
+    return false;
+  }
+  sync_directory();
+  return true;
+}
+
+// Writes the buffer, then block, with as few system calls as it takes.
+bool FileWriter::flush(std::string_view block) {
+  iovec parts[2] = {{buffer.get(), buffered},
+                    {const_cast<char *>(block.data()), block.size()}};
+  iovec *part = parts;
+  int count = 2;
+  while (!failed && count > 0) {
+    if (part->iov_len == 0) {
+      ++part;
+      --count;
+      continue;
+    }
+    ssize_t written = ::writev(fd, part, count);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    } else if (written < 0) {
+      failed = true;
+      break;
+    }
+    size += written;
+    // skip what was written, which may end in the middle of a part
+    for (std::size_t left = written; left > 0;) {
+      std::size_t step = std::min(left, part->iov_len);
+      part->iov_base = static_cast<char *>(part->iov_base) + step;
+      part->iov_len -= step;
+      left -= step;
+      if (part->iov_len == 0) {
+        ++part;
+        --count;
+      }
+    }
+  }
+  buffered = 0;
+#ifdef SYNC_FILE_RANGE_WRITE
+  if (!failed && size - started >= SYNC_BATCH) {
+    // start writing this batch to disk now, so that it overlaps with
+    // producing the next one and close() has little left to sync
+    ::sync_file_range(fd, started, size - started, SYNC_FILE_RANGE_WRITE);
+    started = size;
+  }
+#endif
+  return !failed;
+}
+
+// Syncs the target's directory, so the rename survives a crash.
+void FileWriter::sync_directory() const {
+  std::size_t slash = target.rfind('/');
+  std::string directory = slash == std::string::npos ? "."
+                        : slash == 0 ? "/" : target.substr(0, slash);
+  int dir = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dir >= 0) {
+    ::fsync(dir); // the new contents are already safe either way
+    ::close(dir);
+  }
+}
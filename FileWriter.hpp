@@ -0,0 +1,98 @@
+#ifndef FILEWRITER_HPP
+#define FILEWRITER_HPP
+/* FileWriter.hpp
+ *
+ * Saves a file from a sequence of blocks of text, such as the chunks of
+ * a text buffer, without first copying them into one string: large
+ * blocks go to the file straight from where they are, and small ones
+ * are gathered into one buffer so each system call writes a lot. The
+ * blocks go to a new file that only replaces the old one once all of
+ * it is safely on disk, so a crash in the middle of a save leaves the
+ * old file as it was.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+
+class FileWriter {
+  //OVERVIEW: A file being saved. Blocks are written with write()/
+  //          writev() to a temporary file in the same directory as the
+  //          target. close() syncs it to disk once, renames it over the
+  //          target (which readers then see replaced all at once), and
+  //          syncs the directory. Writing to disk is started in batches
+  //          along the way, so the final sync has little left to do. A
+  //          writer that is never closed removes its temporary file and
+  //          leaves the target alone.
+  //
+  //          A block at least LARGE_BLOCK long is written before write()
+  //          returns, together with whatever smaller blocks were
+  //          gathered before it, in a single writev(), so blocks only
+  //          need to stay valid during the call. Once something fails,
+  //          the writer stays failed.
+public:
+  // Blocks at least this long are written in place, not copied.
+  static const std::size_t LARGE_BLOCK = 64 * 1024;
+  // Size of the buffer that gathers smaller blocks; it is aligned to
+  // ALIGNMENT, and so is every write of a full buffer.
+  static const std::size_t BUFFER_SIZE = 1024 * 1024;
+  static const std::size_t ALIGNMENT = 4096;
+  // Where the system allows, writing to disk is started every time this
+  // much more has been written, instead of all of it waiting for close().
+  static const std::size_t SYNC_BATCH = 8 * 1024 * 1024;
+
+  //EFFECTS: Starts saving to path. If path is a symbolic link, the file
+  //         it points to is replaced. An existing file's permissions are
+  //         kept; a new file gets the usual ones for the umask.
+  explicit FileWriter(const std::string &path);
+
+  //EFFECTS: Starts saving to path like FileWriter(path), but the file
+  //         gets the permissions in mode, whatever it had before.
+  FileWriter(const std::string &path, mode_t mode);
+
+  //EFFECTS: Abandons the save, unless close() was called: the temporary
+  //         file is removed and the target is not touched.
+  ~FileWriter();
+
+  // disable copying
+  FileWriter(const FileWriter&) = delete;
+  FileWriter& operator=(const FileWriter&) = delete;
+
+  //MODIFIES: *this, the file system
+  //EFFECTS: Appends block to the file. Returns false if the file could
+  //         not be created or a write failed, now or before.
+  bool write(std::string_view block);
+
+  //MODIFIES: *this, the file system
+  //EFFECTS: Writes what is left and, if every block was written and
+  //         synced to disk, replaces the target with the new file.
+  //         Returns whether the target was replaced. Otherwise the
+  //         temporary file is removed.
+  bool close();
+
+private:
+  std::string target;                 // file being replaced
+  std::string temp;                   // file being written
+  int fd;                             // temp, or -1 once closed
+  bool failed;                        // whether anything went wrong
+  std::unique_ptr<char[], decltype(&std::free)> buffer; // small blocks
+  std::size_t buffered;               // bytes in buffer
+  std::size_t size;                   // bytes written to temp so far
+  std::size_t started;                // bytes of temp sent to the disk
+
+  // Starts saving to path, with the permissions in *mode if mode is not
+  // null.
+  FileWriter(const std::string &path, const mode_t *mode);
+
+  // Writes the buffer, then block, with as few system calls as it
+  // takes. Returns whether all of it was written.
+  bool flush(std::string_view block = std::string_view());
+
+  // Syncs the target's directory, so the rename survives a crash.
+  void sync_directory() const;
+};
+
+#endif // FILEWRITER_HPP
@@ -0,0 +1,82 @@
+/* FileWriter_bench.cpp
+ *
+ * What crash-safe saving costs: saves a file of the given size the way
+ * write_file used to (std::ofstream, truncating the file in place, never
+ * syncing it) and with FileWriter (a temporary file that is synced and
+ * renamed over the old one). Each is fed the text in large blocks (as a
+ * gap buffer or piece table hands it out) and in 4 KB blocks (as a rope
+ * does).
+ *
+ * Usage: ./FileWriter_bench.exe [megabytes] [directory]
+ *        (default 256 MB in the current directory; syncing is only
+ *        measured on a real disk, not on tmpfs)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "FileWriter.hpp"
+
+using namespace std;
+
+// EFFECTS: Returns the median time in seconds of three runs of save.
+static double median_time(const function<void()> &save) {
+  vector<double> times;
+  for (int i = 0; i < 3; ++i) {
+    auto start = chrono::steady_clock::now();
+    save();
+    times.push_back(chrono::duration<double>(chrono::steady_clock::now()
+                                             - start).count());
+  }
+  sort(times.begin(), times.end());
+  return times[1];
+}
+
+// EFFECTS: Calls write with text in blocks of block_size.
+static void in_blocks(const string &text, size_t block_size,
+                      const function<void(string_view)> &write) {
+  for (size_t at = 0; at < text.size(); at += block_size) {
+    write(string_view(text).substr(at, block_size));
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 256;
+  string directory = argc > 2 ? argv[2] : ".";
+  string path = directory + "/FileWriter_bench.tmp";
+  string text(megabytes << 20, 'x');
+  for (size_t i = 80; i < text.size(); i += 81) {
+    text[i] = '\n';
+  }
+  printf("save benchmark, %zu MB to %s\n", megabytes, path.c_str());
+  for (size_t block_size : {size_t(64) << 20, size_t(4096)}) {
+    double in_place = median_time([&]() {
+      ofstream output(path);
+      in_blocks(text, block_size, [&output](string_view block) {
+        output.write(block.data(), block.size());
+      });
+    });
+    double atomic = median_time([&]() {
+      FileWriter output(path);
+      in_blocks(text, block_size, [&output](string_view block) {
+        output.write(block);
+      });
+      if (!output.close()) {
+        perror("save");
+        exit(1);
+      }
+    });
+    printf("  %8zu-byte blocks: ofstream in place %6.3f s (%5.0f MB/s)"
+           "  FileWriter synced %6.3f s (%5.0f MB/s)  %+.0f%%\n",
+           block_size, in_place, megabytes / in_place, atomic,
+           megabytes / atomic, (atomic / in_place - 1) * 100);
+    fflush(stdout);
+  }
+  remove(path.c_str());
+}
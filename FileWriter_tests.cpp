@@ -0,0 +1,139 @@
+#include "FileWriter.hpp"
+#include "unit_test_framework.hpp"
+
+#include <csignal>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// EFFECTS: returns the contents of the file at path
+static string contents_of(const string &path) {
+    ifstream input(path, ios::binary);
+    return string(istreambuf_iterator<char>(input),
+                  istreambuf_iterator<char>());
+}
+
+// EFFECTS: returns the number of temporary files left behind by saves
+//          of the file at path, removing them
+static int remove_leftovers(const string &path) {
+    int count = 0;
+    DIR *dir = opendir(".");
+    while (dirent *entry = readdir(dir)) {
+        string name = entry->d_name;
+        if (name.rfind(path + ".femto-", 0) == 0) {
+            remove(name.c_str());
+            ++count;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+TEST(test_small_and_large_blocks) {
+    const string path = "FileWriter_tests-a.tmp";
+    string large(FileWriter::LARGE_BLOCK + 3, 'L');
+    string filler(FileWriter::BUFFER_SIZE - 10, 'f');
+    string expected;
+    {
+        FileWriter output(path);
+        for (const string &block : {string("ab"), large, string("c"),
+                                    filler, string(20, 'x'), string(),
+                                    large, string("end")}) {
+            ASSERT_TRUE(output.write(block));
+            expected += block;
+        }
+        ASSERT_TRUE(output.close());
+    }
+    ASSERT_TRUE(contents_of(path) == expected);
+    remove(path.c_str());
+}
+
+TEST(test_truncates_existing_file) {
+    const string path = "FileWriter_tests-b.tmp";
+    ofstream(path) << "old contents that are longer";
+    FileWriter output(path);
+    ASSERT_TRUE(output.write("new"));
+    ASSERT_TRUE(output.close());
+    ASSERT_EQUAL(contents_of(path), "new");
+    remove(path.c_str());
+}
+
+TEST(test_abandoned_save_keeps_original) {
+    const string path = "FileWriter_tests-c.tmp";
+    ofstream(path) << "original";
+    {
+        FileWriter output(path);
+        ASSERT_TRUE(output.write(string(3 * FileWriter::BUFFER_SIZE, 'x')));
+        ASSERT_EQUAL(contents_of(path), "original");
+    }                               // never closed
+    ASSERT_EQUAL(contents_of(path), "original");
+    ASSERT_EQUAL(remove_leftovers(path), 0);
+    remove(path.c_str());
+}
+
+TEST(test_killed_writer_keeps_original) {
+    const string path = "FileWriter_tests-d.tmp";
+    const string original(FileWriter::BUFFER_SIZE + 5, 'o');
+    ofstream(path) << original;
+    pid_t child = fork();
+    if (child == 0) {
+        FileWriter output(path);
+        output.write(string(FileWriter::LARGE_BLOCK, 'n'));
+        output.write("gathered but never written");
+        raise(SIGKILL);             // dies in the middle of the save
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    ASSERT_TRUE(WIFSIGNALED(status));
+    ASSERT_TRUE(contents_of(path) == original);
+    ASSERT_EQUAL(remove_leftovers(path), 1);
+    remove(path.c_str());
+}
+
+TEST(test_keeps_permissions_and_links) {
+    const string path = "FileWriter_tests-e.tmp";
+    const string link = "FileWriter_tests-f.tmp";
+    ofstream(path) << "old";
+    chmod(path.c_str(), 0640);
+    symlink(path.c_str(), link.c_str());
+    FileWriter output(link);
+    ASSERT_TRUE(output.write("new"));
+    ASSERT_TRUE(output.close());
+    struct stat info;
+    ASSERT_EQUAL(lstat(link.c_str(), &info), 0);
+    ASSERT_TRUE(S_ISLNK(info.st_mode));   // still a link, to the new file
+    ASSERT_EQUAL(stat(path.c_str(), &info), 0);
+    ASSERT_EQUAL(info.st_mode & 0777, 0640u);
+    ASSERT_EQUAL(contents_of(path), "new");
+    remove(link.c_str());
+    remove(path.c_str());
+}
+
+TEST(test_given_permissions) {
+    const string path = "FileWriter_tests-g.tmp";
+    ofstream(path) << "old";
+    chmod(path.c_str(), 0644);
+    FileWriter output(path, 0600);
+    ASSERT_TRUE(output.write("new"));
+    ASSERT_TRUE(output.close());
+    struct stat info;
+    ASSERT_EQUAL(stat(path.c_str(), &info), 0);
+    ASSERT_EQUAL(info.st_mode & 0777, 0600u);
+    remove(path.c_str());
+}
+
+TEST(test_failure_is_sticky) {
+    FileWriter output("FileWriter_tests-missing/x.tmp"); // no such directory
+    ASSERT_FALSE(output.write("a"));
+    ASSERT_FALSE(output.write(string(FileWriter::LARGE_BLOCK, 'a')));
+    ASSERT_FALSE(output.close());
+}
+
+TEST_MAIN()
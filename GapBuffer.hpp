@@ -0,0 +1,429 @@
+#ifndef GAPBUFFER_HPP
+#define GAPBUFFER_HPP
+/* GapBuffer.hpp
+ *
+ * gap buffer with the same interface as List
+ * EECS 280 Project 4
+ */
+
+#include <algorithm>   //std::copy, std::min
+#include <iterator>    //std::bidirectional_iterator_tag, std::distance
+#include <cassert>     //assert
+#include <cstddef>     //std::size_t
+#include <cstring>     //std::memmove, std::memcpy
+#include <memory>      //std::shared_ptr
+#include <string>      //std::basic_string
+#include <string_view> //std::basic_string_view
+#include <type_traits> //std::is_trivially_copyable
+#include <vector>
+
+
+template <typename T, int BlockSize = 64 * 1024>
+class GapBuffer {
+  //OVERVIEW: an array with a movable "gap" of unused slots, with the
+  //          same interface as List. Insertions and erasures happen at
+  //          the gap, which is moved to the edit position first, so a
+  //          burst of edits at one place costs O(1) each and moving the
+  //          gap costs O(distance). Elements are addressed by index, so
+  //          Iterators stay valid across edits (they keep referring to
+  //          the same index, not element). The array is kept in blocks
+  //          of BlockSize elements, and a buffer copies a block before
+  //          it writes to one that a copy also holds, so copies share
+  //          the blocks: copying only takes O(blocks), and a copy can be
+  //          read on one thread while the buffer is edited on another.
+  //          Growing the gap adds blocks at the gap rather than moving
+  //          the elements after it.
+  //NOTE:     Elements are moved with memmove, so T must be trivially
+  //          copyable. Writing an element through an Iterator also
+  //          writes it in every copy that shares its block; use
+  //          operator[], front() or back() instead.
+  static_assert(std::is_trivially_copyable<T>::value,
+                "GapBuffer requires a trivially copyable element type");
+  static_assert(BlockSize >= 1, "blocks must hold at least 1 element");
+
+public:
+  // default ctor
+  GapBuffer() : gap_begin(0), gap_end(0) {}
+
+  //EFFECTS:  returns true if the buffer is empty
+  bool empty() const {
+    return size() == 0;
+  }
+
+  //EFFECTS: returns the number of elements in this buffer
+  int size() const {
+    return static_cast<int>(capacity() - (gap_end - gap_begin));
+  }
+
+  //REQUIRES: 0 <= i < size()
+  //EFFECTS: returns the element at index i by reference, copying its
+  //         block first if a copy of this buffer also holds it
+  T & operator[](int i) {
+    assert(0 <= i && i < size());
+    std::size_t p = physical(static_cast<std::size_t>(i));
+    return writable(p / BLOCK)[p % BLOCK];
+  }
+
+  //REQUIRES: 0 <= i < size()
+  //EFFECTS: returns the element at index i
+  const T & operator[](int i) const {
+    assert(0 <= i && i < size());
+    std::size_t p = physical(static_cast<std::size_t>(i));
+    return blocks[p / BLOCK][p % BLOCK];
+  }
+
+  //REQUIRES: buffer is not empty
+  //EFFECTS: Returns the first element in the buffer by reference
+  T & front() {
+    return (*this)[0];
+  }
+
+  //REQUIRES: buffer is not empty
+  //EFFECTS: Returns the last element in the buffer by reference
+  T & back() {
+    return (*this)[size() - 1];
+  }
+
+  //EFFECTS:  inserts datum into the front of the buffer
+  void push_front(const T &datum) {
+    insert(begin(), datum);
+  }
+
+  //EFFECTS:  inserts datum into the back of the buffer
+  void push_back(const T &datum) {
+    insert(end(), datum);
+  }
+
+  //REQUIRES: buffer is not empty
+  //EFFECTS:  removes the item at the front of the buffer
+  void pop_front() {
+    assert(!empty());
+    erase(begin());
+  }
+
+  //REQUIRES: buffer is not empty
+  //EFFECTS:  removes the item at the back of the buffer
+  void pop_back() {
+    assert(!empty());
+    erase(Iterator(this, size() - 1));
+  }
+
+  //EFFECTS:  removes all items from the buffer, keeping its capacity
+  void clear() {
+    gap_begin = 0;
+    gap_end = capacity();
+  }
+
+  //EFFECTS: replaces the contents with text, leaving the gap at the end
+  void assign(std::basic_string_view<T> text) {
+    blocks.clear();
+    for (std::size_t at = 0; at < text.size(); at += BLOCK) {
+      blocks.emplace_back(new T[BLOCK]);
+      std::memcpy(blocks.back().get(), text.data() + at,
+                  std::min(BLOCK, text.size() - at) * sizeof(T));
+    }
+    gap_begin = text.size();
+    gap_end = capacity();
+  }
+
+  //EFFECTS: makes room for at least n elements in total
+  void reserve(int n) {
+    if (n > size()) {
+      grow(static_cast<std::size_t>(n - size()));
+    }
+  }
+
+  //EFFECTS: copies the contents into a contiguous string with one
+  //         block copy per block of storage on either side of the gap
+  std::basic_string<T> str() const {
+    std::basic_string<T> result;
+    result.reserve(size());
+    for_each_chunk(0, size(), [&result](const T *items, int count) {
+      result.append(items, count);
+      return true;
+    });
+    return result;
+  }
+
+  //REQUIRES: 0 <= begin <= end <= size()
+  //EFFECTS: calls visit(pointer, count) with the elements in [begin, end)
+  //         in place, one block per block of storage on either side of
+  //         the gap. visit returns whether to go on to the next block.
+  template <typename Visitor>
+  void for_each_chunk(int begin, int end, Visitor visit) const {
+    assert(0 <= begin && begin <= end && end <= size());
+    std::size_t first = static_cast<std::size_t>(begin);
+    std::size_t last = static_cast<std::size_t>(end);
+    while (first < last) {
+      std::size_t stop = first < gap_begin ? std::min(last, gap_begin) : last;
+      std::size_t p = physical(first);
+      std::size_t count = std::min(stop - first, BLOCK - p % BLOCK);
+      if (!visit(blocks[p / BLOCK].get() + p % BLOCK,
+                 static_cast<int>(count))) {
+        return;
+      }
+      first += count;
+    }
+  }
+
+  ////////////////////////////////////////
+  class Iterator {
+    //OVERVIEW: Iterator interface to GapBuffer
+  public:
+    Iterator() : buffer_ptr(nullptr), index(0) {}
+
+    T & operator*() const {
+      assert(buffer_ptr != nullptr);
+      return const_cast<T &>((*buffer_ptr)[index]);
+    }
+
+    T * operator->() const {
+      return &operator*();
+    }
+
+    Iterator & operator++() {
+      assert(buffer_ptr);
+      assert(index < buffer_ptr->size());
+      ++index;
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      operator++();
+      return copy;
+    }
+
+    Iterator & operator--() {
+      assert(buffer_ptr);
+      assert(index > 0);
+      --index;
+      return *this;
+    }
+
+    Iterator operator--(int) {
+      Iterator copy = *this;
+      operator--();
+      return copy;
+    }
+
+    bool operator==(const Iterator &rhs) const {
+      return buffer_ptr == rhs.buffer_ptr && index == rhs.index;
+    }
+
+    bool operator!=(const Iterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+    // Type aliases required to work with STL algorithms.
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+  private:
+    const GapBuffer *buffer_ptr;
+    int index;          // logical index; size() for the end position
+
+    friend class GapBuffer;
+
+    Iterator(const GapBuffer *bp, int i) : buffer_ptr(bp), index(i) {}
+  };//GapBuffer::Iterator
+  ////////////////////////////////////////
+
+  // return an Iterator pointing to the first element
+  Iterator begin() const {
+    return Iterator(this, 0);
+  }
+
+  // return an Iterator pointing to "past the end"
+  Iterator end() const {
+    return Iterator(this, size());
+  }
+
+  //REQUIRES: 0 <= index <= size()
+  //EFFECTS: returns an Iterator to the element at index in O(1)
+  Iterator at(int index) const {
+    assert(0 <= index && index <= size());
+    return Iterator(this, index);
+  }
+
+  //REQUIRES: i is a valid, dereferenceable iterator associated with this
+  //          buffer
+  //EFFECTS: Removes a single element from the buffer.
+  //         Returns An iterator pointing to the element that followed the
+  //         element erased by the function call
+  Iterator erase(Iterator i) {
+    assert(i.buffer_ptr == this);
+    assert(i.index < size());
+    move_gap(static_cast<std::size_t>(i.index));
+    ++gap_end;    // the element after the gap joins the gap
+    return i;
+  }
+
+  //REQUIRES: i is a valid iterator associated with this buffer
+  //EFFECTS: Inserts datum before the element at the specified position.
+  //         Returns an iterator to the the newly inserted element.
+  Iterator insert(Iterator i, const T &datum) {
+    assert(i.buffer_ptr == this);
+    if (gap_begin == gap_end) {
+      grow(1);
+    }
+    move_gap(static_cast<std::size_t>(i.index));
+    writable(gap_begin / BLOCK)[gap_begin % BLOCK] = datum;
+    ++gap_begin;
+    return i;
+  }
+
+  //REQUIRES: i is a valid iterator associated with this buffer
+  //EFFECTS: Inserts copies of the elements in [range_begin, range_end)
+  //         before the element at the specified position, moving the gap
+  //         there and growing it at most once, then copying the elements
+  //         into it a block at a time. Returns an iterator to the first
+  //         inserted element.
+  template <typename ForwardIterator>
+  Iterator insert(Iterator i, ForwardIterator range_begin,
+                  ForwardIterator range_end) {
+    assert(i.buffer_ptr == this);
+    std::size_t n = static_cast<std::size_t>(
+      std::distance(range_begin, range_end));
+    if (gap_end - gap_begin < n) {
+      grow(n);
+    }
+    move_gap(static_cast<std::size_t>(i.index));
+    while (n > 0) {
+      std::size_t count = std::min(n, BLOCK - gap_begin % BLOCK);
+      ForwardIterator next = std::next(range_begin, count);
+      std::copy(range_begin, next,
+                writable(gap_begin / BLOCK) + gap_begin % BLOCK);
+      range_begin = next;
+      gap_begin += count;
+      n -= count;
+    }
+    return i;
+  }
+
+  //REQUIRES: [range_begin, range_end) is a valid range of iterators
+  //          associated with this buffer
+  //EFFECTS: Removes the elements in [range_begin, range_end) by moving
+  //         the gap to them and widening it. Returns an iterator to the
+  //         element that followed the last one erased.
+  Iterator erase(Iterator range_begin, Iterator range_end) {
+    assert(range_begin.buffer_ptr == this && range_end.buffer_ptr == this);
+    assert(range_begin.index <= range_end.index);
+    move_gap(static_cast<std::size_t>(range_begin.index));
+    gap_end += static_cast<std::size_t>(range_end.index - range_begin.index);
+    return range_begin;
+  }
+
+private:
+  static constexpr std::size_t BLOCK = BlockSize;
+
+  std::vector<std::shared_ptr<T[]>> blocks; // storage, BLOCK elements
+                                            // each, with the gap
+                                            // somewhere inside
+  std::size_t gap_begin;   // first unused slot
+  std::size_t gap_end;     // one past the last unused slot
+
+  // INVARIANT: 0 <= gap_begin <= gap_end <= capacity(), and the elements
+  //            are storage[0, gap_begin) then storage[gap_end,
+  //            capacity()), where storage[p] is
+  //            blocks[p / BLOCK][p % BLOCK].
+
+  //EFFECTS: returns the number of slots in storage
+  std::size_t capacity() const {
+    return blocks.size() * BLOCK;
+  }
+
+  //EFFECTS: returns the position in storage of logical index i
+  std::size_t physical(std::size_t i) const {
+    return i < gap_begin ? i : i + (gap_end - gap_begin);
+  }
+
+  //EFFECTS: returns block b of storage, copying it first if a copy of
+  //         this buffer also holds it
+  T * writable(std::size_t b) {
+    if (blocks[b].use_count() > 1) {
+      std::shared_ptr<T[]> copy(new T[BLOCK]);
+      std::memcpy(copy.get(), blocks[b].get(), BLOCK * sizeof(T));
+      blocks[b] = std::move(copy);
+    }
+    return blocks[b].get();
+  }
+
+  //REQUIRES: to != from, both ranges lie within storage
+  //EFFECTS: moves count elements from position from of storage to
+  //         position to, one block-sized piece at a time, starting from
+  //         the end the ranges do not overlap at
+  void move_elements(std::size_t to, std::size_t from, std::size_t count) {
+    while (count > 0) {
+      if (to < from) {
+        std::size_t n = std::min({count, BLOCK - to % BLOCK,
+                                  BLOCK - from % BLOCK});
+        T *target = writable(to / BLOCK) + to % BLOCK;
+        std::memmove(target, blocks[from / BLOCK].get() + from % BLOCK,
+                     n * sizeof(T));
+        to += n;
+        from += n;
+        count -= n;
+      } else {
+        std::size_t to_end = to + count;
+        std::size_t from_end = from + count;
+        std::size_t n = std::min({count, (to_end - 1) % BLOCK + 1,
+                                  (from_end - 1) % BLOCK + 1});
+        T *target = writable((to_end - n) / BLOCK) + (to_end - n) % BLOCK;
+        std::memmove(target,
+                     blocks[(from_end - n) / BLOCK].get() + (from_end - n)
+                                                            % BLOCK,
+                     n * sizeof(T));
+        count -= n;
+      }
+    }
+  }
+
+  //EFFECTS: moves the gap so that it starts at logical index pos
+  void move_gap(std::size_t pos) {
+    if (pos < gap_begin) {
+      std::size_t count = gap_begin - pos;
+      move_elements(gap_end - count, pos, count);
+      gap_begin -= count;
+      gap_end -= count;
+    } else if (pos > gap_begin) {
+      std::size_t count = pos - gap_begin;
+      move_elements(gap_begin, gap_end, count);
+      gap_begin += count;
+      gap_end += count;
+    }
+  }
+
+  //EFFECTS: enlarges the gap to hold at least n elements by adding
+  //         fresh blocks at the first block boundary in or after it;
+  //         the elements between the gap and that boundary, fewer than
+  //         BLOCK, move to the end of the last fresh block
+  void grow(std::size_t n) {
+    if (gap_end - gap_begin >= n) {
+      return;
+    }
+    std::size_t added = (n - (gap_end - gap_begin) + BLOCK - 1) / BLOCK;
+    std::size_t boundary = (gap_begin + BLOCK - 1) / BLOCK;
+    std::vector<std::shared_ptr<T[]>> fresh;
+    for (std::size_t b = 0; b < added; ++b) {
+      fresh.emplace_back(new T[BLOCK]);
+    }
+    blocks.insert(blocks.begin() + boundary,
+                  std::make_move_iterator(fresh.begin()),
+                  std::make_move_iterator(fresh.end()));
+    if (gap_end >= boundary * BLOCK) {
+      gap_end += added * BLOCK;
+    } else {
+      std::size_t stranded = boundary * BLOCK - gap_end;
+      gap_end = (boundary + added) * BLOCK - stranded;
+      std::memcpy(blocks[boundary + added - 1].get() + gap_end % BLOCK,
+                  blocks[boundary - 1].get() + (BLOCK - stranded),
+                  stranded * sizeof(T));
+    }
+  }
+};//GapBuffer
+
+#endif // GAPBUFFER_HPP
@@ -0,0 +1,215 @@
+#include "GapBuffer.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdlib>
+#include <list>
+#include <string>
+
+using namespace std;
+
+// EFFECTS: returns the contents of buffer, walking forward by Iterator
+static string forward_contents(const GapBuffer<char> &buffer) {
+    return string(buffer.begin(), buffer.end());
+}
+
+TEST(test_default_ctor) {
+    GapBuffer<char> buffer;
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_EQUAL(buffer.size(), 0);
+    ASSERT_TRUE(buffer.begin() == buffer.end());
+    ASSERT_EQUAL(buffer.str(), "");
+}
+
+TEST(test_push_pop_and_index) {
+    GapBuffer<char> buffer;
+    for (char c = 'a'; c <= 'z'; ++c) {
+        buffer.push_back(c);
+    }
+    buffer.push_front('0');
+    ASSERT_EQUAL(buffer.size(), 27);
+    ASSERT_EQUAL(buffer[0], '0');
+    ASSERT_EQUAL(buffer[1], 'a');
+    ASSERT_EQUAL(buffer.back(), 'z');
+    buffer.pop_front();
+    buffer.pop_back();
+    ASSERT_EQUAL(buffer.str(), "abcdefghijklmnopqrstuvwxy");
+    ASSERT_EQUAL(forward_contents(buffer), buffer.str());
+}
+
+TEST(test_typing_at_cursor) {
+    GapBuffer<char> buffer;
+    for (char c = 'a'; c <= 'f'; ++c) {
+        buffer.push_back(c);
+    }
+    GapBuffer<char>::Iterator it = buffer.begin();
+    ++it;
+    ++it;
+    for (char c = 'A'; c <= 'C'; ++c) {
+        it = buffer.insert(it, c);
+        ASSERT_EQUAL(*it, c);
+        ++it;
+        ASSERT_EQUAL(*it, 'c');
+    }
+    ASSERT_EQUAL(buffer.str(), "abABCcdef");
+    it = buffer.erase(it);
+    ASSERT_EQUAL(*it, 'd');
+    --it;
+    it = buffer.erase(it);
+    ASSERT_EQUAL(*it, 'd');
+    ASSERT_EQUAL(buffer.str(), "abABdef");
+}
+
+TEST(test_at) {
+    GapBuffer<char> buffer;
+    buffer.assign("abcdef");
+    buffer.insert(buffer.at(2), 'X');   // gap now sits after the X
+    ASSERT_EQUAL(*buffer.at(2), 'X');
+    ASSERT_EQUAL(*buffer.at(3), 'c');
+    ASSERT_EQUAL(*buffer.at(6), 'f');
+    ASSERT_TRUE(buffer.at(buffer.size()) == buffer.end());
+}
+
+TEST(test_for_each_chunk_sees_both_sides_of_gap) {
+    GapBuffer<char> buffer;
+    buffer.assign("abcdef");
+    buffer.insert(buffer.at(3), 'X');   // gap now sits after the X
+    string read;
+    int blocks = 0;
+    buffer.for_each_chunk(1, 6, [&](const char *chunk, int count) {
+        read.append(chunk, count);
+        ++blocks;
+        return true;
+    });
+    ASSERT_EQUAL(read, "bcXde");
+    ASSERT_EQUAL(blocks, 2);
+    blocks = 0;
+    buffer.for_each_chunk(0, 7, [&](const char *, int) {
+        ++blocks;
+        return false;
+    });
+    ASSERT_EQUAL(blocks, 1);
+}
+
+TEST(test_clear_and_reuse) {
+    GapBuffer<char> buffer;
+    buffer.reserve(1000);
+    for (int i = 0; i < 1000; ++i) {
+        buffer.push_back('x');
+    }
+    buffer.clear();
+    ASSERT_TRUE(buffer.empty());
+    buffer.push_back('y');
+    ASSERT_EQUAL(buffer.str(), "y");
+}
+
+TEST(test_range_insert_and_erase) {
+    GapBuffer<char> buffer;
+    buffer.assign("ad");
+    string middle(5000, 'x');
+    GapBuffer<char>::Iterator it = buffer.insert(buffer.at(1), middle.begin(),
+                                                 middle.end());
+    ASSERT_TRUE(it == buffer.at(1));
+    ASSERT_EQUAL(buffer.size(), 5002);
+    ASSERT_EQUAL(*buffer.at(5001), 'd');
+    string bc = "bc";
+    buffer.insert(buffer.at(5001), bc.begin(), bc.end());
+    it = buffer.erase(buffer.at(1), buffer.at(5001));
+    ASSERT_EQUAL(*it, 'b');
+    ASSERT_EQUAL(buffer.str(), "abcd");
+    ASSERT_EQUAL(forward_contents(buffer), "abcd");
+    it = buffer.erase(buffer.begin(), buffer.end());
+    ASSERT_TRUE(it == buffer.end());
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(test_random_edits_match_std_list) {
+    srand(280);
+    GapBuffer<char> buffer;
+    std::list<char> reference;
+    GapBuffer<char>::Iterator it = buffer.begin();
+    std::list<char>::iterator ref_it = reference.begin();
+    for (int step = 0; step < 20000; ++step) {
+        int op = rand() % 4;
+        if (op == 0 && ref_it != reference.end()) {
+            it = buffer.erase(it);
+            ref_it = reference.erase(ref_it);
+        } else if (op == 1) {
+            char c = static_cast<char>('a' + rand() % 26);
+            it = buffer.insert(it, c);
+            ref_it = reference.insert(ref_it, c);
+        } else if (op == 2 && ref_it != reference.end()) {
+            ++it;
+            ++ref_it;
+        } else if (op == 3 && ref_it != reference.begin()) {
+            --it;
+            --ref_it;
+        }
+        ASSERT_EQUAL(buffer.size(), static_cast<int>(reference.size()));
+        ASSERT_EQUAL(it == buffer.end(), ref_it == reference.end());
+        if (ref_it != reference.end()) {
+            ASSERT_EQUAL(*it, *ref_it);
+        }
+    }
+    string expected(reference.begin(), reference.end());
+    ASSERT_EQUAL(buffer.str(), expected);
+    ASSERT_EQUAL(forward_contents(buffer), expected);
+}
+
+TEST(test_random_edits_across_small_blocks_match_string) {
+    srand(281);
+    GapBuffer<char, 4> buffer;
+    string reference;
+    for (int step = 0; step < 5000; ++step) {
+        int index = rand() % (reference.size() + 1);
+        int op = rand() % 3;
+        if (op == 0) {
+            string text(rand() % 11, static_cast<char>('a' + rand() % 26));
+            buffer.insert(buffer.at(index), text.begin(), text.end());
+            reference.insert(index, text);
+        } else if (op == 1) {
+            int count = rand() % (reference.size() - index + 1);
+            buffer.erase(buffer.at(index), buffer.at(index + count));
+            reference.erase(index, count);
+        } else {
+            char c = static_cast<char>('A' + rand() % 26);
+            buffer.insert(buffer.at(index), c);
+            reference.insert(reference.begin() + index, c);
+        }
+        ASSERT_EQUAL(buffer.size(), static_cast<int>(reference.size()));
+    }
+    ASSERT_EQUAL(buffer.str(), reference);
+    string read;
+    buffer.for_each_chunk(3, buffer.size(), [&read](const char *chunk,
+                                                    int count) {
+        ASSERT_TRUE(count <= 4);
+        read.append(chunk, count);
+        return true;
+    });
+    ASSERT_EQUAL(read, reference.substr(3));
+}
+
+TEST(test_copy_shares_blocks_until_written) {
+    GapBuffer<char, 4> buffer;
+    buffer.assign("abcdefghij");
+    GapBuffer<char, 4> copy = buffer;
+    const char *first = nullptr;
+    copy.for_each_chunk(0, 1, [&first](const char *chunk, int) {
+        first = chunk;
+        return true;
+    });
+    buffer.for_each_chunk(0, 1, [&first](const char *chunk, int) {
+        ASSERT_EQUAL(chunk, first);
+        return true;
+    });
+    string middle = "XYZ";
+    buffer.insert(buffer.at(5), middle.begin(), middle.end());
+    buffer.erase(buffer.at(0), buffer.at(2));
+    buffer[0] = 'C';
+    ASSERT_EQUAL(buffer.str(), "CdeXYZfghij");
+    ASSERT_EQUAL(copy.str(), "abcdefghij");
+    copy.push_back('k');
+    ASSERT_EQUAL(copy.str(), "abcdefghijk");
+    ASSERT_EQUAL(buffer.str(), "CdeXYZfghij");
+}
+
+TEST_MAIN()
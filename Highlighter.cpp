@@ -0,0 +1,156 @@
+/* Highlighter.cpp
+ *
+ * Finds the matches of a search in a window of a text on a worker
+ * thread.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+#include "Highlighter.hpp"
+
+namespace {
+  // A part of a window handed to the worker, read in chunks of
+  // SCAN_CHUNK characters for as long as the window is the latest one
+  // handed over.
+  struct Window {
+    const std::string &text;
+    const std::atomic<long> &handed;
+    long number;              // of the window among those handed over
+
+    int size() const {
+      return text.size();
+    }
+
+    //EFFECTS: Returns whether a newer window was handed over.
+    bool cancelled() const {
+      return handed.load(std::memory_order_relaxed) != number;
+    }
+
+    void for_each_chunk(int begin, int end,
+                        const Search::ChunkVisitor &visit) const {
+      std::string_view all(text);
+      for (int at = begin; at < end && !cancelled();
+           at += Highlighter::SCAN_CHUNK) {
+        if (!visit(all.substr(at, std::min(Highlighter::SCAN_CHUNK,
+                                           end - at)))) {
+          return;
+        }
+      }
+    }
+  };
+}
+
+//EFFECTS: Starts the worker thread.
+Highlighter::Highlighter()
+  : waiting(false), scanning(false), ready(false), stopping(false),
+    handed(0), worker(&Highlighter::run, this) {}
+
+//EFFECTS: Cancels the scan in flight, if any, and stops the worker.
+Highlighter::~Highlighter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+    ++handed;                 // cancels the scan
+  }
+  changed.notify_all();
+  worker.join();
+}
+
+//REQUIRES: search is used by no other thread; parts are of a text, in
+//          order, and do not overlap
+//MODIFIES: *this
+//EFFECTS:  Arranges for the non-overlapping matches of search in each of
+//          parts to be found, cancelling the scan handed over before.
+void Highlighter::scan(long generation, std::shared_ptr<const Search> search,
+                       std::vector<Part> parts) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = Job{generation, std::move(search), std::move(parts)};
+    waiting = true;
+    ready = false;            // a result from before is out of date
+    ++handed;
+  }
+  changed.notify_all();
+}
+
+//EFFECTS: Returns whether the last scan handed over has finished and
+//         its result has been taken, or was cancelled.
+bool Highlighter::idle() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return !waiting && !scanning && !ready;
+}
+
+//MODIFIES: *this, result
+//EFFECTS:  Waits up to seconds for the scan in flight to finish. If the
+//          result of a scan is ready, moves it to result and returns
+//          true.
+bool Highlighter::take(Result &result, double seconds) {
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait_for(lock, std::chrono::duration<double>(seconds), [this]() {
+    return ready || (!waiting && !scanning);
+  });
+  if (!ready) {
+    return false;
+  }
+  result = std::move(done);
+  ready = false;
+  return true;
+}
+
+//EFFECTS: Returns the scans so far.
+Highlighter::Stats Highlighter::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return totals;
+}
+
+// Runs scans until stopping.
+void Highlighter::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    changed.wait(lock, [this]() { return waiting || stopping; });
+    if (stopping) {
+      return;
+    }
+    Job current = std::move(job);
+    waiting = false;
+    scanning = true;
+    long number = handed.load();
+    lock.unlock();            // the scan runs without the lock
+    auto start = std::chrono::steady_clock::now();
+    Result result;
+    result.generation = current.generation;
+    bool cancelled = false;
+    for (const Part &part : current.parts) {
+      result.ranges.emplace_back(part.begin, part.end);
+      Window window{part.text, handed, number};
+      int end = 0;            // of the last match kept, in part.text
+      auto keep = [&result, &end, &window, &part](int at, int length) {
+        if (at >= end) {
+          result.matches.emplace_back(part.at + at, length);
+          end = at + length;
+        }
+        return !window.cancelled();
+      };
+      current.search->find_all(window, part.begin - part.at,
+                               part.end - part.at, keep);
+      if (window.cancelled()) {
+        cancelled = true;
+        break;
+      }
+    }
+    double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start).count();
+    lock.lock();
+    scanning = false;
+    totals.seconds += seconds;
+    if (cancelled) {
+      ++totals.cancelled;
+    } else {
+      ++totals.scans;
+      done = std::move(result);
+      ready = true;
+    }
+    changed.notify_all();
+  }
+}
@@ -0,0 +1,116 @@
+#ifndef HIGHLIGHTER_HPP
+#define HIGHLIGHTER_HPP
+/* Highlighter.hpp
+ *
+ * Finds the matches of a search in a window of a text on a worker
+ * thread, so that the thread that edits and draws the text never waits
+ * for a scan.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Search.hpp"
+
+class Highlighter {
+  //OVERVIEW: A worker thread and the window of a text it scans: a copy
+  //          of parts of it, e.g. the columns on screen and a margin
+  //          around them, made by the editor so that it can go on
+  //          editing the text during the scan. A match that does not
+  //          lie within a part is not found. Handing over a new
+  //          window cancels the scan of the last one, which gives up
+  //          before its next chunk of SCAN_CHUNK characters; only the
+  //          result of the latest scan is kept.
+public:
+  // A part of a text to search, of whole rows or of one row: [begin,
+  // end) of the text, copied into text with the character on either
+  // side of it, if any, so that ^ and $ match where they do in the
+  // whole text.
+  struct Part {
+    int begin;
+    int end;
+    int at;                   // index in the text of text[0]
+    std::string text;
+  };
+
+  // The matches found in a window of a text.
+  struct Result {
+    long generation = -1;     // of the text and search, as handed over
+    std::vector<std::pair<int, int>> ranges;  // [begin, end) of each
+                                              // part, in order
+    std::vector<std::pair<int, int>> matches; // index in the text and
+                                              // length, in order
+  };
+
+  // Scans finished and cancelled, and the time spent on them.
+  struct Stats {
+    long scans = 0;
+    long cancelled = 0;
+    double seconds = 0;
+  };
+
+  // Characters scanned between checks for a newer window.
+  static constexpr int SCAN_CHUNK = 4096;
+
+  //EFFECTS: Starts the worker thread.
+  Highlighter();
+
+  //EFFECTS: Cancels the scan in flight, if any, and stops the worker.
+  ~Highlighter();
+
+  // disable copying
+  Highlighter(const Highlighter&) = delete;
+  Highlighter& operator=(const Highlighter&) = delete;
+
+  //REQUIRES: search is used by no other thread; parts are of a text, in
+  //          order, and do not overlap
+  //MODIFIES: *this
+  //EFFECTS:  Arranges for the non-overlapping matches of search in each
+  //          of parts to be found, cancelling the scan handed over
+  //          before.
+  void scan(long generation, std::shared_ptr<const Search> search,
+            std::vector<Part> parts);
+
+  //EFFECTS: Returns whether the last scan handed over has finished and
+  //         its result has been taken, or was cancelled.
+  bool idle() const;
+
+  //MODIFIES: *this, result
+  //EFFECTS:  Waits up to seconds for the scan in flight to finish. If
+  //          the result of a scan is ready, moves it to result and
+  //          returns true.
+  bool take(Result &result, double seconds = 0);
+
+  //EFFECTS: Returns the scans so far.
+  Stats stats() const;
+
+private:
+  struct Job {
+    long generation;
+    std::shared_ptr<const Search> search;
+    std::vector<Part> parts;
+  };
+
+  mutable std::mutex mutex;           // guards everything below but handed
+  std::condition_variable changed;    // signaled when the state changes
+  Job job;                            // waiting to be started
+  bool waiting;                       // whether job is
+  bool scanning;                      // whether a scan is running
+  bool ready;                         // whether done is to be taken
+  bool stopping;                      // whether the destructor was called
+  Result done;                        // of the last scan finished
+  Stats totals;
+  std::atomic<long> handed;           // number of windows handed over,
+                                      // read by the worker to cancel
+  std::thread worker;                 // started last, stopped first
+
+  // Runs scans until stopping.
+  void run();
+};
+
+#endif // HIGHLIGHTER_HPP
@@ -0,0 +1,522 @@
+#ifndef LINEINDEX_HPP
+#define LINEINDEX_HPP
+/* LineIndex.hpp
+ *
+ * index of row lengths for finding where a row starts in O(log n)
+ * EECS 280 Project 4
+ */
+
+#include <algorithm> //std::min
+#include <cassert>  //assert
+#include <cstdint>  //std::uint32_t
+#include <cstring>  //std::memchr
+#include <memory>   //std::shared_ptr
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+class LineIndex {
+  //OVERVIEW: the lengths of the rows of a text, in order, where a row's
+  //          length counts its characters including the '\n' that ends
+  //          it (the last row has no '\n'). Rows are 1-based. Kept as an
+  //          implicit treap (a randomized binary search tree ordered by
+  //          position) in which every node caches the number of rows and
+  //          characters in its subtree, so finding the start of a row and
+  //          updating it after an edit both take O(log rows) expected.
+  //          There is always at least one row.
+  //
+  //          An index can also be assigned a text without reading it:
+  //          its rows are then found SCAN_BLOCK characters at a time,
+  //          from the start, as far as the rows and indices looked up
+  //          need. Until then, the characters not read yet count as part
+  //          of the last row found, and an edit of a row first reads
+  //          the rest of that row, so they are never edited. Looking up
+  //          rows near the start of a large text thus touches only its
+  //          start, but row_count() reads all of it.
+
+  struct Node {
+    int left;                // child indices into nodes, or NIL
+    int right;
+    std::uint32_t priority;  // max-heap ordered, random
+    int length;              // length of this node's row
+    int rows;                // rows in this subtree
+    int total;               // characters in this subtree
+  };
+
+  static const int NIL = -1;
+
+public:
+  // Characters read at a time from a text assigned without reading it.
+  static const int SCAN_BLOCK = 64 * 1024;
+
+  // default ctor: a single empty row
+  LineIndex() : root(NIL), free_list(NIL), seed(0x9e3779b9u) {
+    root = make_node(0);
+  }
+
+  //EFFECTS: rebuilds the index for text in linear time
+  void assign(std::string_view text) {
+    nodes.clear();
+    free_list = NIL;
+    unread = std::string_view();
+    owner = nullptr;
+    root = build(row_lengths(text));
+  }
+
+  //REQUIRES: text stays valid and unchanged as long as owner_in is alive
+  //EFFECTS: makes the index describe text without reading it yet; its
+  //         rows are found as they are looked up
+  void assign(std::string_view text, std::shared_ptr<const void> owner_in) {
+    nodes.clear();
+    free_list = NIL;
+    unread = text;
+    owner = std::move(owner_in);
+    root = make_node(static_cast<int>(text.size()));
+  }
+
+  //MODIFIES: *this
+  //EFFECTS: returns the number of rows, reading all of the text
+  int row_count() {
+    while (!unread.empty()) {
+      read_block();
+    }
+    return nodes[root].rows;
+  }
+
+  //MODIFIES: *this
+  //EFFECTS: returns the smaller of row_count() and limit, reading the
+  //         text only as far as row limit
+  int rows_up_to(int limit) {
+    read_rows(limit);
+    return std::min(nodes[root].rows, limit);
+  }
+
+  //EFFECTS: returns the number of rows found so far, which is
+  //         row_count() once all of the text has been read
+  int rows_found() const {
+    return nodes[root].rows;
+  }
+
+  //REQUIRES: 1 <= row <= row_count()
+  //MODIFIES: *this
+  //EFFECTS: returns whether row is the last row
+  bool is_last_row(int row) {
+    read_rows(row + 1);
+    return row == nodes[root].rows;
+  }
+
+  //EFFECTS: returns the number of characters in all rows
+  int size() const {
+    return nodes[root].total;
+  }
+
+  //REQUIRES: 1 <= row <= row_count()
+  //MODIFIES: *this
+  //EFFECTS: returns the index of the first character in row
+  int row_start(int row) {
+    read_rows(row);
+    return start_of(row);
+  }
+
+  //REQUIRES: 1 <= row <= row_count()
+  //MODIFIES: *this
+  //EFFECTS: returns the number of characters in row, including the '\n'
+  //         that ends it, if any
+  int row_length(int row) {
+    read_rows(row + 1);
+    return length_of(row);
+  }
+
+  //REQUIRES: 1 <= row <= row_count()
+  //MODIFIES: *this
+  //EFFECTS: records that delta characters other than '\n' were inserted
+  //         into (delta > 0) or removed from (delta < 0) row
+  void resize_row(int row, int delta) {
+    read_rows(row + 1);
+    add_to_row(row, delta);
+  }
+
+  //REQUIRES: 1 <= row <= row_count(), 0 <= column < row_length(row) or
+  //          column == row_length(row) for the last row
+  //MODIFIES: *this
+  //EFFECTS: records that a '\n' was inserted before column of row,
+  //         which splits it in two
+  void split_row(int row, int column) {
+    read_rows(row + 1);
+    int length = length_of(row);
+    assert(0 <= column && column <= length);
+    add_to_row(row, column + 1 - length);
+    insert_row(row + 1, length - column);
+  }
+
+  //REQUIRES: 1 <= row <= row_count(), 0 <= column < row_length(row) or
+  //          column == row_length(row) for the last row
+  //MODIFIES: *this
+  //EFFECTS: records that text was inserted before column of row. Rows
+  //         for its line breaks are built into a treap of their own and
+  //         merged in at once, so this takes O(text.size() + log rows).
+  void insert(int row, int column, std::string_view text) {
+    read_rows(row + 1);
+    std::vector<int> lengths = row_lengths(text);
+    if (lengths.size() == 1) {
+      add_to_row(row, static_cast<int>(text.size()));
+      return;
+    }
+    // the first line of text ends row; the rest of row follows the last
+    int length = length_of(row);
+    assert(0 <= column && column <= length);
+    add_to_row(row, column + lengths.front() - length);
+    lengths.erase(lengths.begin());
+    lengths.back() += length - column;
+    int left, right;
+    split(root, row, left, right);
+    root = merge(merge(left, build(lengths)), right);
+  }
+
+  //REQUIRES: 1 <= row <= row_count(), 0 <= column <= row_length(row),
+  //          count >= 0, and there are at least count characters from
+  //          column of row to the end of the text
+  //MODIFIES: *this
+  //EFFECTS: records that count characters starting at column of row were
+  //         removed, joining row with the row the last of them was in,
+  //         and returns the number of rows removed (the '\n's among the
+  //         characters). Takes O(rows removed + log rows).
+  int erase(int row, int column, int count) {
+    read_rows(row + 1);
+    int end = start_of(row) + column + count;
+    read_through(end);
+    int end_row = row_of(end);  // end is now the column in end_row
+    if (end_row == row) {
+      add_to_row(row, -count);
+      return 0;
+    }
+    int tail = length_of(end_row) - end;
+    int left, middle, right;
+    split(root, row, left, right);
+    split(right, end_row - row, middle, right);
+    free_tree(middle);
+    root = merge(left, right);
+    add_to_row(row, column + tail - length_of(row));
+    return end_row - row;
+  }
+
+  //REQUIRES: 0 <= index <= size()
+  //MODIFIES: *this, index
+  //EFFECTS: returns the row that holds the character at index (the last
+  //         row for size()) and turns index into its column in that row
+  int locate(int &index) {
+    read_through(index);
+    return row_of(index);
+  }
+
+  //REQUIRES: 1 <= row < row_count()
+  //MODIFIES: *this
+  //EFFECTS: records that the '\n' ending row was removed, which joins
+  //         it with the following row
+  void join_rows(int row) {
+    read_rows(row + 1);
+    assert(1 <= row && row < nodes[root].rows);
+    int next_length = length_of(row + 1);
+    erase_row(row + 1);
+    add_to_row(row, next_length - 1);
+  }
+
+private:
+  std::vector<Node> nodes;  // every node, including freed ones
+  int root;                 // index of the root node
+  int free_list;            // freed nodes, chained through left
+  std::uint32_t seed;       // xorshift state for priorities
+  std::string_view unread;  // the end of the text, not read yet; it is
+                            // counted in the last row's length
+  std::shared_ptr<const void> owner; // keeps unread alive
+
+  //MODIFIES: *this
+  //EFFECTS: reads the text until row is found or all of it is read
+  void read_rows(int row) {
+    while (!unread.empty() && nodes[root].rows < row) {
+      read_block();
+    }
+  }
+
+  //MODIFIES: *this
+  //EFFECTS: reads the text until the row that holds the character at
+  //         index is known or all of it is read
+  void read_through(int index) {
+    while (!unread.empty()
+           && index > size() - static_cast<int>(unread.size())) {
+      read_block();
+    }
+  }
+
+  //REQUIRES: unread is not empty
+  //MODIFIES: *this
+  //EFFECTS: reads the next SCAN_BLOCK characters of unread, splitting
+  //         the last row at the '\n's among them
+  void read_block() {
+    std::string_view block = unread.substr(0, SCAN_BLOCK);
+    int before = static_cast<int>(unread.size());
+    unread.remove_prefix(block.size());
+    std::vector<int> lengths = row_lengths(block);
+    if (lengths.size() == 1) {
+      return; // no '\n': the last row goes on
+    }
+    // the last row ends at the first '\n'; new rows hold the rest, and
+    // the last of them what is still unread
+    add_to_row(nodes[root].rows, lengths.front() - before);
+    lengths.erase(lengths.begin());
+    lengths.back() += static_cast<int>(unread.size());
+    root = merge(root, build(lengths));
+  }
+
+  //REQUIRES: 1 <= row <= rows_found()
+  //EFFECTS: returns the index of the first character in row
+  int start_of(int row) const {
+    int start = 0;
+    find(row, start);
+    return start;
+  }
+
+  //REQUIRES: 1 <= row <= rows_found()
+  //EFFECTS: returns the number of characters in row, counting any that
+  //         are unread if it is the last one found
+  int length_of(int row) const {
+    int start = 0;
+    return nodes[find(row, start)].length;
+  }
+
+  //REQUIRES: 1 <= row <= rows_found()
+  //MODIFIES: *this
+  //EFFECTS: adds delta to the length of row
+  void add_to_row(int row, int delta) {
+    assert(1 <= row && row <= nodes[root].rows);
+    int node = root;
+    while (true) {
+      nodes[node].total += delta;
+      int left_rows = rows(nodes[node].left);
+      if (row <= left_rows) {
+        node = nodes[node].left;
+      } else if (row == left_rows + 1) {
+        nodes[node].length += delta;
+        assert(nodes[node].length >= 0);
+        return;
+      } else {
+        row -= left_rows + 1;
+        node = nodes[node].right;
+      }
+    }
+  }
+
+  //REQUIRES: 0 <= index <= size(), and the row that holds the character
+  //          at index has been found
+  //MODIFIES: index
+  //EFFECTS: returns the row that holds the character at index (the last
+  //         row for size()) and turns index into its column in that row
+  int row_of(int &index) const {
+    assert(0 <= index && index <= size());
+    int node = root;
+    int row = 0;
+    while (true) {
+      const Node &n = nodes[node];
+      int left_total = total(n.left);
+      if (index < left_total) {
+        node = n.left;
+      } else if (index - left_total < n.length || n.right == NIL) {
+        index -= left_total;
+        return row + rows(n.left) + 1;
+      } else {
+        index -= left_total + n.length;
+        row += rows(n.left) + 1;
+        node = n.right;
+      }
+    }
+  }
+
+  //EFFECTS: returns the number of rows under node, 0 for NIL
+  int rows(int node) const {
+    return node == NIL ? 0 : nodes[node].rows;
+  }
+
+  //EFFECTS: returns the number of characters under node, 0 for NIL
+  int total(int node) const {
+    return node == NIL ? 0 : nodes[node].total;
+  }
+
+  //MODIFIES: nodes[node]
+  //EFFECTS: recomputes the cached counts of node from its children
+  void update(int node) {
+    Node &n = nodes[node];
+    n.rows = 1 + rows(n.left) + rows(n.right);
+    n.total = n.length + total(n.left) + total(n.right);
+  }
+
+  //EFFECTS: returns the lengths of the rows of text, in order
+  static std::vector<int> row_lengths(std::string_view text) {
+    std::vector<int> lengths;
+    const char *start = text.data();
+    const char *end = start + text.size();
+    // memchr scans many bytes at a time for the next '\n'
+    const char *newline;
+    while (start != end
+           && (newline = static_cast<const char *>(
+                 std::memchr(start, '\n', end - start)))) {
+      lengths.push_back(static_cast<int>(newline + 1 - start));
+      start = newline + 1;
+    }
+    lengths.push_back(static_cast<int>(end - start));
+    return lengths;
+  }
+
+  //REQUIRES: lengths is not empty
+  //MODIFIES: nodes
+  //EFFECTS: builds a treap of rows with the given lengths in linear time
+  //         and returns its root
+  int build(const std::vector<int> &lengths) {
+    // treap of consecutive rows built along its right spine: each new
+    // row is the rightmost node, below every spine node with a higher
+    // priority
+    std::vector<int> spine;
+    if (nodes.size() + lengths.size() > nodes.capacity()) {
+      // at least doubling, as push_back would, since rows are added
+      // a block at a time
+      nodes.reserve(std::max(nodes.size() + lengths.size(),
+                             2 * nodes.capacity()));
+    }
+    for (int length : lengths) {
+      int node = make_node(length);
+      int last = NIL;
+      while (!spine.empty()
+             && nodes[spine.back()].priority < nodes[node].priority) {
+        last = spine.back();
+        spine.pop_back();
+        update(last);
+      }
+      nodes[node].left = last;
+      if (!spine.empty()) {
+        nodes[spine.back()].right = node;
+      }
+      spine.push_back(node);
+    }
+    while (spine.size() > 1) {
+      update(spine.back());
+      spine.pop_back();
+    }
+    update(spine.back());
+    return spine.back();
+  }
+
+  //MODIFIES: nodes
+  //EFFECTS: puts node and every node under it on the free list
+  void free_tree(int node) {
+    std::vector<int> pending;
+    if (node != NIL) {
+      pending.push_back(node);
+    }
+    while (!pending.empty()) {
+      int victim = pending.back();
+      pending.pop_back();
+      if (nodes[victim].left != NIL) {
+        pending.push_back(nodes[victim].left);
+      }
+      if (nodes[victim].right != NIL) {
+        pending.push_back(nodes[victim].right);
+      }
+      nodes[victim].left = free_list;
+      free_list = victim;
+    }
+  }
+
+  //EFFECTS: returns a new leaf node for a row of the given length
+  int make_node(int length) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    Node n{NIL, NIL, seed, length, 1, length};
+    if (free_list == NIL) {
+      nodes.push_back(n);
+      return static_cast<int>(nodes.size()) - 1;
+    }
+    int node = free_list;
+    free_list = nodes[node].left;
+    nodes[node] = n;
+    return node;
+  }
+
+  //REQUIRES: 1 <= row <= rows_found()
+  //MODIFIES: start
+  //EFFECTS: returns the node of row and adds the number of characters
+  //         before it to start
+  int find(int row, int &start) const {
+    assert(1 <= row && row <= nodes[root].rows);
+    int node = root;
+    while (true) {
+      const Node &n = nodes[node];
+      int left_rows = rows(n.left);
+      if (row <= left_rows) {
+        node = n.left;
+      } else if (row == left_rows + 1) {
+        start += total(n.left);
+        return node;
+      } else {
+        row -= left_rows + 1;
+        start += total(n.left) + n.length;
+        node = n.right;
+      }
+    }
+  }
+
+  //MODIFIES: nodes
+  //EFFECTS: splits the tree under node into the first count rows (left)
+  //         and the rest (right)
+  void split(int node, int count, int &left, int &right) {
+    if (node == NIL) {
+      left = right = NIL;
+      return;
+    }
+    Node &n = nodes[node];
+    if (rows(n.left) < count) {
+      split(n.right, count - rows(n.left) - 1, n.right, right);
+      left = node;
+    } else {
+      split(n.left, count, left, n.left);
+      right = node;
+    }
+    update(node);
+  }
+
+  //MODIFIES: nodes
+  //EFFECTS: joins the trees under left and right, with every row of left
+  //         first, and returns the root of the result
+  int merge(int left, int right) {
+    if (left == NIL || right == NIL) {
+      return left == NIL ? right : left;
+    }
+    if (nodes[left].priority > nodes[right].priority) {
+      nodes[left].right = merge(nodes[left].right, right);
+      update(left);
+      return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    update(right);
+    return right;
+  }
+
+  //EFFECTS: inserts a row of the given length so that it becomes row
+  void insert_row(int row, int length) {
+    int left, right;
+    split(root, row - 1, left, right);
+    root = merge(merge(left, make_node(length)), right);
+  }
+
+  //EFFECTS: removes row and frees its node
+  void erase_row(int row) {
+    int left, middle, right;
+    split(root, row - 1, left, right);
+    split(right, 1, middle, right);
+    nodes[middle].left = free_list;
+    free_list = middle;
+    root = merge(left, right);
+  }
+};//LineIndex
+
+#endif // LINEINDEX_HPP
@@ -0,0 +1,210 @@
+#include "LineIndex.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// EFFECTS: returns the row lengths of text, the way LineIndex counts them
+static vector<int> row_lengths(const string &text) {
+    vector<int> lengths(1, 0);
+    for (char c : text) {
+        ++lengths.back();
+        if (c == '\n') {
+            lengths.push_back(0);
+        }
+    }
+    return lengths;
+}
+
+// EFFECTS: returns whether index describes the same rows as text
+static bool matches(LineIndex &index, const string &text) {
+    vector<int> lengths = row_lengths(text);
+    if (index.row_count() != static_cast<int>(lengths.size())
+        || index.size() != static_cast<int>(text.size())) {
+        return false;
+    }
+    int start = 0;
+    for (int row = 1; row <= index.row_count(); ++row) {
+        if (index.row_start(row) != start
+            || index.row_length(row) != lengths[row - 1]) {
+            return false;
+        }
+        start += lengths[row - 1];
+    }
+    return true;
+}
+
+TEST(test_default_ctor) {
+    LineIndex index;
+    ASSERT_EQUAL(index.row_count(), 1);
+    ASSERT_EQUAL(index.row_start(1), 0);
+    ASSERT_EQUAL(index.row_length(1), 0);
+}
+
+TEST(test_assign) {
+    LineIndex index;
+    index.assign("one\ntwo\n\nfour");
+    ASSERT_EQUAL(index.row_count(), 4);
+    ASSERT_EQUAL(index.row_start(3), 8);
+    ASSERT_EQUAL(index.row_length(3), 1);
+    ASSERT_EQUAL(index.row_start(4), 9);
+    ASSERT_EQUAL(index.row_length(4), 4);
+    index.assign("ends with newline\n");
+    ASSERT_EQUAL(index.row_count(), 2);
+    ASSERT_EQUAL(index.row_length(2), 0);
+    ASSERT_TRUE(matches(index, "ends with newline\n"));
+}
+
+TEST(test_split_and_join) {
+    LineIndex index;
+    index.assign("abcdef");
+    index.split_row(1, 2);              // "ab\ncdef"
+    ASSERT_TRUE(matches(index, "ab\ncdef"));
+    index.split_row(2, 4);              // "ab\ncdef\n"
+    ASSERT_TRUE(matches(index, "ab\ncdef\n"));
+    index.resize_row(3, 2);             // "ab\ncdef\ngh"
+    ASSERT_TRUE(matches(index, "ab\ncdef\ngh"));
+    index.join_rows(1);                 // "abcdef\ngh"
+    ASSERT_TRUE(matches(index, "abcdef\ngh"));
+    index.join_rows(1);                 // "abcdefgh"
+    ASSERT_TRUE(matches(index, "abcdefgh"));
+}
+
+TEST(test_random_edits_match_text) {
+    srand(280);
+    LineIndex index;
+    string text;
+    for (int step = 0; step < 5000; ++step) {
+        int pos = text.empty() ? 0 : rand() % (text.size() + 1);
+        vector<int> lengths = row_lengths(text.substr(0, pos));
+        int row = static_cast<int>(lengths.size());
+        int column = lengths.back();
+        if (rand() % 3 == 0 && pos < static_cast<int>(text.size())) {
+            if (text[pos] == '\n') {
+                index.join_rows(row);
+            } else {
+                index.resize_row(row, -1);
+            }
+            text.erase(pos, 1);
+        } else if (rand() % 4 == 0) {
+            index.split_row(row, column);
+            text.insert(pos, 1, '\n');
+        } else {
+            index.resize_row(row, 1);
+            text.insert(pos, 1, 'x');
+        }
+        if (step % 100 == 0) {
+            ASSERT_TRUE(matches(index, text));
+            LineIndex rebuilt;
+            rebuilt.assign(text);
+            ASSERT_TRUE(matches(rebuilt, text));
+        }
+    }
+    ASSERT_TRUE(matches(index, text));
+}
+
+TEST(test_random_range_edits_match_text) {
+    srand(281);
+    LineIndex index;
+    string text;
+    for (int step = 0; step < 2000; ++step) {
+        int pos = text.empty() ? 0 : rand() % (text.size() + 1);
+        vector<int> lengths = row_lengths(text.substr(0, pos));
+        int row = static_cast<int>(lengths.size());
+        int column = lengths.back();
+        int located = pos;
+        ASSERT_EQUAL(index.locate(located), row);
+        ASSERT_EQUAL(located, column);
+        if (rand() % 2 == 0) {
+            int count = rand() % (text.size() - pos + 1);
+            index.erase(row, column, count);
+            text.erase(pos, count);
+        } else {
+            string inserted(rand() % 12, 'x');
+            for (char &c : inserted) {
+                if (rand() % 3 == 0) {
+                    c = '\n';
+                }
+            }
+            index.insert(row, column, inserted);
+            text.insert(pos, inserted);
+        }
+        if (step % 50 == 0) {
+            ASSERT_TRUE(matches(index, text));
+        }
+    }
+    ASSERT_TRUE(matches(index, text));
+}
+
+// EFFECTS: returns size characters of rows of random lengths
+static string random_rows(int size) {
+    string text(size, 'x');
+    for (char &c : text) {
+        if (rand() % 40 == 0) {
+            c = '\n';
+        }
+    }
+    return text;
+}
+
+TEST(test_assign_in_place_reads_rows_as_needed) {
+    srand(282);
+    auto original = make_shared<const string>(
+        random_rows(10 * LineIndex::SCAN_BLOCK));
+    LineIndex index;
+    index.assign(*original, original);
+    ASSERT_EQUAL(index.rows_found(), 1);
+    ASSERT_EQUAL(index.size(), static_cast<int>(original->size()));
+    vector<int> lengths = row_lengths(*original);
+    ASSERT_EQUAL(index.row_length(2), lengths[1]);
+    ASSERT_FALSE(index.is_last_row(3));
+    ASSERT_EQUAL(index.rows_up_to(5), 5);
+    // only the first block has been read
+    ASSERT_TRUE(index.rows_found() < static_cast<int>(lengths.size()) / 5);
+    int located = 3 * LineIndex::SCAN_BLOCK;
+    int row = index.locate(located);
+    vector<int> before =
+        row_lengths(original->substr(0, 3 * LineIndex::SCAN_BLOCK));
+    ASSERT_EQUAL(row, static_cast<int>(before.size()));
+    ASSERT_EQUAL(located, before.back());
+    ASSERT_TRUE(index.rows_found() < static_cast<int>(lengths.size()) / 2);
+    ASSERT_TRUE(matches(index, *original));
+    ASSERT_EQUAL(index.rows_found(), static_cast<int>(lengths.size()));
+}
+
+TEST(test_random_edits_in_place_match_text) {
+    srand(283);
+    auto original = make_shared<const string>(
+        random_rows(20 * LineIndex::SCAN_BLOCK));
+    LineIndex index;
+    index.assign(*original, original);
+    string text = *original;
+    for (int step = 0; step < 200; ++step) {
+        // edits near the start, reading the text further only slowly
+        int pos = rand() % (step * 1000 + 1);
+        vector<int> lengths = row_lengths(text.substr(0, pos));
+        int row = static_cast<int>(lengths.size());
+        int column = lengths.back();
+        if (rand() % 2 == 0) {
+            int count = rand() % 100;
+            string erased = text.substr(pos, count);
+            ASSERT_EQUAL(index.erase(row, column, count),
+                         static_cast<int>(row_lengths(erased).size()) - 1);
+            text.erase(pos, count);
+        } else {
+            string inserted = random_rows(rand() % 100);
+            index.insert(row, column, inserted);
+            text.insert(pos, inserted);
+        }
+        ASSERT_EQUAL(index.size(), static_cast<int>(text.size()));
+    }
+    int rows = static_cast<int>(row_lengths(text).size());
+    ASSERT_TRUE(index.rows_found() < rows);
+    ASSERT_TRUE(matches(index, text));
+}
+
+TEST_MAIN()
@@ -9,11 +9,19 @@
 #include <iostream>
 #include <iterator> //std::bidirectional_iterator_tag
 #include <cassert>  //assert
+#include <cstddef>  //std::size_t
+#include <memory>   //std::allocator, std::allocator_traits
+#include <new>      //placement new
+#include <utility>  //std::swap
 
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class List {
   //OVERVIEW: a doubly-linked, double-ended list with Iterator interface
+  //          Nodes are drawn from a slab/free-list pool owned by the list,
+  //          so steady-state insert/erase churn never touches the heap.
+  //          Slabs themselves come from Allocator (rebound to the slot
+  //          type) and are only returned when the list is destroyed.
 public:
 
   //EFFECTS:  returns true if the list is empty
@@ -45,8 +53,7 @@ public:
 
   //EFFECTS:  inserts datum into the front of the list
     void push_front(const T &datum) {
-        Node *p = new Node;
-        p->datum = datum;
+        Node *p = create_node(datum);
         if (empty()) {
             first = last = p;
             p->next = nullptr;
@@ -63,9 +70,7 @@ public:
 
   //EFFECTS:  inserts datum into the back of the list
     void push_back(const T &datum) {
-        Node *p = new Node;
-        p->datum = datum;
-        p->next = nullptr;
+        Node *p = create_node(datum);
         if (empty()) {
             last = first = p;
             p->next = nullptr;
@@ -93,7 +98,7 @@ public:
             first = first->next;
             first->prev = nullptr;
         }
-        delete victim;
+        destroy_node(victim);
         --list_size;
     }
 
@@ -110,7 +115,7 @@ public:
             last = last->prev;
             last->next = nullptr;
         }
-        delete victim;
+        destroy_node(victim);
         --list_size;
     }
 
@@ -128,20 +133,27 @@ public:
   // of the class must be able to create, copy, assign, and destroy Lists.
 
     // default ctor
-    List() : list_size(0), first(nullptr), last(nullptr) {}
-    
-    
+    List() : List(Allocator()) {}
+
+    // ctor with an explicit allocator for the node slabs
+    explicit List(const Allocator &alloc_in)
+      : list_size(0), first(nullptr), last(nullptr),
+        slot_alloc(alloc_in), free_slots(nullptr), slabs(nullptr),
+        next_slab_size(MIN_SLAB_SLOTS) {}
+
     // copy ctor
-    List(const List<T> &other) : list_size(0), first(nullptr), last(nullptr) {
+    List(const List &other)
+      : List(std::allocator_traits<SlotAllocator>::
+             select_on_container_copy_construction(other.slot_alloc)) {
         copy_all(other);
     }
 
     // assignment operator
-    List& operator=(const List<T> &rhs) {
+    List& operator=(const List &rhs) {
         if (this == &rhs) {  // preventing self-assignment
             return *this;
         }
-        clear();
+        clear();          // nodes go back to our own pool and get reused
         copy_all(rhs);
         return *this;
     }
@@ -149,9 +161,22 @@ public:
     // dtor
     ~List() {
         clear();
+        release_slabs();
+    }
+
+  //EFFECTS: makes sure at least n more elements can be added without
+  //         the list requesting memory from its allocator
+    void reserve(int n) {
+        int available = 0;
+        for (Slot *s = free_slots; s != nullptr && available < n;
+             s = s->next_free) {
+            ++available;
+        }
+        if (available < n) {
+            add_slab(static_cast<std::size_t>(n - available));
+        }
     }
 
-    
 private:
   //a private type
   struct Node {
@@ -160,22 +185,100 @@ private:
     T datum;
   };
 
+  // Storage for one pooled Node. While a slot is on the free list it
+  // holds the link to the next free slot instead of a Node; the first
+  // slot of every slab is reserved as the slab header.
+  union Slot;
+  struct SlabHeader {
+    Slot *next_slab;
+    std::size_t count;  // number of slots in the slab, header included
+  };
+  union Slot {
+    Slot *next_free;
+    SlabHeader header;
+    alignas(Node) unsigned char storage[sizeof(Node)];
+  };
+
+  using SlotAllocator = typename std::allocator_traits<Allocator>::
+    template rebind_alloc<Slot>;
+  using SlotTraits = std::allocator_traits<SlotAllocator>;
+
+  static const std::size_t MIN_SLAB_SLOTS = 16;
+  static const std::size_t MAX_SLAB_SLOTS = 4096;
+
   // size of the list for size() function
   int list_size;
     
   //REQUIRES: list is empty
   //EFFECTS:  copies all nodes from other to this
-    void copy_all(const List<T> &other) {
+    void copy_all(const List &other) {
         // first need to assert that this list is empty
         assert(empty());
+        reserve(other.size());
         for (Node *ptr = other.first; ptr != nullptr; ptr = ptr->next) {
             push_back(ptr->datum);
         }
     }
 
+  //EFFECTS: returns a new Node holding datum, taken from the pool
+    Node * create_node(const T &datum) {
+        if (free_slots == nullptr) {
+            add_slab(next_slab_size);
+            // grow geometrically so small lists stay small
+            if (next_slab_size < MAX_SLAB_SLOTS) {
+                next_slab_size *= 2;
+            }
+        }
+        Slot *slot = free_slots;
+        free_slots = slot->next_free;
+        return ::new (static_cast<void *>(slot->storage))
+            Node{nullptr, nullptr, datum};
+    }
+
+  //REQUIRES: p was returned by create_node() on this list
+  //EFFECTS: destroys p and puts its slot back on the free list
+    void destroy_node(Node *p) {
+        p->~Node();
+        Slot *slot = reinterpret_cast<Slot *>(p);
+        slot->next_free = free_slots;
+        free_slots = slot;
+    }
+
+  //EFFECTS: allocates a slab with room for at least n nodes and puts
+  //         its slots on the free list
+    void add_slab(std::size_t n) {
+        std::size_t count = n + 1;  // one extra slot for the header
+        Slot *slab = SlotTraits::allocate(slot_alloc, count);
+        slab->header.next_slab = slabs;
+        slab->header.count = count;
+        slabs = slab;
+        // thread back to front so nodes come out in address order
+        for (std::size_t i = count - 1; i > 0; --i) {
+            slab[i].next_free = free_slots;
+            free_slots = &slab[i];
+        }
+    }
+
+  //REQUIRES: list is empty
+  //EFFECTS: returns every slab to the allocator
+    void release_slabs() {
+        assert(empty());
+        while (slabs != nullptr) {
+            Slot *victim = slabs;
+            slabs = victim->header.next_slab;
+            SlotTraits::deallocate(slot_alloc, victim, victim->header.count);
+        }
+        free_slots = nullptr;
+    }
+
   Node *first;   // points to first Node in list, or nullptr if list is empty
   Node *last;    // points to last Node in list, or nullptr if list is empty
 
+  SlotAllocator slot_alloc;   // source of slab memory
+  Slot *free_slots;           // singly-linked list of unused slots
+  Slot *slabs;                // singly-linked list of slabs (via headers)
+  std::size_t next_slab_size; // slots to request for the next slab
+
 public:
   ////////////////////////////////////////
   class Iterator {
@@ -244,6 +347,12 @@ public:
           }
           return *this;
       }
+
+      Iterator operator++ (int) {
+          Iterator copy = *this;
+          operator++();
+          return copy;
+      }
       
       bool operator== (const Iterator& rhs) const {
           return node_ptr == rhs.node_ptr;
@@ -347,7 +456,7 @@ public:
             temp->prev->next = temp->next;
             temp->next->prev = temp->prev;
             i.node_ptr = i.node_ptr->next;
-            delete temp;
+            destroy_node(temp);
             --list_size;
             return i;      // i now points to the next ptr 
         }
@@ -370,16 +479,73 @@ public:
             return Iterator(this, last);
         }
         else {  // if i is somewhere in the middle of the list
-            Node *new_node = new Node;
-            new_node->datum = datum;
+            Node *new_node = create_node(datum);
             new_node->prev = temp->prev;
             new_node->next = temp;
+            temp->prev->next = new_node;  // link predecessor before relinking temp
             temp->prev = new_node;
-            temp->prev->next = new_node;
             ++list_size;
             return Iterator(this, new_node);
         }
     }
+
+  //REQUIRES: i is a valid iterator associated with this list, and
+  //          [range_begin, range_end) is a range that is not in this list
+  //EFFECTS: Inserts copies of the elements in [range_begin, range_end)
+  //         before the element at the specified position. The new nodes
+  //         are linked to each other first and spliced in with a single
+  //         relink. Returns an iterator to the first inserted element, or
+  //         i if the range is empty.
+    template <typename InputIterator>
+    Iterator insert(Iterator i, InputIterator range_begin,
+                    InputIterator range_end) {
+        assert(i.list_ptr == this);
+        if (range_begin == range_end) {
+            return i;
+        }
+        Node *head = create_node(*range_begin);
+        Node *tail = head;
+        int count = 1;
+        for (++range_begin; range_begin != range_end; ++range_begin) {
+            Node *p = create_node(*range_begin);
+            p->prev = tail;
+            tail->next = p;
+            tail = p;
+            ++count;
+        }
+        Node *after = i.node_ptr;
+        Node *before = (after == nullptr ? last : after->prev);
+        head->prev = before;
+        tail->next = after;
+        (before == nullptr ? first : before->next) = head;
+        (after == nullptr ? last : after->prev) = tail;
+        list_size += count;
+        return Iterator(this, head);
+    }
+
+  //REQUIRES: [range_begin, range_end) is a valid range of iterators
+  //          associated with this list
+  //MODIFIES: may invalidate other list iterators
+  //EFFECTS: Removes the elements in [range_begin, range_end), unlinking
+  //         them with a single relink. Returns range_end.
+    Iterator erase(Iterator range_begin, Iterator range_end) {
+        assert(range_begin.list_ptr == this && range_end.list_ptr == this);
+        Node *victim = range_begin.node_ptr;
+        Node *after = range_end.node_ptr;
+        if (victim == after) {
+            return range_end;
+        }
+        Node *before = victim->prev;
+        (before == nullptr ? first : before->next) = after;
+        (after == nullptr ? last : after->prev) = before;
+        while (victim != after) {
+            Node *next = victim->next;
+            destroy_node(victim);
+            --list_size;
+            victim = next;
+        }
+        return range_end;
+    }
 };//List
 
 
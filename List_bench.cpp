@@ -0,0 +1,183 @@
+/* List_bench.cpp
+ *
+ * Throughput and peak RSS of List<char>'s pooled nodes against
+ * std::list<char>, which allocates and frees every node individually
+ * (the way List did before it had a pool), followed by memory per byte
+ * and sequential scan speed of UnrolledList<char> against List<char>.
+ *
+ * Usage: ./List_bench.exe [num_chars]
+ * Each case runs in a forked child so its peak RSS is measured alone.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "List.hpp"
+#include "UnrolledList.hpp"
+
+using namespace std;
+
+static volatile long sink; // keeps results alive under optimization
+
+// EFFECTS: Returns seconds taken by f().
+static double time_it(const function<void()> &f) {
+  auto start = chrono::steady_clock::now();
+  f();
+  return chrono::duration<double>(chrono::steady_clock::now() - start)
+    .count();
+}
+
+// EFFECTS: Loads n chars, types n/4 chars in the middle, erases them
+//          again, then cuts and reloads the whole thing. Prints the
+//          rate of each phase in millions of operations per second.
+template <typename ListType>
+static void run_case(const char *name, int n) {
+  ListType list;
+  double load = time_it([&]() {
+    for (int i = 0; i < n; ++i) {
+      list.push_back(static_cast<char>('a' + i % 26));
+    }
+  });
+
+  auto middle = list.begin();
+  for (int i = 0; i < n / 2; ++i) {
+    ++middle;
+  }
+  int edits = n / 4;
+  double insert = time_it([&]() {
+    for (int i = 0; i < edits; ++i) {
+      middle = list.insert(middle, 'x');
+      ++middle;
+    }
+  });
+  double erase = time_it([&]() {
+    for (int i = 0; i < edits; ++i) {
+      --middle;
+      middle = list.erase(middle);
+    }
+  });
+  double reload = time_it([&]() {
+    list.clear();
+    for (int i = 0; i < n; ++i) {
+      list.push_back('z');
+    }
+  });
+  sink = list.size();
+
+  printf("%-16s load %7.1f  insert %7.1f  erase %7.1f  reload %7.1f Mops/s",
+         name, n / load / 1e6, edits / insert / 1e6, edits / erase / 1e6,
+         n / reload / 1e6);
+  fflush(stdout);
+}
+
+// Allocator that tracks how many bytes its containers hold.
+static size_t bytes_in_use = 0;
+
+template <typename T>
+struct ByteCounter {
+  using value_type = T;
+
+  ByteCounter() = default;
+  template <typename U>
+  ByteCounter(const ByteCounter<U> &) {}
+
+  T * allocate(size_t n) {
+    bytes_in_use += n * sizeof(T);
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T *p, size_t n) {
+    bytes_in_use -= n * sizeof(T);
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <typename U>
+  bool operator==(const ByteCounter<U> &) const { return true; }
+  template <typename U>
+  bool operator!=(const ByteCounter<U> &) const { return false; }
+};
+
+// EFFECTS: Loads n chars, reports bytes of storage per char both after
+//          the load and after typing n/4 chars at scattered positions,
+//          then times a sequential scan and a copy into a std::string
+//          (what TextBuffer::stringify() does).
+template <typename ListType>
+static void run_scan_case(const char *name, int n) {
+  bytes_in_use = 0;
+  ListType list;
+  for (int i = 0; i < n; ++i) {
+    list.push_back(static_cast<char>('a' + i % 26));
+  }
+  double loaded = static_cast<double>(bytes_in_use) / n;
+
+  // type short words at positions spread across the list
+  auto it = list.begin();
+  int edits = n / 4;
+  for (int i = 0; i < edits; ++i) {
+    if (i % 8 == 0) {
+      for (int skip = 0; skip < 24 && it != list.end(); ++skip) {
+        ++it;
+      }
+      if (it == list.end()) {
+        it = list.begin();
+      }
+    }
+    it = list.insert(it, 'x');
+    ++it;
+  }
+  double edited = static_cast<double>(bytes_in_use) / list.size();
+
+  long sum = 0;
+  double scan = time_it([&]() {
+    for (auto p = list.begin(); p != list.end(); ++p) {
+      sum += *p;
+    }
+  });
+  string copy;
+  double stringify = time_it([&]() {
+    copy = string(list.begin(), list.end());
+  });
+  sink = sum + copy.size();
+
+  printf("%-16s %5.1f B/char loaded  %5.1f B/char edited  "
+         "scan %7.1f MB/s  stringify %7.1f MB/s",
+         name, loaded, edited, list.size() / scan / 1e6,
+         list.size() / stringify / 1e6);
+  fflush(stdout);
+}
+
+// EFFECTS: Runs f in a child process and prints the child's peak RSS.
+static void isolated(const function<void()> &f) {
+  fflush(stdout); // don't let the child inherit buffered output
+  pid_t pid = fork();
+  if (pid == 0) {
+    f();
+    _exit(0);
+  }
+  int status;
+  struct rusage usage;
+  wait4(pid, &status, 0, &usage);
+  printf("  peak RSS %7.1f MB\n", usage.ru_maxrss / 1024.0);
+}
+
+int main(int argc, char **argv) {
+  int n = argc > 1 ? atoi(argv[1]) : 10000000;
+  printf("List benchmark, %d chars\n", n);
+  isolated([n]() { run_case<List<char>>("List<char>", n); });
+  isolated([n]() { run_case<std::list<char>>("std::list<char>", n); });
+
+  printf("\nStorage density and sequential scan, %d chars\n", n);
+  isolated([n]() {
+    run_scan_case<List<char, ByteCounter<char>>>("List<char>", n);
+  });
+  isolated([n]() {
+    run_scan_case<UnrolledList<char, 236, ByteCounter<char>>>(
+      "UnrolledList", n);
+  });
+}
@@ -1,13 +1,174 @@
 #include "List.hpp"
 #include "unit_test_framework.hpp"
 
+#include <cstddef>
+#include <memory>
+#include <string>
+
 using namespace std;
 
-// Add your test cases here
+// Allocator that counts the calls the List makes for its node slabs.
+static int slab_allocations = 0;
+static int slab_deallocations = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &) {}
+
+    T * allocate(std::size_t n) {
+        ++slab_allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, std::size_t n) {
+        ++slab_deallocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U> &) const { return false; }
+};
+
+TEST(test_insert_middle_links) {
+    List<int> list;
+    list.push_back(1);
+    list.push_back(3);
+    List<int>::Iterator it = list.begin();
+    ++it;
+    it = list.insert(it, 2);
+    ASSERT_EQUAL(*it, 2);
+    int expected = 1;
+    for (it = list.begin(); it != list.end(); ++it, ++expected) {
+        ASSERT_EQUAL(*it, expected);
+    }
+    ASSERT_EQUAL(expected, 4);
+    it = list.end();
+    for (expected = 3; expected > 0; --expected) {
+        --it;
+        ASSERT_EQUAL(*it, expected);
+    }
+    ASSERT_TRUE(it == list.begin());
+}
+
+TEST(test_postfix_increment) {
+    List<int> list;
+    list.push_back(7);
+    list.push_back(8);
+    List<int>::Iterator it = list.begin();
+    ASSERT_EQUAL(*(it++), 7);
+    ASSERT_EQUAL(*it, 8);
+    it++;
+    ASSERT_TRUE(it == list.end());
+}
+
+TEST(test_pool_uses_few_slabs) {
+    slab_allocations = slab_deallocations = 0;
+    {
+        List<char, CountingAllocator<char>> list;
+        for (int i = 0; i < 100000; ++i) {
+            list.push_back('x');
+        }
+        ASSERT_EQUAL(list.size(), 100000);
+        // slabs grow geometrically up to a cap, so this is far fewer
+        // than one allocation per node
+        ASSERT_TRUE(slab_allocations < 100);
+    }
+    ASSERT_EQUAL(slab_allocations, slab_deallocations);
+}
+
+TEST(test_pool_reuses_freed_nodes) {
+    slab_allocations = slab_deallocations = 0;
+    List<char, CountingAllocator<char>> list;
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back('a');
+    }
+    int after_fill = slab_allocations;
+    // churn: erase and insert in the middle, then clear and refill
+    List<char, CountingAllocator<char>>::Iterator it = list.begin();
+    for (int i = 0; i < 500; ++i) {
+        ++it;
+    }
+    for (int i = 0; i < 10000; ++i) {
+        it = list.erase(it);
+        it = list.insert(it, 'b');
+    }
+    list.clear();
+    for (int i = 0; i < 1000; ++i) {
+        list.push_front('c');
+    }
+    ASSERT_EQUAL(slab_allocations, after_fill);
+    ASSERT_EQUAL(slab_deallocations, 0);
+}
+
+TEST(test_reserve) {
+    slab_allocations = slab_deallocations = 0;
+    List<int, CountingAllocator<int>> list;
+    list.reserve(5000);
+    ASSERT_EQUAL(slab_allocations, 1);
+    for (int i = 0; i < 5000; ++i) {
+        list.push_back(i);
+    }
+    ASSERT_EQUAL(slab_allocations, 1);
+    ASSERT_EQUAL(list.back(), 4999);
+}
+
+TEST(test_copy_and_assign_have_own_pools) {
+    List<int> a;
+    for (int i = 0; i < 50; ++i) {
+        a.push_back(i);
+    }
+    List<int> b(a);
+    a.clear();
+    ASSERT_EQUAL(b.size(), 50);
+    ASSERT_EQUAL(b.front(), 0);
+    ASSERT_EQUAL(b.back(), 49);
+    a = b;
+    b.clear();
+    ASSERT_EQUAL(a.size(), 50);
+    int expected = 0;
+    for (List<int>::Iterator it = a.begin(); it != a.end(); ++it) {
+        ASSERT_EQUAL(*it, expected++);
+    }
+}
+
+TEST(test_range_insert_and_erase) {
+    List<char> list;
+    list.push_back('a');
+    list.push_back('z');
+    std::string middle = "bcd";
+    List<char>::Iterator it = list.insert(++list.begin(), middle.begin(),
+                                          middle.end());
+    ASSERT_EQUAL(*it, 'b');
+    ASSERT_EQUAL(list.size(), 5);
+    std::string tail = "!?";
+    it = list.insert(list.end(), tail.begin(), tail.end());
+    ASSERT_EQUAL(*it, '!');
+    ASSERT_EQUAL(list.back(), '?');
+    ASSERT_EQUAL(std::string(list.begin(), list.end()), "abcdz!?");
 
-TEST(test_stub) {
-    // Add test code here
-    ASSERT_TRUE(true);
+    // erase "cdz!", then everything before the '?'
+    List<char>::Iterator first = ++++list.begin();
+    List<char>::Iterator last = first;
+    for (int i = 0; i < 4; ++i) {
+        ++last;
+    }
+    it = list.erase(first, last);
+    ASSERT_EQUAL(*it, '?');
+    ASSERT_EQUAL(std::string(list.begin(), list.end()), "ab?");
+    it = list.erase(list.begin(), it);
+    ASSERT_TRUE(it == list.begin());
+    ASSERT_EQUAL(list.size(), 1);
+    ASSERT_EQUAL(list.front(), '?');
+    it = list.erase(list.begin(), list.end());
+    ASSERT_TRUE(it == list.end());
+    ASSERT_TRUE(list.empty());
+    ASSERT_TRUE(list.insert(list.end(), tail.end(), tail.end()) == list.end());
 }
 
 TEST_MAIN()
@@ -0,0 +1,84 @@
+/* MappedFile.cpp
+ *
+ * A file mapped read-only into memory with mmap.
+ */
+
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedFile.hpp"
+
+//EFFECTS: Maps the file at path, if it is a regular, non-empty file
+//         that can be read. Otherwise, is_open() is false.
+MappedFile::MappedFile(const std::string &path)
+  : data(nullptr), length(0), device(0), inode(0) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat info;
+  if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+    void *mapping = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE,
+                           fd, 0);
+    if (mapping != MAP_FAILED) {
+      data = static_cast<char *>(mapping);
+      length = info.st_size;
+      device = info.st_dev;
+      inode = info.st_ino;
+    }
+  }
+  ::close(fd); // the mapping keeps the file open
+}
+
+//EFFECTS: Unmaps the file.
+MappedFile::~MappedFile() {
+  if (data) {
+    ::munmap(data, length);
+  }
+}
+
+//EFFECTS: Returns whether the file is mapped.
+bool MappedFile::is_open() const {
+  return data != nullptr;
+}
+
+//EFFECTS: Returns the contents of the file.
+std::string_view MappedFile::view() const {
+  return std::string_view(data, length);
+}
+
+//EFFECTS: Drops the pages touched so far from this process's memory.
+void MappedFile::release() const {
+  if (data) {
+    // the mapping is read-only, so no changes are lost
+    ::madvise(data, length, MADV_DONTNEED);
+  }
+}
+
+//EFFECTS: Drops the pages that lie wholly within part, if part is a view
+//         into the mapping.
+void MappedFile::release(std::string_view part) const {
+  // compared as addresses, since part may point anywhere
+  std::uintptr_t start = reinterpret_cast<std::uintptr_t>(data);
+  std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(part.data());
+  std::uintptr_t end = begin + part.size();
+  if (!data || begin < start || end > start + length) {
+    return;
+  }
+  // only whole pages can be dropped, and the mapping starts on a page
+  std::size_t page = ::sysconf(_SC_PAGESIZE);
+  std::size_t first = (begin - start + page - 1) / page * page;
+  std::size_t last = (end - start) / page * page;
+  if (first < last) {
+    ::madvise(data + first, last - first, MADV_DONTNEED);
+  }
+}
+
+//EFFECTS: Returns whether path names the file that is mapped.
+bool MappedFile::is_file(const std::string &path) const {
+  struct stat info;
+  return data && ::stat(path.c_str(), &info) == 0
+    && info.st_dev == device && info.st_ino == inode;
+}
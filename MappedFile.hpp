@@ -0,0 +1,61 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+/* MappedFile.hpp
+ *
+ * A file mapped read-only into memory, so that its contents can be used
+ * in place: the kernel reads a page of the file in only when it is first
+ * touched, and can drop it again once it has been released.
+ */
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+
+class MappedFile {
+  //OVERVIEW: The contents of a regular file, mapped privately and
+  //          read-only for the lifetime of the object. Writes to the
+  //          file by others may show through, and truncating it makes
+  //          the cut-off pages unreadable, so files that are being
+  //          rewritten in place should not be mapped for long.
+public:
+  //EFFECTS: Maps the file at path, if it is a regular, non-empty file
+  //         that can be read. Otherwise, is_open() is false.
+  explicit MappedFile(const std::string &path);
+
+  //EFFECTS: Unmaps the file.
+  ~MappedFile();
+
+  // disable copying
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  //EFFECTS: Returns whether the file is mapped.
+  bool is_open() const;
+
+  //EFFECTS: Returns the contents of the file, which are valid as long as
+  //         *this is alive. Empty if the file is not mapped.
+  std::string_view view() const;
+
+  //EFFECTS: Drops the pages touched so far from this process's memory.
+  //         The contents stay the same; a page is read in again (usually
+  //         from the kernel's page cache) when it is next touched.
+  void release() const;
+
+  //EFFECTS: Drops the pages that lie wholly within part from this
+  //         process's memory, if part is a view into the mapping, like
+  //         release(). Does nothing otherwise.
+  void release(std::string_view part) const;
+
+  //EFFECTS: Returns whether path names the file that is mapped (the
+  //         same file, not one with the same contents).
+  bool is_file(const std::string &path) const;
+
+private:
+  char *data;                 // start of the mapping, or nullptr
+  std::size_t length;         // size of the file when it was mapped
+  dev_t device;               // identity of the mapped file
+  ino_t inode;
+};
+
+#endif // MAPPEDFILE_HPP
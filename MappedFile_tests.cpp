@@ -0,0 +1,63 @@
+#include "MappedFile.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+// EFFECTS: writes contents to the file at path, replacing it
+static void write(const string &path, const string &contents) {
+    ofstream(path, ios::binary) << contents;
+}
+
+TEST(test_maps_contents) {
+    const string path = "MappedFile_tests-a.tmp";
+    write(path, "hello\nworld\n");
+    MappedFile file(path);
+    ASSERT_TRUE(file.is_open());
+    ASSERT_EQUAL(file.view(), "hello\nworld\n");
+    file.release();                 // pages come back when touched
+    ASSERT_EQUAL(file.view(), "hello\nworld\n");
+    file.release(file.view().substr(2, 5));
+    file.release("not in the mapping");
+    ASSERT_EQUAL(file.view(), "hello\nworld\n");
+    remove(path.c_str());
+    ASSERT_EQUAL(file.view().substr(6), "world\n");
+}
+
+TEST(test_missing_and_empty_files) {
+    MappedFile missing("MappedFile_tests-missing.tmp");
+    ASSERT_FALSE(missing.is_open());
+    ASSERT_EQUAL(missing.view(), "");
+    missing.release();
+
+    const string path = "MappedFile_tests-empty.tmp";
+    write(path, "");
+    MappedFile empty(path);
+    ASSERT_FALSE(empty.is_open());
+    remove(path.c_str());
+
+    MappedFile directory(".");
+    ASSERT_FALSE(directory.is_open());
+}
+
+TEST(test_is_file) {
+    const string path = "MappedFile_tests-b.tmp";
+    const string other = "MappedFile_tests-c.tmp";
+    write(path, "same");
+    write(other, "same");
+    MappedFile file(path);
+    ASSERT_TRUE(file.is_file(path));
+    ASSERT_TRUE(file.is_file("./" + path));
+    ASSERT_FALSE(file.is_file(other));
+    // replacing the file leaves the mapping with the old one
+    rename(other.c_str(), path.c_str());
+    ASSERT_FALSE(file.is_file(path));
+    ASSERT_EQUAL(file.view(), "same");
+    remove(path.c_str());
+    ASSERT_FALSE(file.is_file(path));
+}
+
+TEST_MAIN()
@@ -0,0 +1,99 @@
+/* MatchIndex.cpp
+ *
+ * The matches of a search in a text, split at a gap like a gap buffer.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include "MatchIndex.hpp"
+
+// EFFECTS: Returns where index ends up after change: the same place if
+//          it is before the edit, shifted along with the text if it is
+//          after it, and the start of the edit (or its end, for the end
+//          of a range) if the edit removed it.
+static int shift(int index, const TextChange &change, bool end_of_range) {
+  if (index <= change.index) {
+    return index;
+  } else if (index >= change.index + change.removed) {
+    return index + change.inserted - change.removed;
+  }
+  return change.index + (end_of_range ? change.inserted : 0);
+}
+
+//EFFECTS: Creates an index with no search and no matches.
+MatchIndex::MatchIndex() : length(0) {}
+
+//EFFECTS: Returns the pattern whose matches are indexed, or "" if there
+//         is none.
+const std::string &MatchIndex::pattern() const {
+  static const std::string none;
+  return searched ? searched->pattern() : none;
+}
+
+//REQUIRES: 0 <= k < count()
+//EFFECTS:  Returns the index in the text of match k, counting from 0.
+int MatchIndex::position(int k) const {
+  assert(0 <= k && k < count());
+  if (k < static_cast<int>(before.size())) {
+    return before[k];
+  }
+  return length - after[after.size() - 1 - (k - before.size())];
+}
+
+//EFFECTS: Returns the number of matches that start before index, which
+//         is also the number k of the first match at or after it.
+int MatchIndex::count_before(int index) const {
+  auto first = std::lower_bound(before.begin(), before.end(), index);
+  if (first != before.end()) {
+    return first - before.begin();
+  }
+  // a match after the gap starts before index if it is further than
+  // length - index from the end
+  auto nearer = std::upper_bound(after.begin(), after.end(), length - index);
+  return before.size() + (after.end() - nearer);
+}
+
+//REQUIRES: 0 <= index <= length
+//MODIFIES: *this
+//EFFECTS:  Moves the gap to index: the matches that start before it end
+//          up in before, the rest in after.
+void MatchIndex::move_gap(int index) {
+  while (!before.empty() && before.back() >= index) {
+    after.push_back(length - before.back());
+    before.pop_back();
+  }
+  while (!after.empty() && length - after.back() < index) {
+    before.push_back(length - after.back());
+    after.pop_back();
+  }
+}
+
+//MODIFIES: *this, begin, end
+//EFFECTS:  Applies changes to the matches and the length, dropping the
+//          matches they broke, and sets [begin, end) to a range of the
+//          new text that holds every match they may have made.
+void MatchIndex::apply(const std::vector<TextChange> &changes, int &begin,
+                       int &end) {
+  for (std::size_t i = 0; i < changes.size(); ++i) {
+    const TextChange &change = changes[i];
+    // a match is broken if it overlaps the removed characters or has
+    // characters inserted into it
+    int first = std::max(change.index - size() + 1, 0);
+    move_gap(first);
+    while (!after.empty()
+           && length - after.back() < change.index + change.removed) {
+      after.pop_back();
+    }
+    // the matches after the gap move along with the end of the text
+    length += change.inserted - change.removed;
+    int last = std::min(change.index + change.inserted + size() - 1,
+                        length);
+    if (i == 0) {
+      begin = first;
+      end = last;
+    } else {
+      begin = std::min(shift(begin, change, false), first);
+      end = std::max(shift(end, change, true), last);
+    }
+  }
+}
@@ -0,0 +1,153 @@
+#ifndef MATCHINDEX_HPP
+#define MATCHINDEX_HPP
+/* MatchIndex.hpp
+ *
+ * Where every match of the string or regular expression being searched
+ * for is in a text buffer: found in one pass over the text when the
+ * search is new, then kept up to date from the buffer's change log, so
+ * going to the next or previous match, or counting them, never reads
+ * the text again.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Search.hpp"
+#include "TextBuffer.hpp"
+
+class MatchIndex {
+  //OVERVIEW: The starting indices of the matches of a search in a text,
+  //          in order, as its find_all() finds them. Like a gap buffer,
+  //          they are split at a point of the text, the gap: matches
+  //          before the gap are kept as indices, and those after it as
+  //          distances from the end of the text, so an edit at the gap
+  //          does not change any of them. An edit elsewhere first moves
+  //          the gap there, which takes time in the number of matches
+  //          in between; edits close to the last one are cheap.
+  //          Looking up matches takes O(log matches). After an edit,
+  //          the text is read again around it: as far as a string's
+  //          matches reach, or the whole rows it touched for a regular
+  //          expression's.
+public:
+  //EFFECTS: Creates an index with no search and no matches.
+  MatchIndex();
+
+  //EFFECTS: Returns the search whose matches are indexed, or nullptr if
+  //         there is none.
+  const Search *search() const {
+    return searched.get();
+  }
+
+  //EFFECTS: Returns the pattern whose matches are indexed, or "" if
+  //         there is none.
+  const std::string &pattern() const;
+
+  //REQUIRES: search_in is not null, text has no changes logged
+  //MODIFIES: *this
+  //EFFECTS:  Indexes the matches of search_in in text, reading it once.
+  template <typename Text>
+  void rebuild(std::shared_ptr<const Search> search_in, const Text &text) {
+    searched = std::move(search_in);
+    before.clear();
+    after.clear();
+    length = text.size();
+    searched->find_all(text, 0, length, [this](int at, int) {
+      before.push_back(at);
+      return true;
+    });
+  }
+
+  //REQUIRES: pattern_in is not empty, text has no changes logged
+  //MODIFIES: *this
+  //EFFECTS:  Indexes the occurrences of the string pattern_in in text,
+  //          reading it once.
+  template <typename Text>
+  void rebuild(const std::string &pattern_in, const Text &text) {
+    rebuild(std::make_shared<SubstringSearch>(pattern_in), text);
+  }
+
+  //MODIFIES: *this
+  //EFFECTS:  Forgets the search and its matches, e.g. before an edit
+  //          that rewrites so much of the text that finding them again
+  //          when they are next needed costs no more than updating them.
+  void clear() {
+    searched = nullptr;
+    before.clear();
+    after.clear();
+    length = 0;
+  }
+
+  //REQUIRES: changes are the edits that made text out of the text last
+  //          indexed, in order; Text has row_range() like TextBuffer's
+  //MODIFIES: *this
+  //EFFECTS:  Drops the matches the edits broke, shifts the ones after
+  //          them, and finds the ones they made, reading only the text
+  //          around the edits.
+  template <typename Text>
+  void update(const std::vector<TextChange> &changes, const Text &text) {
+    if (!searched || changes.empty()) {
+      return;
+    }
+    int begin, end;
+    apply(changes, begin, end);
+    if (searched->match_length() < 0) {
+      // the edits may have changed every match in the rows they touched
+      int row_end;
+      text.row_range(begin, begin, row_end);
+      text.row_range(end, row_end, end);
+    }
+    move_gap(begin);
+    // the matches within [begin, end) are all found again
+    while (!after.empty() && length - after.back() + size() <= end) {
+      after.pop_back();
+    }
+    searched->find_all(text, begin, end, [this](int at, int) {
+      before.push_back(at);
+      return true;
+    });
+  }
+
+  //EFFECTS: Returns the number of matches.
+  int count() const {
+    return before.size() + after.size();
+  }
+
+  //REQUIRES: 0 <= k < count()
+  //EFFECTS:  Returns the index in the text of match k, counting from 0.
+  int position(int k) const;
+
+  //EFFECTS: Returns the number of matches that start before index, which
+  //         is also the number k of the first match at or after it.
+  int count_before(int index) const;
+
+private:
+  std::shared_ptr<const Search> searched;   // the search, or nullptr
+  std::vector<int> before;    // indices of the matches before the gap
+  std::vector<int> after;     // distances from the end of the text of
+                              // the matches after the gap, the last one
+                              // first
+  int length;                 // length of the text
+
+  //EFFECTS: Returns the length of every match, or 1 for a search whose
+  //         matches vary in length, as a regular expression's do, which
+  //         apply() then only drops when an edit removes their first
+  //         character.
+  int size() const {
+    int match_length = searched->match_length();
+    return match_length < 0 ? 1 : match_length;
+  }
+
+  //REQUIRES: 0 <= index <= length
+  //MODIFIES: *this
+  //EFFECTS:  Moves the gap to index: the matches that start before it
+  //          end up in before, the rest in after.
+  void move_gap(int index);
+
+  //MODIFIES: *this, begin, end
+  //EFFECTS:  Applies changes to the matches and the length, dropping the
+  //          matches they broke, and sets [begin, end) to a range of the
+  //          new text that holds every match they may have made.
+  void apply(const std::vector<TextChange> &changes, int &begin, int &end);
+};
+
+#endif // MATCHINDEX_HPP
@@ -0,0 +1,143 @@
+#include "MatchIndex.hpp"
+#include "Regex.hpp"
+#include "unit_test_framework.hpp"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// EFFECTS: returns the indices of every match of pattern in text
+static vector<int> all_matches(const string &text, const string &pattern) {
+    vector<int> matches;
+    for (size_t at = text.find(pattern); at != string::npos;
+         at = text.find(pattern, at + 1)) {
+        matches.push_back(at);
+    }
+    return matches;
+}
+
+// EFFECTS: returns the matches in index, in order
+static vector<int> indexed(const MatchIndex &index) {
+    vector<int> matches;
+    for (int k = 0; k < index.count(); ++k) {
+        matches.push_back(index.position(k));
+    }
+    return matches;
+}
+
+TEST(test_rebuild_and_lookup) {
+    TextBuffer buffer;
+    buffer.insert("abab aba\nbab");
+    MatchIndex index;
+    ASSERT_EQUAL(index.pattern(), "");
+    ASSERT_EQUAL(index.count(), 0);
+    index.rebuild("aba", buffer);
+    ASSERT_EQUAL(index.pattern(), "aba");
+    ASSERT_TRUE(indexed(index) == vector<int>({0, 5}));
+    index.rebuild("ab", buffer);
+    ASSERT_TRUE(indexed(index) == vector<int>({0, 2, 5, 10}));
+    ASSERT_EQUAL(index.count_before(0), 0);
+    ASSERT_EQUAL(index.count_before(1), 1);
+    ASSERT_EQUAL(index.count_before(5), 2);
+    ASSERT_EQUAL(index.count_before(6), 3);
+    ASSERT_EQUAL(index.count_before(buffer.size()), 4);
+
+    index.clear();
+    ASSERT_EQUAL(index.search(), nullptr);
+    ASSERT_EQUAL(index.count(), 0);
+    buffer.insert("ab");
+    index.update(buffer.changes(), buffer);   // nothing to keep up to date
+    ASSERT_EQUAL(index.count(), 0);
+}
+
+TEST(test_update_after_edits) {
+    TextBuffer buffer;
+    buffer.insert("one two\nthree two\n");
+    buffer.clear_changes();
+    MatchIndex index;
+    index.rebuild("two", buffer);
+    ASSERT_TRUE(indexed(index) == vector<int>({4, 14}));
+
+    buffer.seek(2, 0);
+    buffer.insert("two ");              // a new match shifts the one after
+    buffer.seek(1, 5);
+    buffer.remove();                    // breaks "two" in row 1
+    index.update(buffer.changes(), buffer);
+    buffer.clear_changes();
+    ASSERT_EQUAL(buffer.stringify(), "one to\ntwo three two\n");
+    ASSERT_TRUE(indexed(index) == vector<int>({7, 17}));
+
+    buffer.seek(1, 5);
+    buffer.insert('w');                 // mends it
+    index.update(buffer.changes(), buffer);
+    buffer.clear_changes();
+    ASSERT_TRUE(indexed(index) == vector<int>({4, 8, 18}));
+    ASSERT_EQUAL(index.count_before(5), 1);
+    ASSERT_EQUAL(index.count_before(19), 3);
+
+    buffer.assign(string("two"));       // the log collapses into one entry
+    index.update(buffer.changes(), buffer);
+    buffer.clear_changes();
+    ASSERT_TRUE(indexed(index) == vector<int>({0}));
+}
+
+TEST(test_random_edits_agree_with_rescans) {
+    mt19937 gen(280);
+    TextBuffer buffer;
+    buffer.insert(string(300, 'a'));
+    buffer.clear_changes();
+    for (const string pattern : {"a", "aba", "abba", "b\nb"}) {
+        MatchIndex index;
+        index.rebuild(pattern, buffer);
+        for (int round = 0; round < 200; ++round) {
+            // a few edits between updates, like the keys of one frame
+            int edits = 1 + gen() % 3;
+            for (int edit = 0; edit < edits; ++edit) {
+                buffer.seek_index(gen() % (buffer.size() + 1));
+                if (gen() % 2 == 0) {
+                    buffer.insert(string(1 + gen() % 4, "ab\n"[gen() % 3]));
+                } else {
+                    buffer.remove(gen() % 5);
+                }
+            }
+            index.update(buffer.changes(), buffer);
+            buffer.clear_changes();
+            ASSERT_TRUE(indexed(index)
+                        == all_matches(buffer.stringify(), pattern));
+        }
+    }
+}
+
+TEST(test_regex_updates_agree_with_rescans) {
+    mt19937 gen(280);
+    TextBuffer buffer;
+    buffer.insert(string(300, 'a'));
+    buffer.clear_changes();
+    for (const string pattern : {"a+b", "^b", "ba*$", "b(ab)*a", "^a*b$"}) {
+        auto search = make_shared<RegexSearch>(pattern);
+        MatchIndex index;
+        index.rebuild(search, buffer);
+        ASSERT_EQUAL(index.search(), search.get());
+        for (int round = 0; round < 200; ++round) {
+            int edits = 1 + gen() % 3;
+            for (int edit = 0; edit < edits; ++edit) {
+                buffer.seek_index(gen() % (buffer.size() + 1));
+                if (gen() % 2 == 0) {
+                    buffer.insert(string(1 + gen() % 4, "ab\n"[gen() % 3]));
+                } else {
+                    buffer.remove(gen() % 5);
+                }
+            }
+            index.update(buffer.changes(), buffer);
+            buffer.clear_changes();
+            MatchIndex rescan;
+            rescan.rebuild(search, buffer);
+            ASSERT_TRUE(indexed(index) == indexed(rescan));
+        }
+    }
+}
+
+TEST_MAIN()
@@ -0,0 +1,490 @@
+#ifndef PIECETABLE_HPP
+#define PIECETABLE_HPP
+/* PieceTable.hpp
+ *
+ * piece table with the same interface as List
+ * EECS 280 Project 4
+ */
+
+#include <algorithm>   //std::copy, std::min
+#include <iterator>    //std::bidirectional_iterator_tag, std::iterator_traits
+#include <cassert>     //assert
+#include <cstddef>     //std::size_t
+#include <memory>      //std::shared_ptr
+#include <string>      //std::basic_string
+#include <string_view> //std::basic_string_view
+#include <type_traits> //std::is_base_of
+#include <utility>     //std::move
+#include <vector>
+
+
+template <typename T>
+class PieceTable {
+  //OVERVIEW: a sequence described by "pieces" that each refer to a run of
+  //          elements in one of two buffers: the immutable original
+  //          contents handed to assign(), and an append-only buffer that
+  //          receives every inserted element. Loading contents is a
+  //          single move, memory stays close to the size of the original
+  //          plus what was typed, and erasing only trims or splits
+  //          pieces. The original may live outside the table (e.g. in a
+  //          memory-mapped file), since it is only ever read. The add
+  //          buffer is kept in blocks of ADD_BLOCK elements that never
+  //          move, and a table never writes to a block that a copy also
+  //          holds, so copies share both buffers: copying only takes
+  //          O(pieces + blocks), and a copy can be read on one thread
+  //          while the table is edited on another. Same interface as
+  //          List.
+  //NOTE:     insert() and erase() may invalidate every iterator into the
+  //          table; use the returned iterator.
+  //          The pieces are kept in a vector, so an edit in the middle
+  //          moves the pieces after it, and at() walks the pieces from
+  //          the one it found last, the first, or the end, whichever is
+  //          closest by index. Both take O(pieces) at worst, so a table
+  //          slows down as scattered edits split it into more pieces.
+
+  struct Piece {
+    bool in_add;        // true if the run lives in add, false for original
+    std::size_t start;  // offset of the first element in its buffer
+    std::size_t length; // number of elements, always > 0
+  };
+
+public:
+  // Elements in each block of the add buffer.
+  static const std::size_t ADD_BLOCK = 64 * 1024;
+
+  // default ctor
+  PieceTable() : add_size(0), total(0), found_piece(0), found_start(0) {}
+
+  //EFFECTS: replaces the contents with text, which becomes the original
+  //         buffer without being copied
+  void assign(std::basic_string<T> text) {
+    auto kept = std::make_shared<const std::basic_string<T>>(std::move(text));
+    assign(*kept, kept);
+  }
+
+  //REQUIRES: the elements of text stay valid and unchanged as long as
+  //          owner_in is alive
+  //EFFECTS: replaces the contents with text, which becomes the original
+  //         buffer in place: the table keeps owner_in alive and never
+  //         copies or writes to text
+  void assign(std::basic_string_view<T> text,
+              std::shared_ptr<const void> owner_in) {
+    owner = std::move(owner_in);
+    original = text;
+    add.clear();
+    add_size = 0;
+    pieces.clear();
+    found_piece = found_start = 0;
+    total = original.size();
+    if (total != 0) {
+      pieces.push_back(Piece{false, 0, total});
+    }
+  }
+
+  //EFFECTS:  returns true if the table is empty
+  bool empty() const {
+    return total == 0;
+  }
+
+  //EFFECTS: returns the number of elements in this table
+  int size() const {
+    return static_cast<int>(total);
+  }
+
+  //EFFECTS: returns the number of pieces describing the contents
+  int piece_count() const {
+    return static_cast<int>(pieces.size());
+  }
+
+  //REQUIRES: table is not empty
+  //EFFECTS: Returns the first element by reference
+  T & front() {
+    return *begin();
+  }
+
+  //REQUIRES: table is not empty
+  //EFFECTS: Returns the last element by reference
+  T & back() {
+    return *--end();
+  }
+
+  //EFFECTS:  inserts datum into the front of the table
+  void push_front(const T &datum) {
+    insert(begin(), datum);
+  }
+
+  //EFFECTS:  inserts datum into the back of the table
+  void push_back(const T &datum) {
+    insert(end(), datum);
+  }
+
+  //REQUIRES: table is not empty
+  //EFFECTS:  removes the item at the front of the table
+  void pop_front() {
+    assert(!empty());
+    erase(begin());
+  }
+
+  //REQUIRES: table is not empty
+  //EFFECTS:  removes the item at the back of the table
+  void pop_back() {
+    assert(!empty());
+    erase(--end());
+  }
+
+  //EFFECTS:  removes all items from the table
+  void clear() {
+    assign(std::basic_string_view<T>(), nullptr);
+  }
+
+  //EFFECTS: copies the contents into a contiguous string, one block copy
+  //         per piece (or per block of the add buffer it spans)
+  std::basic_string<T> str() const {
+    std::basic_string<T> result;
+    result.reserve(total);
+    for_each_chunk(0, size(), [&result](const T *chunk, int count) {
+      result.append(chunk, count);
+      return true;
+    });
+    return result;
+  }
+
+  ////////////////////////////////////////
+  class Iterator {
+    //OVERVIEW: Iterator interface to PieceTable
+  public:
+    Iterator() : table_ptr(nullptr), piece(0), offset(0) {}
+
+    T & operator*() const {
+      assert(table_ptr != nullptr);
+      assert(piece < table_ptr->pieces.size());
+      const Piece &p = table_ptr->pieces[piece];
+      // elements are never modified in place by the table itself
+      return const_cast<T &>(table_ptr->element(p, offset));
+    }
+
+    T * operator->() const {
+      return &operator*();
+    }
+
+    Iterator & operator++() {
+      assert(table_ptr);
+      assert(piece < table_ptr->pieces.size());
+      if (++offset == table_ptr->pieces[piece].length) {
+        ++piece;
+        offset = 0;
+      }
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      operator++();
+      return copy;
+    }
+
+    Iterator & operator--() {
+      assert(table_ptr);
+      assert(*this != table_ptr->begin());
+      if (offset == 0) {
+        --piece;
+        offset = table_ptr->pieces[piece].length - 1;
+      } else {
+        --offset;
+      }
+      return *this;
+    }
+
+    Iterator operator--(int) {
+      Iterator copy = *this;
+      operator--();
+      return copy;
+    }
+
+    bool operator==(const Iterator &rhs) const {
+      return table_ptr == rhs.table_ptr && piece == rhs.piece
+        && offset == rhs.offset;
+    }
+
+    bool operator!=(const Iterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+    // Type aliases required to work with STL algorithms.
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+  private:
+    const PieceTable *table_ptr;
+    std::size_t piece;  // index into pieces; pieces.size() at the end
+    std::size_t offset; // index within the piece, 0 at the end
+
+    friend class PieceTable;
+
+    Iterator(const PieceTable *tp, std::size_t pc, std::size_t off)
+      : table_ptr(tp), piece(pc), offset(off) {}
+  };//PieceTable::Iterator
+  ////////////////////////////////////////
+
+  // return an Iterator pointing to the first element
+  Iterator begin() const {
+    return Iterator(this, 0, 0);
+  }
+
+  // return an Iterator pointing to "past the end"
+  Iterator end() const {
+    return Iterator(this, pieces.size(), 0);
+  }
+
+  //REQUIRES: 0 <= index <= size()
+  //EFFECTS: returns an Iterator to the element at index, skipping whole
+  //         pieces from the piece found last, the first, or the end,
+  //         whichever is closest
+  Iterator at(int index) const {
+    assert(0 <= index && index <= size());
+    std::size_t target = static_cast<std::size_t>(index);
+    std::size_t piece = 0;
+    std::size_t start = 0;    // index of the first element of piece
+    std::size_t nearest = target;
+    std::size_t from_found = found_start < target ? target - found_start
+                                                  : found_start - target;
+    if (from_found < nearest) {
+      piece = found_piece;
+      start = found_start;
+      nearest = from_found;
+    }
+    if (total - target < nearest) {
+      piece = pieces.size();
+      start = total;
+    }
+    while (start > target) {
+      --piece;
+      start -= pieces[piece].length;
+    }
+    for (; piece < pieces.size() && target - start >= pieces[piece].length;
+         ++piece) {
+      start += pieces[piece].length;
+    }
+    found_piece = piece;
+    found_start = start;
+    return Iterator(this, piece, target - start);
+  }
+
+  //REQUIRES: 0 <= begin <= end <= size()
+  //EFFECTS: calls visit(pointer, count) with the elements in [begin, end)
+  //         in place, one block per piece (or per block of the add buffer
+  //         it spans). visit returns whether to go on to the next block.
+  template <typename Visitor>
+  void for_each_chunk(int begin, int end, Visitor visit) const {
+    assert(0 <= begin && begin <= end && end <= size());
+    std::size_t remaining = static_cast<std::size_t>(end - begin);
+    Iterator i = at(begin);
+    for (std::size_t piece = i.piece; remaining > 0; ++piece) {
+      const Piece &p = pieces[piece];
+      std::size_t offset = i.offset;
+      std::size_t stop = std::min(p.length, offset + remaining);
+      remaining -= stop - offset;
+      while (offset < stop) {
+        std::size_t count = stop - offset;
+        if (p.in_add) {
+          // runs in the add buffer end where their block does
+          std::size_t at = p.start + offset;
+          count = std::min(count, ADD_BLOCK - at % ADD_BLOCK);
+        }
+        if (!visit(&element(p, offset), static_cast<int>(count))) {
+          return;
+        }
+        offset += count;
+      }
+      i.offset = 0;
+    }
+  }
+
+  //REQUIRES: i is a valid, dereferenceable iterator associated with this
+  //          table
+  //EFFECTS: Removes a single element from the table.
+  //         Returns An iterator pointing to the element that followed the
+  //         element erased by the function call
+  Iterator erase(Iterator i) {
+    assert(i.table_ptr == this);
+    assert(i.piece < pieces.size());
+    edited(i.piece);
+    Piece &p = pieces[i.piece];
+    --total;
+    if (p.length == 1) {
+      pieces.erase(pieces.begin() + i.piece);
+      return Iterator(this, i.piece, 0);
+    } else if (i.offset == 0) {
+      ++p.start;
+      --p.length;
+      return i;
+    } else if (i.offset == p.length - 1) {
+      --p.length;
+      return Iterator(this, i.piece + 1, 0);
+    }
+    // erasing from the middle splits the piece in two
+    Piece right{p.in_add, p.start + i.offset + 1, p.length - i.offset - 1};
+    p.length = i.offset;
+    pieces.insert(pieces.begin() + i.piece + 1, right);
+    return Iterator(this, i.piece + 1, 0);
+  }
+
+  //REQUIRES: i is a valid iterator associated with this table
+  //EFFECTS: Inserts datum before the element at the specified position.
+  //         Returns an iterator to the the newly inserted element.
+  Iterator insert(Iterator i, const T &datum) {
+    assert(i.table_ptr == this);
+    std::size_t piece = i.piece;
+    edited(piece > 0 ? piece - 1 : 0);
+    std::size_t start = append(&datum, &datum + 1);
+    ++total;
+    if (i.offset == 0 && piece > 0) {
+      // typing right after the last thing typed just extends that piece
+      Piece &prev = pieces[piece - 1];
+      if (prev.in_add && prev.start + prev.length == start) {
+        ++prev.length;
+        return Iterator(this, piece - 1, prev.length - 1);
+      }
+    }
+    // inserting inside a piece splits it around the new one
+    piece = split_at(i);
+    pieces.insert(pieces.begin() + piece, Piece{true, start, 1});
+    return Iterator(this, piece, 0);
+  }
+
+  //REQUIRES: i is a valid iterator associated with this table
+  //EFFECTS: Inserts copies of the elements in [range_begin, range_end)
+  //         before the element at the specified position. They are
+  //         appended to the add buffer as one run and described by a
+  //         single piece (or extend the previous one). Returns an
+  //         iterator to the first inserted element, or i if the range is
+  //         empty.
+  template <typename InputIterator>
+  Iterator insert(Iterator i, InputIterator range_begin,
+                  InputIterator range_end) {
+    assert(i.table_ptr == this);
+    edited(i.piece > 0 ? i.piece - 1 : 0);
+    std::size_t start = append(range_begin, range_end);
+    std::size_t n = add_size - start;
+    if (n == 0) {
+      return i;
+    }
+    total += n;
+    if (i.offset == 0 && i.piece > 0) {
+      Piece &prev = pieces[i.piece - 1];
+      if (prev.in_add && prev.start + prev.length == start) {
+        prev.length += n;
+        return Iterator(this, i.piece - 1, prev.length - n);
+      }
+    }
+    std::size_t piece = split_at(i);
+    pieces.insert(pieces.begin() + piece, Piece{true, start, n});
+    return Iterator(this, piece, 0);
+  }
+
+  //REQUIRES: [range_begin, range_end) is a valid range of iterators
+  //          associated with this table
+  //EFFECTS: Removes the elements in [range_begin, range_end), splitting
+  //         at most the two pieces at its ends and dropping the pieces in
+  //         between. Returns an iterator to the element that followed the
+  //         last one erased.
+  Iterator erase(Iterator range_begin, Iterator range_end) {
+    assert(range_begin.table_ptr == this && range_end.table_ptr == this);
+    if (range_begin == range_end) {
+      return range_end;
+    }
+    edited(range_begin.piece);
+    // split at the end first so that range_begin still refers to the
+    // same element afterwards
+    std::size_t stop = split_at(range_end);
+    std::size_t start = split_at(range_begin);
+    if (range_begin.offset != 0) {
+      ++stop;
+    }
+    for (std::size_t p = start; p < stop; ++p) {
+      total -= pieces[p].length;
+    }
+    pieces.erase(pieces.begin() + start, pieces.begin() + stop);
+    return Iterator(this, start, 0);
+  }
+
+private:
+  std::shared_ptr<const void> owner;  // keeps the original's elements alive
+  std::basic_string_view<T> original; // contents given to assign(), never
+                                      // edited
+  std::vector<std::shared_ptr<T[]>> add; // every inserted element, in
+                                      // blocks of ADD_BLOCK; append only
+  std::size_t add_size;               // offset of the next element in add
+  std::vector<Piece> pieces;          // the contents, in order
+  std::size_t total;                  // sum of all piece lengths
+  mutable std::size_t found_piece;    // the piece at() found last
+  mutable std::size_t found_start;    // index of its first element
+
+  //EFFECTS: forgets the piece at() found last if an edit of pieces from
+  //         index piece on may have moved it
+  void edited(std::size_t piece) {
+    if (found_piece >= piece) {
+      found_piece = found_start = 0;
+    }
+  }
+
+  //EFFECTS: appends the elements in [range_begin, range_end) to add and
+  //         returns the offset of the first one. The rest of a block
+  //         that a copy of the table also holds is skipped, so that
+  //         nothing the copy can read is ever written.
+  template <typename InputIterator>
+  std::size_t append(InputIterator range_begin, InputIterator range_end) {
+    using category =
+      typename std::iterator_traits<InputIterator>::iterator_category;
+    if (add_size % ADD_BLOCK != 0 && add.back().use_count() > 1) {
+      add_size += ADD_BLOCK - add_size % ADD_BLOCK;
+    }
+    std::size_t start = add_size;
+    while (range_begin != range_end) {
+      std::size_t offset = add_size % ADD_BLOCK;
+      if (offset == 0) {
+        add.emplace_back(new T[ADD_BLOCK]);
+      }
+      T *slot = add.back().get() + offset;
+      if constexpr (std::is_base_of<std::random_access_iterator_tag,
+                                    category>::value) {
+        // copy as much as fits in the block at once
+        std::size_t n = std::min<std::size_t>(ADD_BLOCK - offset,
+                                              range_end - range_begin);
+        std::copy(range_begin, range_begin + n, slot);
+        range_begin += n;
+        add_size += n;
+      } else {
+        *slot = *range_begin;
+        ++range_begin;
+        ++add_size;
+      }
+    }
+    return start;
+  }
+
+  //REQUIRES: i is a valid iterator associated with this table
+  //EFFECTS: splits the piece i points into, if needed, so that a piece
+  //         starts at i, and returns the index of that piece
+  std::size_t split_at(Iterator i) {
+    if (i.offset == 0) {
+      return i.piece;
+    }
+    Piece &p = pieces[i.piece];
+    Piece right{p.in_add, p.start + i.offset, p.length - i.offset};
+    p.length = i.offset;
+    pieces.insert(pieces.begin() + i.piece + 1, right);
+    return i.piece + 1;
+  }
+
+  //EFFECTS: returns the element at offset within piece p
+  const T & element(const Piece &p, std::size_t offset) const {
+    std::size_t at = p.start + offset;
+    return p.in_add ? add[at / ADD_BLOCK][at % ADD_BLOCK] : original[at];
+  }
+};//PieceTable
+
+#endif // PIECETABLE_HPP
@@ -0,0 +1,248 @@
+#include "PieceTable.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// EFFECTS: returns the contents of table, walking forward by Iterator
+static string forward_contents(const PieceTable<char> &table) {
+    return string(table.begin(), table.end());
+}
+
+// EFFECTS: returns the contents of table, walking backward by Iterator
+static string backward_contents(const PieceTable<char> &table) {
+    string result;
+    for (PieceTable<char>::Iterator it = table.end(); it != table.begin();) {
+        --it;
+        result.insert(result.begin(), *it);
+    }
+    return result;
+}
+
+TEST(test_default_ctor) {
+    PieceTable<char> table;
+    ASSERT_TRUE(table.empty());
+    ASSERT_EQUAL(table.size(), 0);
+    ASSERT_TRUE(table.begin() == table.end());
+    ASSERT_EQUAL(table.str(), "");
+}
+
+TEST(test_assign_is_one_piece) {
+    PieceTable<char> table;
+    table.assign("hello\nworld\n");
+    ASSERT_EQUAL(table.size(), 12);
+    ASSERT_EQUAL(table.piece_count(), 1);
+    ASSERT_EQUAL(table.front(), 'h');
+    ASSERT_EQUAL(table.back(), '\n');
+    ASSERT_EQUAL(forward_contents(table), "hello\nworld\n");
+    ASSERT_EQUAL(backward_contents(table), "hello\nworld\n");
+}
+
+TEST(test_assign_in_place_keeps_owner) {
+    auto owner = make_shared<string>("read only\n");
+    const char *elements = owner->data();
+    PieceTable<char> table;
+    table.assign(string_view(*owner), owner);
+    owner.reset();                  // the table keeps the string alive
+    ASSERT_EQUAL(&table.front(), elements);
+    PieceTable<char> copy = table;  // copies share the original
+    ASSERT_EQUAL(&copy.front(), elements);
+    table.insert(table.at(4), '-');
+    table.erase(table.at(5));
+    ASSERT_EQUAL(table.str(), "read-only\n");
+    ASSERT_EQUAL(copy.str(), "read only\n");
+    table.clear();
+    ASSERT_EQUAL(copy.str(), "read only\n");
+}
+
+TEST(test_typing_extends_one_piece) {
+    PieceTable<char> table;
+    table.assign("abef");
+    PieceTable<char>::Iterator it = table.begin();
+    ++it;
+    ++it;
+    for (char c = 'A'; c <= 'D'; ++c) {
+        it = table.insert(it, c);
+        ASSERT_EQUAL(*it, c);
+        ++it;
+        ASSERT_EQUAL(*it, 'e');
+    }
+    ASSERT_EQUAL(table.str(), "abABCDef");
+    // original split around a single piece of typed text
+    ASSERT_EQUAL(table.piece_count(), 3);
+}
+
+TEST(test_backspace_and_delete_trim_pieces) {
+    PieceTable<char> table;
+    table.assign("0123456789");
+    PieceTable<char>::Iterator it = table.begin();
+    for (int i = 0; i < 5; ++i) {
+        ++it;
+    }
+    it = table.erase(it); // delete '5' splits the piece
+    ASSERT_EQUAL(*it, '6');
+    it = table.erase(it); // delete '6' trims the right piece
+    ASSERT_EQUAL(*it, '7');
+    --it;
+    it = table.erase(it); // backspace '4' trims the left piece
+    ASSERT_EQUAL(*it, '7');
+    ASSERT_EQUAL(table.str(), "0123789");
+    ASSERT_EQUAL(table.piece_count(), 2);
+    ASSERT_EQUAL(backward_contents(table), "0123789");
+}
+
+TEST(test_at) {
+    PieceTable<char> table;
+    table.assign("hello world");
+    table.insert(table.at(5), ',');
+    table.erase(table.at(7));
+    string expected = "hello, orld";
+    ASSERT_EQUAL(table.piece_count(), 4);
+    for (int i = 0; i < table.size(); ++i) {
+        ASSERT_EQUAL(*table.at(i), expected[i]);
+    }
+    ASSERT_TRUE(table.at(table.size()) == table.end());
+}
+
+TEST(test_at_after_edits_before_the_piece_found) {
+    PieceTable<char> table;
+    table.assign("0123456789");
+    string reference = "0123456789";
+    for (int pos : {8, 6, 4, 2}) {  // one piece per character typed
+        table.insert(table.at(pos), 'x');
+        reference.insert(pos, 1, 'x');
+    }
+    ASSERT_EQUAL(*table.at(11), reference[11]);
+    table.erase(table.at(1));       // moves the piece found last
+    reference.erase(1, 1);
+    table.insert(table.at(0), 'y');
+    reference.insert(0, 1, 'y');
+    for (int i = 0; i < static_cast<int>(reference.size()); ++i) {
+        ASSERT_EQUAL(*table.at(i), reference[i]);
+    }
+    for (int i = static_cast<int>(reference.size()) - 1; i >= 0; --i) {
+        ASSERT_EQUAL(*table.at(i), reference[i]);
+    }
+    ASSERT_TRUE(table.at(table.size()) == table.end());
+}
+
+TEST(test_push_pop_and_clear) {
+    PieceTable<char> table;
+    for (char c = 'a'; c <= 'e'; ++c) {
+        table.push_back(c);
+    }
+    table.push_front('0');
+    table.pop_back();
+    table.pop_front();
+    ASSERT_EQUAL(table.str(), "abcd");
+    table.clear();
+    ASSERT_TRUE(table.empty());
+    ASSERT_EQUAL(table.piece_count(), 0);
+}
+
+TEST(test_random_edits_match_std_list) {
+    srand(280);
+    PieceTable<char> table;
+    string initial = "The quick brown fox\njumps over\nthe lazy dog\n";
+    table.assign(initial);
+    std::list<char> reference(initial.begin(), initial.end());
+    PieceTable<char>::Iterator it = table.begin();
+    std::list<char>::iterator ref_it = reference.begin();
+    for (int step = 0; step < 20000; ++step) {
+        int op = rand() % 4;
+        if (op == 0 && ref_it != reference.end()) {
+            it = table.erase(it);
+            ref_it = reference.erase(ref_it);
+        } else if (op == 1) {
+            char c = static_cast<char>('a' + rand() % 26);
+            it = table.insert(it, c);
+            ref_it = reference.insert(ref_it, c);
+        } else if (op == 2 && ref_it != reference.end()) {
+            ++it;
+            ++ref_it;
+        } else if (op == 3 && ref_it != reference.begin()) {
+            --it;
+            --ref_it;
+        }
+        ASSERT_EQUAL(table.size(), static_cast<int>(reference.size()));
+        ASSERT_EQUAL(it == table.end(), ref_it == reference.end());
+        if (ref_it != reference.end()) {
+            ASSERT_EQUAL(*it, *ref_it);
+        }
+    }
+    string expected(reference.begin(), reference.end());
+    ASSERT_EQUAL(table.str(), expected);
+    ASSERT_EQUAL(backward_contents(table), expected);
+}
+
+TEST(test_paste_is_one_piece) {
+    PieceTable<char> table;
+    table.assign("ad");
+    string paste(100000, 'x');
+    PieceTable<char>::Iterator it = table.insert(table.at(1), paste.begin(),
+                                                 paste.end());
+    ASSERT_EQUAL(*it, 'x');
+    ASSERT_EQUAL(table.size(), 100002);
+    ASSERT_EQUAL(table.piece_count(), 3);
+    it = table.erase(table.at(1), table.at(100001));
+    ASSERT_EQUAL(*it, 'd');
+    ASSERT_EQUAL(table.str(), "ad");
+    ASSERT_EQUAL(table.piece_count(), 2);
+}
+
+TEST(test_copies_share_the_add_buffer) {
+    PieceTable<char> table;
+    table.assign("ab");
+    string typed = "xyz";
+    table.insert(table.at(1), typed.begin(), typed.end());
+    PieceTable<char> copy = table;
+    ASSERT_EQUAL(&*copy.at(1), &*table.at(1));
+    // typing goes on in a block of its own, not after "xyz"
+    table.insert(table.at(4), '!');
+    ASSERT_EQUAL(table.piece_count(), 4);
+    copy.insert(copy.at(4), '?');
+    ASSERT_EQUAL(table.str(), "axyz!b");
+    ASSERT_EQUAL(copy.str(), "axyz?b");
+    table.clear();
+    ASSERT_EQUAL(copy.str(), "axyz?b");
+}
+
+TEST(test_random_range_edits_match_std_list) {
+    srand(281);
+    PieceTable<char> table;
+    string initial = "The quick brown fox\njumps over\nthe lazy dog\n";
+    table.assign(initial);
+    std::list<char> reference(initial.begin(), initial.end());
+    for (int step = 0; step < 2000; ++step) {
+        int size = static_cast<int>(reference.size());
+        int pos = rand() % (size + 1);
+        std::list<char>::iterator ref_it = reference.begin();
+        advance(ref_it, pos);
+        if (rand() % 2 == 0) {
+            string text(rand() % 12, static_cast<char>('a' + step % 26));
+            PieceTable<char>::Iterator it = table.insert(table.at(pos),
+                                                         text.begin(),
+                                                         text.end());
+            reference.insert(ref_it, text.begin(), text.end());
+            ASSERT_TRUE(it == table.at(pos) || text.empty());
+        } else {
+            int count = rand() % (size - pos + 1);
+            std::list<char>::iterator ref_last = ref_it;
+            advance(ref_last, count);
+            table.erase(table.at(pos), table.at(pos + count));
+            reference.erase(ref_it, ref_last);
+        }
+        ASSERT_EQUAL(table.size(), static_cast<int>(reference.size()));
+    }
+    string expected(reference.begin(), reference.end());
+    ASSERT_EQUAL(table.str(), expected);
+    ASSERT_EQUAL(forward_contents(table), expected);
+    ASSERT_EQUAL(backward_contents(table), expected);
+}
+
+TEST_MAIN()
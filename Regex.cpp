@@ -0,0 +1,736 @@
+/* Regex.cpp
+ *
+ * Compiles a regular expression to an NFA and searches text with a DFA
+ * built from it as it is needed.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include "Regex.hpp"
+
+// The most NFA states an expression may compile to, which {n,m} makes
+// easy to reach.
+static const std::size_t MAX_NODES = 100000;
+
+static const std::size_t NONE = std::string_view::npos;
+
+// After skipping ahead this many times, the forward DFA must have
+// skipped at least MIN_SKIP characters a time to go on doing it, as
+// memchr() costs more than stepping over a few characters.
+static const long MAX_SKIPS = 64;
+static const long MIN_SKIP = 16;
+
+// EFFECTS: Returns the last '\n' in [data, data + size), or nullptr if
+//          there is none. memrchr() is a GNU extension, so elsewhere the
+//          characters are read backward one by one.
+static const char *last_newline(const char *data, std::size_t size) {
+#ifdef __GLIBC__
+  return static_cast<const char *>(::memrchr(data, '\n', size));
+#else
+  std::size_t found = std::string_view(data, size).rfind('\n');
+  return found == NONE ? nullptr : data + found;
+#endif
+}
+
+// EFFECTS: Returns the class of the characters in [low, high].
+static std::bitset<256> range(unsigned char low, unsigned char high) {
+  std::bitset<256> characters;
+  for (int c = low; c <= high; ++c) {
+    characters.set(c);
+  }
+  return characters;
+}
+
+// A search through consecutive chunks of a text. The forward DFA reads
+// the chunks until a match ends; then the rest of that line is read
+// into a string, and its matches found there.
+struct RegexSearch::Scan {
+  // EFFECTS: Starts a search of text that begins at index position_in,
+  //          at the start of a line if starts_line_in, and ends a line
+  //          if ends_text_line_in, and reports matches to found_in.
+  Scan(const RegexSearch &search_in, int position_in, bool starts_line_in,
+       bool ends_text_line_in, const MatchVisitor &found_in)
+    : search(search_in), position(position_in), found(found_in),
+      ends_text_line(ends_text_line_in), line_start(position_in),
+      starts_line(starts_line_in), matched(false) {
+    state = search.forward.initial(starts_line);
+  }
+
+  // EFFECTS: Reports the matches in the lines that end in the next
+  //          chunk. Returns false once found does.
+  bool feed(std::string_view chunk) {
+    const char *data = chunk.data();
+    std::size_t size = chunk.size();
+    std::size_t next = 0;
+    std::size_t line_from = 0;    // where the line starts in chunk
+    while (next < size) {
+      if (matched) {
+        const char *newline = static_cast<const char *>(
+          std::memchr(data + next, '\n', size - next));
+        if (!newline) {
+          line.append(data + next, size - next);
+          break;
+        }
+        line.append(data + next, newline - data - next);
+        if (!report_line(true)) {
+          return false;
+        }
+        next = line_from = newline - data + 1;
+        start_line(position + next);
+        continue;
+      }
+      // most of the text goes through this loop, so the state and steps
+      // are kept in locals rather than reached through members
+      Dfa &forward = search.forward;
+      const int *steps = forward.steps();
+      int current = state;
+      int idle = skipping ? forward.idle_state() : -1;
+      for (; next < size; ++next) {
+        if (current == idle) {
+          // nothing can start a match before the next idle_exit()
+          const char *found = static_cast<const char *>(
+            std::memchr(data + next, forward.idle_exit(), size - next));
+          std::size_t stop = found ? found - data : size;
+          const char *newline = last_newline(data + next, stop - next);
+          if (newline) {
+            line_start = position + (newline - data) + 1;
+            starts_line = true;
+            line.clear();
+            line_from = newline - data + 1;
+          }
+          skipped += stop - next;
+          next = stop;
+          if (next == size) {
+            break;
+          } else if (++skips == MAX_SKIPS) {
+            // the character may be too common to be worth skipping to
+            skipping = skipped >= MAX_SKIPS * MIN_SKIP;
+            idle = skipping ? idle : -1;
+            skips = skipped = 0;
+          }
+        }
+        unsigned char c = data[next];
+        int step = steps[current * 256 + c];
+        if (step < 0) {
+          step = forward.step(current, c);
+          steps = forward.steps();
+          if (idle != -1) {
+            idle = forward.idle_state();
+          }
+        }
+        if (step & Dfa::MATCHED) {
+          matched = true;
+          break;
+        }
+        current = step >> 2;
+        if (step & Dfa::NEWLINE) {
+          line_start = position + next + 1;
+          starts_line = true;
+          line.clear();
+          line_from = next + 1;
+        }
+      }
+      state = current;
+      line.append(data + line_from, next - line_from);
+    }
+    position += size;
+    return true;
+  }
+
+  // EFFECTS: Reports the matches in the last line. Returns false if
+  //          found does.
+  bool finish() {
+    if (!matched && !search.forward.accepts_at_end(state, ends_text_line)) {
+      return true;
+    }
+    return report_line(ends_text_line);
+  }
+
+  // EFFECTS: Reports the matches in line, which ends a line if ends_line.
+  //          Returns false once found does.
+  bool report_line(bool ends_line) {
+    std::size_t from = 0;
+    while (true) {
+      std::pair<std::size_t, std::size_t> match
+        = search.find_in_line(line, from, starts_line, ends_line);
+      if (match.first == NONE) {
+        return true;
+      } else if (!found(line_start + match.first, match.second)) {
+        return false;
+      }
+      from = match.first + match.second;
+    }
+  }
+
+  // EFFECTS: Starts looking for matches again at index, the start of a
+  //          line.
+  void start_line(int index) {
+    line_start = index;
+    starts_line = true;
+    line.clear();
+    matched = false;
+    state = search.forward.initial(true);
+  }
+
+  const RegexSearch &search;
+  int position;             // index of the start of the next chunk
+  const MatchVisitor &found;
+  bool ends_text_line;      // whether the end of the text ends a line
+  int state;                // of the forward DFA
+  int line_start;           // index where line starts
+  bool starts_line;         // whether line starts a line of the text
+  std::string line;         // the line read so far, up to the chunk
+  bool matched;             // whether a match ends in line, which is
+                            // being read to its end
+  bool skipping = true;     // whether to skip to idle_exit()
+  long skips = 0;           // times it was skipped to lately
+  long skipped = 0;         // characters skipped those times
+};
+
+//EFFECTS: Compiles pattern_in, or throws SyntaxError if it is not a
+//         valid expression or it matches empty text.
+RegexSearch::RegexSearch(const std::string &pattern_in)
+  : Search(pattern_in), start(compile()), forward(nodes, start, true),
+    anchored(nodes, start, false) {}
+
+//EFFECTS: Calls found with the index and length of every match within
+//         [begin, end), in order, until it returns false.
+void RegexSearch::scan(const Reader &read, int size, int begin, int end,
+                       const MatchVisitor &found) const {
+  // ^ and $ depend on the characters just outside the range
+  bool starts_line = begin == 0;
+  if (!starts_line) {
+    read(begin - 1, begin, [&starts_line](std::string_view chunk) {
+      starts_line = chunk.back() == '\n';
+      return false;
+    });
+  }
+  bool ends_line = end == size;
+  if (!ends_line) {
+    read(end, end + 1, [&ends_line](std::string_view chunk) {
+      ends_line = chunk.front() == '\n';
+      return false;
+    });
+  }
+  Scan scan(*this, begin, starts_line, ends_line, found);
+  bool going = true;
+  read(begin, end, [&scan, &going](std::string_view chunk) {
+    return going = scan.feed(chunk);
+  });
+  if (going) {
+    scan.finish();
+  }
+}
+
+//EFFECTS: Returns whether the expression matches all of text.
+bool RegexSearch::matches(std::string_view text) const {
+  int state = anchored.initial(true);
+  for (char c : text) {
+    if (anchored.is_dead(state)) {
+      return false;
+    }
+    state = anchored.step(state, c) >> 2;
+  }
+  return anchored.accepts_at_end(state, true);
+}
+
+//EFFECTS: Returns the first match in line that starts at or after from,
+//         as its offset and length, or (npos, 0) if there is none. line
+//         is a whole line, or the end of one if it does not start_line,
+//         and ends a line if end_line.
+std::pair<std::size_t, std::size_t>
+RegexSearch::find_in_line(std::string_view line, std::size_t from,
+                          bool start_line, bool end_line) const {
+  // where the first match to end ends
+  int state = forward.initial(from == 0 && start_line);
+  std::size_t end = NONE;
+  for (std::size_t i = from; i < line.size(); ++i) {
+    int step = forward.step(state, line[i]);
+    if (step & Dfa::MATCHED) {
+      end = i;
+      break;
+    }
+    state = step >> 2;
+  }
+  if (end == NONE) {
+    if (!forward.accepts_at_end(state, end_line)) {
+      return {NONE, 0};
+    }
+    end = line.size();
+  }
+  // the match that starts first starts before that; the longest from
+  // there is the one found
+  for (std::size_t first = from; first < end; ++first) {
+    state = anchored.initial(first == 0 && start_line);
+    std::size_t last = first;
+    std::size_t i = first;
+    for (; i < line.size() && !anchored.is_dead(state); ++i) {
+      int step = anchored.step(state, line[i]);
+      if (step & Dfa::MATCHED) {
+        last = i;
+      }
+      state = step >> 2;
+    }
+    if (i == line.size() && anchored.accepts_at_end(state, end_line)) {
+      last = i;
+    }
+    if (last > first) {
+      return {first, last - first};
+    }
+  }
+  return {NONE, 0};
+}
+
+//MODIFIES: *this
+//EFFECTS:  Builds the NFA for the pattern and returns its first state.
+//          Throws SyntaxError if the pattern is bad.
+int RegexSearch::compile() {
+  std::size_t position = 0;
+  Fragment whole = parse_alternatives(position);
+  if (position < pattern().size()) {
+    throw SyntaxError{"unmatched )"};
+  }
+  patch(whole.holes, add(Node::MATCH));
+  // a match must read a character, whatever line it is in
+  std::vector<bool> seen(nodes.size());
+  std::vector<int> pending(1, whole.start);
+  while (!pending.empty()) {
+    int n = pending.back();
+    pending.pop_back();
+    if (seen[n]) {
+      continue;
+    }
+    seen[n] = true;
+    const Node &node = nodes[n];
+    if (node.kind == Node::MATCH) {
+      throw SyntaxError{"matches empty text"};
+    } else if (node.kind == Node::SPLIT) {
+      pending.push_back(node.out1);
+    }
+    if (node.kind != Node::CHARACTER) {
+      pending.push_back(node.out);
+    }
+  }
+  return whole.start;
+}
+
+//MODIFIES: *this
+//EFFECTS:  Adds node to the NFA and returns its number.
+int RegexSearch::add(Node::Kind kind, int out, int out1,
+                     const std::bitset<256> &characters) {
+  if (nodes.size() == MAX_NODES) {
+    throw SyntaxError{"expression too big"};
+  }
+  nodes.push_back({kind, characters, out, out1});
+  if (kind == Node::CHARACTER) {
+    nodes.back().characters.reset('\n');
+  }
+  return nodes.size() - 1;
+}
+
+//MODIFIES: *this
+//EFFECTS:  Connects the holes to node target.
+void RegexSearch::patch(const std::vector<int> &holes, int target) {
+  for (int hole : holes) {
+    Node &node = nodes[hole / 2];
+    (hole % 2 ? node.out1 : node.out) = target;
+  }
+}
+
+//MODIFIES: *this, position
+//EFFECTS:  Parses alternatives separated by |.
+RegexSearch::Fragment RegexSearch::parse_alternatives(std::size_t &position) {
+  Fragment fragment = parse_sequence(position);
+  while (position < pattern().size() && pattern()[position] == '|') {
+    ++position;
+    Fragment other = parse_sequence(position);
+    fragment.start = add(Node::SPLIT, fragment.start, other.start);
+    fragment.holes.insert(fragment.holes.end(), other.holes.begin(),
+                          other.holes.end());
+  }
+  return fragment;
+}
+
+//MODIFIES: *this, position
+//EFFECTS:  Parses repetitions one after another, up to a | or ), or
+//          none.
+RegexSearch::Fragment RegexSearch::parse_sequence(std::size_t &position) {
+  const std::string &source = pattern();
+  Fragment fragment;
+  fragment.start = -1;
+  while (position < source.size() && source[position] != '|'
+         && source[position] != ')') {
+    Fragment next = parse_repetition(position);
+    if (fragment.start == -1) {
+      fragment = std::move(next);
+    } else {
+      patch(fragment.holes, next.start);
+      fragment.holes = std::move(next.holes);
+    }
+  }
+  if (fragment.start == -1) {
+    fragment.start = add(Node::EMPTY);
+    fragment.holes.assign(1, 2 * fragment.start);
+  }
+  return fragment;
+}
+
+//MODIFIES: *this, position
+//EFFECTS:  Parses an atom and the repetition after it, if any.
+RegexSearch::Fragment RegexSearch::parse_repetition(std::size_t &position) {
+  const std::string &source = pattern();
+  std::size_t atom = position;
+  Fragment fragment = parse_atom(position);
+  if (position == source.size()) {
+    return fragment;
+  }
+  char c = source[position];
+  if (c == '*' || c == '+' || c == '?') {
+    ++position;
+    int split = add(Node::SPLIT, fragment.start);
+    if (c != '?') {
+      patch(fragment.holes, split);
+      fragment.holes.clear();
+    }
+    if (c != '+') {
+      fragment.start = split;
+    }
+    fragment.holes.push_back(2 * split + 1);
+  } else if (c == '{') {
+    // {low}, {low,}, or {low,high}, with high -1 for no limit
+    ++position;
+    auto count = [&source, &position]() {
+      if (position == source.size() || !std::isdigit(source[position])) {
+        throw SyntaxError{"bad count in {}"};
+      }
+      int n = 0;
+      while (position < source.size() && std::isdigit(source[position])) {
+        n = std::min(10 * n + (source[position++] - '0'), MAX_REPEAT + 1);
+      }
+      return n;
+    };
+    int low = count();
+    int high = low;
+    if (position < source.size() && source[position] == ',') {
+      ++position;
+      high = position < source.size() && source[position] == '}'
+             ? -1 : count();
+    }
+    if (position == source.size() || source[position] != '}') {
+      throw SyntaxError{"missing }"};
+    } else if (low > MAX_REPEAT || high > MAX_REPEAT) {
+      throw SyntaxError{"count in {} over " + std::to_string(MAX_REPEAT)};
+    } else if (high != -1 && high < low) {
+      throw SyntaxError{"bad range in {}"};
+    }
+    ++position;
+    // the atom is parsed again for each copy after the first
+    std::size_t end = position;
+    bool first = true;
+    auto copy = [&]() {
+      if (first) {
+        first = false;
+        return fragment;
+      }
+      std::size_t again = atom;
+      return parse_atom(again);
+    };
+    Fragment sequence;
+    sequence.start = -1;
+    auto append = [this, &sequence](Fragment next) {
+      if (sequence.start == -1) {
+        sequence = std::move(next);
+      } else {
+        patch(sequence.holes, next.start);
+        sequence.holes = std::move(next.holes);
+      }
+    };
+    for (int i = 0; i < low; ++i) {
+      append(copy());
+    }
+    for (int i = low; i < high || (high == -1 && i == low); ++i) {
+      // an optional copy, or one repeated any number of times
+      Fragment optional = copy();
+      int split = add(Node::SPLIT, optional.start);
+      if (high == -1) {
+        patch(optional.holes, split);
+        optional.holes.clear();
+      }
+      optional.start = split;
+      optional.holes.push_back(2 * split + 1);
+      append(std::move(optional));
+    }
+    if (sequence.start == -1) {
+      sequence.start = add(Node::EMPTY);
+      sequence.holes.assign(1, 2 * sequence.start);
+    }
+    fragment = std::move(sequence);
+    position = end;
+  } else {
+    return fragment;
+  }
+  if (position < source.size() && std::strchr("*+?{", source[position])) {
+    throw SyntaxError{std::string("nothing to repeat before ")
+                      + source[position]};
+  }
+  return fragment;
+}
+
+//MODIFIES: *this, position
+//EFFECTS:  Parses a character, class, anchor, or group.
+RegexSearch::Fragment RegexSearch::parse_atom(std::size_t &position) {
+  const std::string &source = pattern();
+  char c = source[position++];
+  int node;
+  switch (c) {
+  case '(': {
+    Fragment group = parse_alternatives(position);
+    if (position == source.size()) {
+      throw SyntaxError{"missing )"};
+    }
+    ++position;
+    return group;
+  }
+  case '*': case '+': case '?': case '{':
+    throw SyntaxError{std::string("nothing to repeat before ") + c};
+  case '^':
+    node = add(Node::LINE_START);
+    break;
+  case '$':
+    node = add(Node::LINE_END);
+    break;
+  case '.':
+    node = add(Node::CHARACTER, -1, -1, std::bitset<256>().set());
+    break;
+  case '[':
+    node = add(Node::CHARACTER, -1, -1, parse_class(position));
+    break;
+  case '\\':
+    node = add(Node::CHARACTER, -1, -1, parse_escape(position));
+    break;
+  default:
+    node = add(Node::CHARACTER, -1, -1,
+               std::bitset<256>().set(static_cast<unsigned char>(c)));
+  }
+  return {node, std::vector<int>(1, 2 * node)};
+}
+
+//MODIFIES: position
+//EFFECTS:  Parses a class of characters, after its [, and returns it.
+std::bitset<256> RegexSearch::parse_class(std::size_t &position) const {
+  const std::string &source = pattern();
+  bool negated = position < source.size() && source[position] == '^';
+  if (negated) {
+    ++position;
+  }
+  std::bitset<256> characters;
+  // a ] first in the class stands for itself
+  for (bool first = true; ; first = false) {
+    if (position == source.size()) {
+      throw SyntaxError{"missing ]"};
+    }
+    unsigned char low = source[position++];
+    if (low == ']' && !first) {
+      break;
+    } else if (low == '\\') {
+      characters |= parse_escape(position);
+    } else if (position + 1 < source.size() && source[position] == '-'
+               && source[position + 1] != ']') {
+      unsigned char high = source[position + 1];
+      if (high < low) {
+        throw SyntaxError{"bad range in []"};
+      }
+      characters |= range(low, high);
+      position += 2;
+    } else {
+      characters.set(low);
+    }
+  }
+  return negated ? ~characters : characters;
+}
+
+//MODIFIES: position
+//EFFECTS:  Parses the escape after a \ and returns the characters it
+//          stands for.
+std::bitset<256> RegexSearch::parse_escape(std::size_t &position) const {
+  const std::string &source = pattern();
+  if (position == source.size()) {
+    throw SyntaxError{"\\ at the end"};
+  }
+  unsigned char c = source[position++];
+  std::bitset<256> word = range('a', 'z') | range('A', 'Z')
+                          | range('0', '9');
+  word.set('_');
+  std::bitset<256> space;
+  for (unsigned char blank : {' ', '\t', '\r', '\f', '\v'}) {
+    space.set(blank);
+  }
+  switch (c) {
+  case 'd': return range('0', '9');
+  case 'D': return ~range('0', '9');
+  case 'w': return word;
+  case 'W': return ~word;
+  case 's': return space;
+  case 'S': return ~space;
+  case 't': return std::bitset<256>().set('\t');
+  }
+  if (std::isalnum(c)) {
+    throw SyntaxError{std::string("unknown escape \\")
+                      + static_cast<char>(c)};
+  }
+  return std::bitset<256>().set(c);
+}
+
+//EFFECTS: Creates a DFA with no states over nodes, whose matches start
+//         at start_in. An unanchored DFA looks for matches starting at
+//         every character; an anchored one only at the first.
+RegexSearch::Dfa::Dfa(const std::vector<Node> &nodes_in, int start_in,
+                      bool unanchored_in)
+  : nodes(nodes_in), start(start_in), unanchored(unanchored_in),
+    line_starts(false), idle(-1), exit(-1), marks(nodes_in.size()),
+    mark(0) {
+  for (const Node &node : nodes) {
+    line_starts = line_starts || node.kind == Node::LINE_START;
+  }
+  if (!unanchored || line_starts) {
+    return;
+  }
+  // the characters that can start a match; if there is only one, a
+  // search can skip to it with memchr()
+  std::vector<int> reached;
+  closure(State(), false, reached);
+  std::bitset<256> first;
+  for (int n : reached) {
+    first |= nodes[n].characters;
+  }
+  if (first.count() == 1) {
+    for (exit = 0; !first[exit]; ++exit) {}
+  }
+}
+
+//MODIFIES: *this
+//EFFECTS:  Returns the state at the start of the text, or of a line if
+//          line_start.
+int RegexSearch::Dfa::initial(bool line_start) {
+  State state(unanchored ? std::vector<int>() : std::vector<int>(1, start),
+              line_start && line_starts);
+  if (states.size() >= static_cast<std::size_t>(MAX_STATES)
+      && !numbers.count(state)) {
+    forget();
+  }
+  return number(state);
+}
+
+//MODIFIES: *this
+//EFFECTS:  Returns whether a match ends after state, at the end of the
+//          text, which is the end of a line if line_end.
+bool RegexSearch::Dfa::accepts_at_end(int state, bool line_end) {
+  std::vector<int> reached;
+  return closure(states[state], line_end, reached);
+}
+
+//MODIFIES: *this
+//EFFECTS:  Returns the number of state, adding it if it is new.
+int RegexSearch::Dfa::number(const State &state) {
+  auto found = numbers.find(state);
+  if (found != numbers.end()) {
+    return found->second;
+  }
+  if (unanchored && state.first.empty() && !state.second) {
+    idle = states.size();
+  }
+  states.push_back(state);
+  table.resize(table.size() + 256, -1);
+  numbers.emplace(state, states.size() - 1);
+  return states.size() - 1;
+}
+
+//MODIFIES: *this
+//EFFECTS:  Forgets every state and transition.
+void RegexSearch::Dfa::forget() {
+  states.clear();
+  numbers.clear();
+  table.clear();
+  idle = -1;
+}
+
+//MODIFIES: *this
+//EFFECTS:  Works out, records and returns step(state, c).
+int RegexSearch::Dfa::add_transition(int state, unsigned char c) {
+  State from = states[state];
+  std::vector<int> reached;
+  bool matched = closure(from, c == '\n', reached);
+  State to(std::vector<int>(), c == '\n' && line_starts);
+  for (int n : reached) {
+    if (nodes[n].characters[c]) {
+      to.first.push_back(nodes[n].out);
+    }
+  }
+  std::sort(to.first.begin(), to.first.end());
+  to.first.erase(std::unique(to.first.begin(), to.first.end()),
+                 to.first.end());
+  if (states.size() + 1 >= static_cast<std::size_t>(MAX_STATES)
+      && !numbers.count(to)) {
+    // start over from here
+    forget();
+    state = number(from);
+  }
+  int step = 4 * number(to) + (matched ? MATCHED : 0)
+             + (c == '\n' ? NEWLINE : 0);
+  table[state * 256 + c] = step;
+  return step;
+}
+
+//MODIFIES: *this, reached
+//EFFECTS:  Sets reached to the CHARACTER states reachable from state
+//          without reading a character, before a newline if line_end,
+//          and returns whether MATCH is reachable too.
+bool RegexSearch::Dfa::closure(const State &state, bool line_end,
+                               std::vector<int> &reached) {
+  reached.clear();
+  if (++mark == 0) {
+    std::fill(marks.begin(), marks.end(), 0);
+    mark = 1;
+  }
+  pending.assign(state.first.begin(), state.first.end());
+  if (unanchored) {
+    pending.push_back(start);
+  }
+  bool matched = false;
+  while (!pending.empty()) {
+    int n = pending.back();
+    pending.pop_back();
+    if (marks[n] == mark) {
+      continue;
+    }
+    marks[n] = mark;
+    const Node &node = nodes[n];
+    switch (node.kind) {
+    case Node::CHARACTER:
+      reached.push_back(n);
+      break;
+    case Node::MATCH:
+      matched = true;
+      break;
+    case Node::SPLIT:
+      pending.push_back(node.out1);
+      pending.push_back(node.out);
+      break;
+    case Node::LINE_START:
+      if (state.second) {
+        pending.push_back(node.out);
+      }
+      break;
+    case Node::LINE_END:
+      if (line_end) {
+        pending.push_back(node.out);
+      }
+      break;
+    case Node::EMPTY:
+      pending.push_back(node.out);
+      break;
+    }
+  }
+  return matched;
+}
@@ -0,0 +1,256 @@
+#ifndef REGEX_HPP
+#define REGEX_HPP
+/* Regex.hpp
+ *
+ * Finds a regular expression in a text buffer, streaming the buffer's
+ * chunks through a DFA that is built as the search goes.
+ */
+
+#include <bitset>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Search.hpp"
+
+class RegexSearch : public Search {
+  //OVERVIEW: A regular expression to look for, compiled to an NFA by
+  //          Thompson's construction. The search runs a DFA made from
+  //          the NFA lazily: a DFA state, a set of NFA states, is made
+  //          the first time the search gets to it, and each transition
+  //          is worked out the first time it is taken, then looked up in
+  //          a table. No character is read more than a bounded number of
+  //          times per match, so there is no backtracking blowup; if the
+  //          DFA grows past MAX_STATES states, it is thrown away and
+  //          built again from where the search is.
+  //
+  //          The syntax is a subset of POSIX extended expressions:
+  //            c        a character other than \ . [ ] ( ) | * + ? { } ^ $
+  //            .        any character
+  //            [abc]    a character in the class; [a-z] for a range,
+  //                     [^abc] for any character not in it
+  //            \d \w \s a digit, word character, or space, and \D \W \S
+  //                     for any other character; also inside classes
+  //            \t       a tab; \ before any other punctuation stands for
+  //                     that character
+  //            ^ $      the start and end of a line
+  //            ( )      grouping
+  //            |        either side
+  //            * + ?    zero or more, one or more, zero or one times
+  //            {n} {n,} {n,m}  n times, at least n, n to m times
+  //          Matches are never empty and never span lines: . and
+  //          classes do not match a newline. Of the matches in a text,
+  //          the one that starts first is found, and the longest one
+  //          that starts there (leftmost-longest, as in POSIX); the next
+  //          is looked for from where it ends.
+  //
+  //          The DFA lives in the search, so a search must not be used
+  //          by two threads at once.
+public:
+  // Thrown by the constructor with the reason an expression is bad.
+  struct SyntaxError {
+    std::string reason;
+  };
+
+  // The most DFA states kept at once, each with a table of 256
+  // transitions.
+  static const int MAX_STATES = 2048;
+
+  // The largest count in {n,m}.
+  static const int MAX_REPEAT = 1000;
+
+  //EFFECTS: Compiles pattern_in, or throws SyntaxError if it is not a
+  //         valid expression or it matches empty text.
+  explicit RegexSearch(const std::string &pattern_in);
+
+  RegexSearch(const RegexSearch &) = delete;
+  RegexSearch &operator=(const RegexSearch &) = delete;
+
+  bool is_regex() const override {
+    return true;
+  }
+
+  int match_length() const override {
+    return -1;
+  }
+
+  void scan(const Reader &read, int size, int begin, int end,
+            const MatchVisitor &found) const override;
+
+  //EFFECTS: Returns whether the expression matches all of text.
+  bool matches(std::string_view text) const;
+
+private:
+  // A state of the NFA.
+  struct Node {
+    enum Kind {
+      CHARACTER,                // one of a class of characters, then out
+      EMPTY,                    // nothing, then out
+      SPLIT,                    // out or out1
+      LINE_START,               // nothing at the start of a line, then out
+      LINE_END,                 // nothing at the end of a line, then out
+      MATCH                     // the end of a match
+    };
+    Kind kind;
+    std::bitset<256> characters;  // for CHARACTER
+    int out;
+    int out1;
+  };
+
+  // A part of the NFA under construction: its first state, and the
+  // edges out of it that are still to be connected, each as
+  // 2 * node + (1 for out1, 0 for out).
+  struct Fragment {
+    int start;
+    std::vector<int> holes;
+  };
+
+  // A DFA made lazily from the NFA.
+  class Dfa {
+  public:
+    //EFFECTS: Creates a DFA with no states over nodes, whose matches
+    //         start at start_in. An unanchored DFA looks for matches
+    //         starting at every character; an anchored one only at the
+    //         first.
+    Dfa(const std::vector<Node> &nodes_in, int start_in, bool unanchored_in);
+
+    //MODIFIES: *this
+    //EFFECTS:  Returns the state at the start of the text, or of a line
+    //          if line_start.
+    int initial(bool line_start);
+
+    // Flags of a step.
+    static const int MATCHED = 1;   // a match ends before the character
+    static const int NEWLINE = 2;   // the character is a newline
+
+    //MODIFIES: *this
+    //EFFECTS:  Returns the step from state on c: 4 * the state after it
+    //          plus its flags. Other states may be renumbered.
+    int step(int state, unsigned char c) {
+      int next = table[state * 256 + c];
+      return next >= 0 ? next : add_transition(state, c);
+    }
+
+    //EFFECTS: Returns the steps from each state on each character, at
+    //         256 * state + character, or -1 for those not worked out
+    //         yet, which step() works out. Valid until it is called.
+    const int *steps() const {
+      return table.data();
+    }
+
+    //MODIFIES: *this
+    //EFFECTS:  Returns whether a match ends after state, at the end of
+    //          the text, which is the end of a line if line_end.
+    bool accepts_at_end(int state, bool line_end);
+
+    //EFFECTS: Returns whether no match can come out of state.
+    bool is_dead(int state) const {
+      return !unanchored && states[state].first.empty();
+    }
+
+    //EFFECTS: Returns the state of an unanchored DFA before a match
+    //         begins, if idle_exit() is the only character that leaves
+    //         it, or -1. Valid until step() is called.
+    int idle_state() const {
+      return exit >= 0 ? idle : -1;
+    }
+
+    //EFFECTS: Returns the character that leaves idle_state().
+    char idle_exit() const {
+      return exit;
+    }
+
+  private:
+    // NFA states waiting on a character, and whether the last character
+    // read was a newline
+    using State = std::pair<std::vector<int>, bool>;
+
+    const std::vector<Node> &nodes;
+    int start;
+    bool unanchored;
+    bool line_starts;               // whether the NFA has LINE_START,
+                                    // without which states do not track
+                                    // the start of a line
+    int idle;                       // number of the idle state, or -1
+    int exit;                       // character that leaves it, or -1
+    std::vector<State> states;
+    std::map<State, int> numbers;   // number of each state
+    std::vector<int> table;         // 256 transitions of each state, -1
+                                    // for one not yet worked out
+    std::vector<unsigned> marks;    // for closure()
+    unsigned mark;
+    std::vector<int> pending;       // for closure()
+
+    //MODIFIES: *this
+    //EFFECTS:  Returns the number of state, adding it if it is new.
+    int number(const State &state);
+
+    //MODIFIES: *this
+    //EFFECTS:  Forgets every state and transition.
+    void forget();
+
+    //MODIFIES: *this
+    //EFFECTS:  Works out, records and returns step(state, c).
+    int add_transition(int state, unsigned char c);
+
+    //MODIFIES: *this, reached
+    //EFFECTS:  Sets reached to the NFA states reachable from state
+    //          without reading a character, before a newline if
+    //          line_end, and returns whether MATCH is one of them.
+    bool closure(const State &state, bool line_end,
+                 std::vector<int> &reached);
+  };
+
+  // A search through consecutive chunks of a text.
+  struct Scan;
+
+  std::vector<Node> nodes;    // the NFA
+  int start;                  // its first state
+  mutable Dfa forward;        // finds where the first match ends
+  mutable Dfa anchored;       // finds the longest match from a start
+
+  //MODIFIES: *this
+  //EFFECTS:  Builds the NFA for the pattern and returns its first state.
+  //          Throws SyntaxError if the pattern is bad.
+  int compile();
+
+  //MODIFIES: *this
+  //EFFECTS:  Adds node to the NFA and returns its number.
+  int add(Node::Kind kind, int out = -1, int out1 = -1,
+          const std::bitset<256> &characters = std::bitset<256>());
+
+  //MODIFIES: *this
+  //EFFECTS:  Connects the holes to node target.
+  void patch(const std::vector<int> &holes, int target);
+
+  //MODIFIES: *this, position
+  //EFFECTS:  Parses alternatives, sequences, repetitions and atoms from
+  //          the pattern at position, adding them to the NFA, and leaves
+  //          position after them. Throws SyntaxError for bad ones.
+  Fragment parse_alternatives(std::size_t &position);
+  Fragment parse_sequence(std::size_t &position);
+  Fragment parse_repetition(std::size_t &position);
+  Fragment parse_atom(std::size_t &position);
+
+  //MODIFIES: position
+  //EFFECTS:  Parses a class of characters, after its [, and returns it.
+  std::bitset<256> parse_class(std::size_t &position) const;
+
+  //MODIFIES: position
+  //EFFECTS:  Parses the escape after a \ and returns the characters it
+  //          stands for.
+  std::bitset<256> parse_escape(std::size_t &position) const;
+
+  //EFFECTS: Returns the first match in line that starts at or after
+  //         from, as its offset and length, or (npos, 0) if there is
+  //         none. line is a whole line, or the end of one if it does
+  //         not start_line, and ends a line if end_line.
+  std::pair<std::size_t, std::size_t> find_in_line(std::string_view line,
+                                                   std::size_t from,
+                                                   bool start_line,
+                                                   bool end_line) const;
+};
+
+#endif // REGEX_HPP
@@ -0,0 +1,157 @@
+/* Regex_bench.cpp
+ *
+ * Throughput of finding every match of a regular expression in a large
+ * synthetic log, for a timestamp on every line, a rare request ID, an
+ * error with a message, and levels at the start of a line: RegexSearch
+ * through a TextBuffer's chunks (a GapBuffer, and a PieceTable cut into
+ * many pieces by edits) and through the text in one string, against
+ * std::regex_search() run over each line of the same string (on the
+ * first few MB only, as it is slow).
+ *
+ * Usage: ./Regex_bench.exe [megabytes]   (default 256)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "Regex.hpp"
+#include "TextBuffer.hpp"
+
+using namespace std;
+
+// Each is written the same for RegexSearch and std::regex.
+static const char *const PATTERNS[] = {
+  "\\d{4}-\\d\\d-\\d\\dT\\d\\d:\\d\\d:\\d\\d",
+  "req-dead[0-9a-f]{4}",
+  "ERROR.*timeout",
+  "^\\S+ (WARN|ERROR) "
+};
+
+// std::regex gets through this many MB of text.
+static const size_t STD_MEGABYTES = 16;
+
+// EFFECTS: Returns n bytes of log lines: a timestamp, a level, a request
+//          ID, and some words, with a timeout in one ERROR line in four.
+static string synthetic_log(size_t n) {
+  static const char *const levels[] = {"INFO", "WARN", "ERROR"};
+  static const char *const words[] = {
+    "GET", "POST", "/api/v1/items", "/login", "user", "ok", "cache",
+    "miss", "hit", "took", "12ms", "3ms", "bytes=512", "status=200"
+  };
+  string text;
+  text.reserve(n + 256);
+  mt19937 gen(280);
+  char head[64];
+  for (long line = 0; text.size() < n; ++line) {
+    int level = gen() % 100 < 90 ? 0 : gen() % 3 == 0 ? 2 : 1;
+    snprintf(head, sizeof head, "2026-10-17T%02ld:%02ld:%02ld.%03ldZ %s ",
+             line / 3600000 % 24, line / 60000 % 60, line / 1000 % 60,
+             line % 1000, levels[level]);
+    text += head;
+    snprintf(head, sizeof head, "req-%08x", static_cast<unsigned>(gen()));
+    text += head;
+    for (int i = 3 + gen() % 6; i > 0; --i) {
+      text.push_back(' ');
+      text += words[gen() % 14];
+    }
+    if (level == 2 && gen() % 4 == 0) {
+      text += " upstream timeout after 30s";
+    }
+    text.push_back('\n');
+  }
+  text.resize(n);
+  return text;
+}
+
+// A text in one string, read as one chunk.
+struct Contiguous {
+  string_view text;
+
+  int size() const {
+    return text.size();
+  }
+
+  void for_each_chunk(int begin, int end,
+                      const Search::ChunkVisitor &visit) const {
+    visit(text.substr(begin, end - begin));
+  }
+};
+
+// EFFECTS: Prints how long count takes to count the matches in bytes of
+//          text.
+static void report(const char *what, size_t bytes,
+                   const function<long()> &count) {
+  auto start = chrono::steady_clock::now();
+  long matches = count();
+  double seconds = chrono::duration<double>(chrono::steady_clock::now()
+                                            - start).count();
+  printf("    %-28s %9ld matches %8.3f s %7.0f MB/s\n", what, matches,
+         seconds, bytes / seconds / 1e6);
+  fflush(stdout);
+}
+
+// EFFECTS: Reports how long search takes to find every match in text in
+//          one find_all() pass.
+template <typename Text>
+static void report_search(const char *what, const RegexSearch &search,
+                          const Text &text) {
+  report(what, text.size(), [&]() {
+    long matches = 0;
+    search.find_all(text, 0, text.size(), [&matches](int, int) {
+      ++matches;
+      return true;
+    });
+    return matches;
+  });
+}
+
+int main(int argc, char **argv) {
+  size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 256;
+  printf("regex benchmark, %zu MB of synthetic log\n", megabytes);
+  string text = synthetic_log(megabytes << 20);
+  string_view head(text.data(), min(text.size(), STD_MEGABYTES << 20));
+  {
+    TextBuffer buffer;
+    buffer.assign(text);
+    for (const char *pattern : PATTERNS) {
+      printf("  %s\n", pattern);
+      RegexSearch search(pattern);
+      report_search("RegexSearch, GapBuffer", search, buffer);
+      report_search("RegexSearch, one string", search, Contiguous{text});
+      regex expression(pattern, regex::ECMAScript | regex::optimize);
+      report("std::regex, by line", head.size(), [&]() {
+        long matches = 0;
+        for (size_t line = 0; line < head.size(); ) {
+          size_t line_end = min(head.find('\n', line), head.size());
+          for (cregex_iterator it(head.data() + line, head.data() + line_end,
+                                  expression), end;
+               it != end; ++it) {
+            ++matches;
+          }
+          line = line_end + 1;
+        }
+        return matches;
+      });
+    }
+  }
+
+  // edits cut the original text of a piece table into many pieces
+  BasicTextBuffer<PieceTable<char>> pieces;
+  pieces.assign(move(text));
+  mt19937 gen(2800);
+  for (int i = 0; i < 10000; ++i) {
+    pieces.seek_index(gen() % pieces.size());
+    pieces.insert("ok ");
+  }
+  for (const char *pattern : PATTERNS) {
+    printf("  %s, piece table after 10000 edits\n", pattern);
+    report_search("RegexSearch", RegexSearch(pattern), pieces);
+  }
+}
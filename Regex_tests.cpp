@@ -0,0 +1,222 @@
+#include "Regex.hpp"
+#include "TextBuffer.hpp"
+#include "unit_test_framework.hpp"
+
+#include <list>
+#include <random>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// EFFECTS: Returns the reason pattern is bad, or "" if it compiles.
+static string syntax_error(const string &pattern) {
+    try {
+        RegexSearch search(pattern);
+    } catch (const RegexSearch::SyntaxError &error) {
+        return error.reason;
+    }
+    return "";
+}
+
+// EFFECTS: Returns the index and length of every match of search in
+//          [begin, end) of text.
+template <typename Text>
+static vector<pair<int, int>> all_matches(const Search &search,
+                                          const Text &text, int begin,
+                                          int end) {
+    vector<pair<int, int>> matches;
+    search.find_all(text, begin, end, [&matches](int at, int length) {
+        matches.emplace_back(at, length);
+        return true;
+    });
+    return matches;
+}
+
+TEST(test_syntax) {
+    ASSERT_TRUE(RegexSearch("abc").matches("abc"));
+    ASSERT_FALSE(RegexSearch("abc").matches("abcd"));
+    ASSERT_TRUE(RegexSearch("a|bc").matches("bc"));
+    ASSERT_TRUE(RegexSearch("ab*c").matches("ac"));
+    ASSERT_TRUE(RegexSearch("ab+c").matches("abbbc"));
+    ASSERT_FALSE(RegexSearch("ab+c").matches("ac"));
+    ASSERT_TRUE(RegexSearch("colou?r").matches("color"));
+    ASSERT_TRUE(RegexSearch("(ab){2,3}").matches("ababab"));
+    ASSERT_FALSE(RegexSearch("(ab){2,3}").matches("ab"));
+    ASSERT_FALSE(RegexSearch("(ab){2,3}").matches("abababab"));
+    ASSERT_TRUE(RegexSearch("x{2,}").matches("xxxxx"));
+    ASSERT_TRUE(RegexSearch("x{0,1}y").matches("y"));
+    ASSERT_TRUE(RegexSearch("[a-c]+").matches("abcba"));
+    ASSERT_FALSE(RegexSearch("[^a-c]").matches("b"));
+    ASSERT_TRUE(RegexSearch("[]x]").matches("]"));
+    ASSERT_TRUE(RegexSearch("[\\d.]+").matches("3.14"));
+    ASSERT_TRUE(RegexSearch("\\d{4}-\\d\\d").matches("2026-10"));
+    ASSERT_TRUE(RegexSearch("\\w+\\s\\S").matches("req_1 ="));
+    ASSERT_TRUE(RegexSearch("a\\.b\\*").matches("a.b*"));
+    ASSERT_FALSE(RegexSearch("a\\.b").matches("axb"));
+    ASSERT_TRUE(RegexSearch("^a.c$").matches("a\tc"));
+    ASSERT_FALSE(RegexSearch(".").matches("\n"));
+    ASSERT_FALSE(RegexSearch("[^a]").matches("\n"));
+
+    ASSERT_EQUAL(syntax_error("(ab"), "missing )");
+    ASSERT_EQUAL(syntax_error("ab)"), "unmatched )");
+    ASSERT_EQUAL(syntax_error("[ab"), "missing ]");
+    ASSERT_EQUAL(syntax_error("*a"), "nothing to repeat before *");
+    ASSERT_EQUAL(syntax_error("a**"), "nothing to repeat before *");
+    ASSERT_EQUAL(syntax_error("a{2"), "missing }");
+    ASSERT_EQUAL(syntax_error("a{3,2}"), "bad range in {}");
+    ASSERT_EQUAL(syntax_error("a{1001}"), "count in {} over 1000");
+    ASSERT_EQUAL(syntax_error("[z-a]"), "bad range in []");
+    ASSERT_EQUAL(syntax_error("a\\"), "\\ at the end");
+    ASSERT_EQUAL(syntax_error("\\q"), "unknown escape \\q");
+    ASSERT_EQUAL(syntax_error("a*"), "matches empty text");
+    ASSERT_EQUAL(syntax_error("^$"), "matches empty text");
+    ASSERT_EQUAL(syntax_error("x|"), "matches empty text");
+    ASSERT_EQUAL(syntax_error(""), "matches empty text");
+}
+
+TEST(test_find_in_text_buffer) {
+    TextBuffer buffer;
+    buffer.insert("2026-10-17 req=ab12 ok\nreq=zz 2026-10-18\n");
+    RegexSearch date("\\d{4}-\\d\\d-\\d\\d");
+    ASSERT_TRUE(date.is_regex());
+    ASSERT_EQUAL(date.pattern(), "\\d{4}-\\d\\d-\\d\\d");
+    ASSERT_TRUE((all_matches(date, buffer, 0, buffer.size())
+                 == vector<pair<int, int>>({{0, 10}, {30, 10}})));
+    int length = 0;
+    ASSERT_EQUAL(date.find(buffer, 1, buffer.size(), length), 30);
+    ASSERT_EQUAL(length, 10);
+    ASSERT_EQUAL(date.find(buffer, 0, 9), -1);
+
+    // leftmost, then longest
+    RegexSearch id("req=[a-z0-9]+");
+    ASSERT_TRUE((all_matches(id, buffer, 0, buffer.size())
+                 == vector<pair<int, int>>({{11, 8}, {23, 6}})));
+    ASSERT_TRUE((all_matches(RegexSearch("a|ab|b12"), buffer, 0, 20)
+                 == vector<pair<int, int>>({{15, 2}})));
+
+    // ^ and $ look just outside the range
+    RegexSearch first("^\\w+");
+    ASSERT_TRUE((all_matches(first, buffer, 0, buffer.size())
+                 == vector<pair<int, int>>({{0, 4}, {23, 3}})));
+    ASSERT_TRUE((all_matches(first, buffer, 1, buffer.size())
+                 == vector<pair<int, int>>({{23, 3}})));
+    RegexSearch last("\\w+$");
+    ASSERT_TRUE((all_matches(last, buffer, 0, buffer.size())
+                 == vector<pair<int, int>>({{20, 2}, {38, 2}})));
+    ASSERT_TRUE(all_matches(last, buffer, 0, 21).empty());
+
+    // matches do not overlap
+    ASSERT_TRUE((all_matches(RegexSearch("\\d\\d"), buffer, 0, 10)
+                 == vector<pair<int, int>>({{0, 2}, {2, 2}, {5, 2}, {8, 2}})));
+}
+
+TEST(test_no_backtracking_blowup) {
+    // a backtracking matcher takes 2^n steps on this one
+    string text(10000, 'a');
+    TextBuffer buffer;
+    buffer.insert(text);
+    RegexSearch search("(a|aa)*b");
+    ASSERT_EQUAL(search.find(buffer, 0, buffer.size()), -1);
+    RegexSearch many("(x|a)*a{20}(a|y)");
+    ASSERT_TRUE((all_matches(many, buffer, 0, buffer.size())
+                 == vector<pair<int, int>>({{0, 10000}})));
+}
+
+// EFFECTS: Returns what RegexSearch should find in [begin, end) of text,
+//          the slow way: std::regex (POSIX, so leftmost-longest) tried
+//          on every piece of every line.
+static vector<pair<int, int>> expected_matches(const string &pattern,
+                                               const string &text,
+                                               int begin, int end) {
+    regex expression(pattern, regex::extended);
+    vector<pair<int, int>> matches;
+    for (int line = begin; line <= end; ) {
+        int line_end = line;
+        while (line_end < end && text[line_end] != '\n') {
+            ++line_end;
+        }
+        bool starts_line = line == 0 || text[line - 1] == '\n';
+        bool ends_line = line_end == text.size() || text[line_end] == '\n';
+        for (int from = line; from < line_end; ) {
+            int start = from, last = -1;
+            for (; start < line_end && last == -1; ++start) {
+                for (int stop = start + 1; stop <= line_end; ++stop) {
+                    auto flags = regex_constants::match_default;
+                    if (start > line || !starts_line) {
+                        flags |= regex_constants::match_not_bol;
+                    }
+                    if (stop < line_end || !ends_line) {
+                        flags |= regex_constants::match_not_eol;
+                    }
+                    if (regex_match(text.begin() + start,
+                                    text.begin() + stop, expression,
+                                    flags)) {
+                        last = stop;
+                    }
+                }
+            }
+            if (last == -1) {
+                break;
+            }
+            matches.emplace_back(start - 1, last - start + 1);
+            from = last;
+        }
+        line = line_end + 1;
+    }
+    return matches;
+}
+
+// EFFECTS: Checks that searches of buffers with storage CharList, made
+//          of many pieces of random text, find what expected_matches()
+//          finds.
+template <typename CharList>
+static void check_against_std_regex() {
+    mt19937 gen(280);
+    BasicTextBuffer<CharList> buffer;
+    for (int i = 0; i < 120; ++i) {
+        buffer.seek_index(gen() % (buffer.size() + 1));
+        buffer.insert(string(1 + gen() % 3, "aab\n"[gen() % 4]));
+    }
+    string text = buffer.stringify();
+    for (const char *pattern : {"a", "ab*", "(a|ba)+", "^b", "a$", "^a+$",
+                                "b[ab]{1,2}a", "(ab|b)(ba)*b", "a.b",
+                                "b{2,}|aab"}) {
+        RegexSearch search(pattern);
+        for (int begin = 0; begin < text.size(); begin += 11) {
+            for (int end : {static_cast<int>(text.size()), begin + 17}) {
+                end = min(end, static_cast<int>(text.size()));
+                ASSERT_TRUE(all_matches(search, buffer, begin, end)
+                            == expected_matches(pattern, text, begin, end));
+            }
+        }
+    }
+}
+
+TEST(test_matches_agree_with_std_regex) {
+    check_against_std_regex<PieceTable<char>>();
+    check_against_std_regex<UnrolledList<char>>();
+    check_against_std_regex<GapBuffer<char>>();
+    check_against_std_regex<Rope<char>>();
+    check_against_std_regex<std::list<char>>();
+}
+
+TEST(test_dfa_cache_starts_over) {
+    // the DFA needs a state for each way the last 14 characters can
+    // start with a, more than MAX_STATES in all, so it is thrown away as the search goes
+    mt19937 gen(280);
+    string text;
+    for (int i = 0; i < 200000; ++i) {
+        text.push_back("ab"[gen() % 2]);
+    }
+    text += "a" + string(13, 'b');
+    TextBuffer buffer;
+    buffer.insert(text);
+    RegexSearch search("a[ab]{12}b$");
+    ASSERT_TRUE((all_matches(search, buffer, 0, buffer.size())
+                 == vector<pair<int, int>>({{200000, 14}})));
+}
+
+TEST_MAIN()
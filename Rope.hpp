@@ -0,0 +1,814 @@
+#ifndef ROPE_HPP
+#define ROPE_HPP
+/* Rope.hpp
+ *
+ * rope (balanced tree of text chunks) with the same interface as List
+ * EECS 280 Project 4
+ */
+
+#include <algorithm>   //std::count, std::copy, std::min
+#include <iterator>    //std::bidirectional_iterator_tag
+#include <cassert>     //assert
+#include <cstddef>     //std::size_t
+#include <cstring>     //std::memmove, std::memcpy
+#include <memory>      //std::shared_ptr
+#include <string>      //std::basic_string
+#include <string_view> //std::basic_string_view
+#include <type_traits> //std::is_trivially_copyable
+#include <vector>
+
+
+template <typename T, int LeafSize = 1024, int Fanout = 32>
+class Rope {
+  //OVERVIEW: a B+ tree whose leaves hold chunks of up to LeafSize
+  //          elements, chained together in order. Every node caches the
+  //          number of elements and line breaks (T('\n')) beneath it, so
+  //          finding an index or the start of a row takes O(log n), and
+  //          an insert or erase at an Iterator updates the counts along
+  //          one leaf-to-root path. The elements of a leaf are kept in
+  //          a block that copies of the rope share, and a rope copies a
+  //          block before it writes to one that a copy also holds, so
+  //          copying only takes O(leaves) and a copy can be read on one
+  //          thread while the rope is edited on another. Same interface
+  //          as List.
+  //NOTE:     Elements are moved with memmove, so T must be trivially
+  //          copyable. insert() and erase() may invalidate every iterator
+  //          into the rope; use the returned iterator. Writing an element
+  //          through an Iterator also writes it in every copy that
+  //          shares its block; use front() or back() instead.
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Rope requires a trivially copyable element type");
+  static_assert(LeafSize >= 4 && Fanout >= 4, "nodes are too small");
+
+  struct Internal;
+
+  struct Node {
+    Internal *parent;   // nullptr for the root
+    bool is_leaf;
+    std::size_t length; // elements in this subtree
+    std::size_t breaks; // line breaks in this subtree
+  };
+
+  struct Leaf : Node {
+    Leaf *prev;         // leaves are chained left to right
+    Leaf *next;
+    int count;          // == length, 0 < count <= LeafSize
+    T *items;           // block.get()
+    std::shared_ptr<T[]> block; // LeafSize elements, shared by copies
+  };
+
+  struct Internal : Node {
+    int count;          // number of children, 0 < count <= Fanout
+    Node *children[Fanout];
+  };
+
+public:
+  // default ctor
+  Rope() : root(nullptr), first(nullptr), last(nullptr) {}
+
+  // copy ctor
+  Rope(const Rope &other) : Rope() {
+    share(other);
+  }
+
+  // assignment operator
+  Rope & operator=(const Rope &rhs) {
+    if (this != &rhs) {
+      clear();
+      share(rhs);
+    }
+    return *this;
+  }
+
+  // dtor
+  ~Rope() {
+    clear();
+  }
+
+  //EFFECTS: replaces the contents with text, building the tree bottom-up
+  //         in O(n) with leaves 7/8 full to leave room for typing
+  void assign(std::basic_string_view<T> text) {
+    clear();
+    std::vector<Node *> level;
+    const std::size_t fill = LeafSize - LeafSize / 8;
+    for (std::size_t pos = 0; pos < text.size(); pos += fill) {
+      Leaf *leaf = new_leaf();
+      leaf->count = static_cast<int>(std::min(fill, text.size() - pos));
+      std::memcpy(leaf->items, text.data() + pos, leaf->count * sizeof(T));
+      recount(leaf);
+      append_leaf(leaf, level);
+    }
+    build(level);
+  }
+
+  //EFFECTS:  returns true if the rope is empty
+  bool empty() const {
+    return root == nullptr;
+  }
+
+  //EFFECTS: returns the number of elements in this rope
+  int size() const {
+    return root == nullptr ? 0 : static_cast<int>(root->length);
+  }
+
+  //EFFECTS: returns the number of rows, i.e. line breaks plus one
+  int row_count() const {
+    return root == nullptr ? 1 : static_cast<int>(root->breaks) + 1;
+  }
+
+  //EFFECTS: returns the height of the tree (0 if empty, 1 for one leaf)
+  int height() const {
+    int h = 0;
+    for (const Node *n = root; n != nullptr;
+         n = n->is_leaf ? nullptr : as_internal(n)->children[0]) {
+      ++h;
+    }
+    return h;
+  }
+
+  //REQUIRES: rope is not empty
+  //EFFECTS: Returns the first element by reference
+  T & front() {
+    assert(!empty());
+    return writable(first)[0];
+  }
+
+  //REQUIRES: rope is not empty
+  //EFFECTS: Returns the last element by reference
+  T & back() {
+    assert(!empty());
+    return writable(last)[last->count - 1];
+  }
+
+  //EFFECTS:  inserts datum into the front of the rope
+  void push_front(const T &datum) {
+    insert(begin(), datum);
+  }
+
+  //EFFECTS:  inserts datum into the back of the rope
+  void push_back(const T &datum) {
+    insert(end(), datum);
+  }
+
+  //REQUIRES: rope is not empty
+  //EFFECTS:  removes the item at the front of the rope
+  void pop_front() {
+    assert(!empty());
+    erase(begin());
+  }
+
+  //REQUIRES: rope is not empty
+  //EFFECTS:  removes the item at the back of the rope
+  void pop_back() {
+    assert(!empty());
+    erase(Iterator(this, last, last->count - 1));
+  }
+
+  //EFFECTS:  removes all items from the rope
+  void clear() {
+    destroy(root);
+    root = nullptr;
+    first = last = nullptr;
+  }
+
+  //EFFECTS: copies the contents into a contiguous string, one block copy
+  //         per leaf
+  std::basic_string<T> str() const {
+    std::basic_string<T> result;
+    result.reserve(size());
+    for (const Leaf *leaf = first; leaf != nullptr; leaf = leaf->next) {
+      result.append(leaf->items, leaf->count);
+    }
+    return result;
+  }
+
+  ////////////////////////////////////////
+  class Iterator {
+    //OVERVIEW: Iterator interface to Rope
+  public:
+    Iterator() : rope_ptr(nullptr), leaf_ptr(nullptr), offset(0) {}
+
+    T & operator*() const {
+      assert(rope_ptr != nullptr && leaf_ptr != nullptr);
+      return leaf_ptr->items[offset];
+    }
+
+    T * operator->() const {
+      return &operator*();
+    }
+
+    Iterator & operator++() {
+      assert(rope_ptr);
+      assert(leaf_ptr != nullptr);
+      if (++offset == leaf_ptr->count) {
+        leaf_ptr = leaf_ptr->next;
+        offset = 0;
+      }
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      operator++();
+      return copy;
+    }
+
+    Iterator & operator--() {
+      assert(rope_ptr);
+      assert(*this != rope_ptr->begin());
+      if (leaf_ptr == nullptr) { // end moves to the last element
+        leaf_ptr = rope_ptr->last;
+        offset = leaf_ptr->count - 1;
+      } else if (offset == 0) {
+        leaf_ptr = leaf_ptr->prev;
+        offset = leaf_ptr->count - 1;
+      } else {
+        --offset;
+      }
+      return *this;
+    }
+
+    Iterator operator--(int) {
+      Iterator copy = *this;
+      operator--();
+      return copy;
+    }
+
+    bool operator==(const Iterator &rhs) const {
+      return rope_ptr == rhs.rope_ptr && leaf_ptr == rhs.leaf_ptr
+        && offset == rhs.offset;
+    }
+
+    bool operator!=(const Iterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+    // Type aliases required to work with STL algorithms.
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+  private:
+    const Rope *rope_ptr;
+    Leaf *leaf_ptr;     // nullptr for the past-the-end position
+    int offset;         // index into leaf_ptr->items
+
+    friend class Rope;
+
+    Iterator(const Rope *rp, Leaf *lp, int off)
+      : rope_ptr(rp), leaf_ptr(lp), offset(off) {}
+  };//Rope::Iterator
+  ////////////////////////////////////////
+
+  // return an Iterator pointing to the first element
+  Iterator begin() const {
+    return Iterator(this, first, 0);
+  }
+
+  // return an Iterator pointing to "past the end"
+  Iterator end() const {
+    return Iterator(this, nullptr, 0);
+  }
+
+  //REQUIRES: 0 <= index <= size()
+  //EFFECTS: returns an Iterator to the element at index in O(log n)
+  Iterator at(int index) const {
+    assert(0 <= index && index <= size());
+    if (index == size()) {
+      return end();
+    }
+    std::size_t remaining = static_cast<std::size_t>(index);
+    const Node *node = root;
+    while (!node->is_leaf) {
+      const Internal *in = as_internal(node);
+      int i = 0;
+      while (remaining >= in->children[i]->length) {
+        remaining -= in->children[i]->length;
+        ++i;
+      }
+      node = in->children[i];
+    }
+    return Iterator(this, as_leaf(node), static_cast<int>(remaining));
+  }
+
+  //REQUIRES: 0 <= begin <= end <= size()
+  //EFFECTS: calls visit(pointer, count) with the elements in [begin, end)
+  //         in place, one block per leaf. visit returns whether to go on
+  //         to the next block.
+  template <typename Visitor>
+  void for_each_chunk(int begin, int end, Visitor visit) const {
+    assert(0 <= begin && begin <= end && end <= size());
+    int remaining = end - begin;
+    Iterator i = at(begin);
+    for (const Leaf *leaf = i.leaf_ptr; remaining > 0; leaf = leaf->next) {
+      int count = std::min(leaf->count - i.offset, remaining);
+      if (!visit(leaf->items + i.offset, count)) {
+        return;
+      }
+      remaining -= count;
+      i.offset = 0;
+    }
+  }
+
+  //REQUIRES: row >= 1
+  //EFFECTS: returns an Iterator to the first element of the given
+  //         1-based row in O(log n), or end() if there is no such row
+  //         or it is the empty last row
+  Iterator row_begin(int row) const {
+    assert(row >= 1);
+    if (row == 1 || root == nullptr) {
+      return row == 1 ? begin() : end();
+    }
+    std::size_t breaks = static_cast<std::size_t>(row - 1);
+    if (breaks > root->breaks) {
+      return end();
+    }
+    // descend to the leaf holding the (row-1)th break
+    const Node *node = root;
+    while (!node->is_leaf) {
+      const Internal *in = as_internal(node);
+      int i = 0;
+      while (breaks > in->children[i]->breaks) {
+        breaks -= in->children[i]->breaks;
+        ++i;
+      }
+      node = in->children[i];
+    }
+    Leaf *leaf = as_leaf(node);
+    int offset = 0;
+    for (;; ++offset) {
+      if (leaf->items[offset] == T('\n') && --breaks == 0) {
+        break;
+      }
+    }
+    Iterator result(this, leaf, offset);
+    return ++result;
+  }
+
+  //REQUIRES: i is a valid iterator associated with this rope
+  //EFFECTS: returns the index of the element i points to in O(log n)
+  int index_of(Iterator i) const {
+    assert(i.rope_ptr == this);
+    if (i.leaf_ptr == nullptr) {
+      return size();
+    }
+    std::size_t index = static_cast<std::size_t>(i.offset);
+    for (const Node *node = i.leaf_ptr; node->parent != nullptr;
+         node = node->parent) {
+      const Internal *parent = node->parent;
+      for (int c = 0; parent->children[c] != node; ++c) {
+        index += parent->children[c]->length;
+      }
+    }
+    return static_cast<int>(index);
+  }
+
+  //REQUIRES: i is a valid, dereferenceable iterator associated with this
+  //          rope
+  //EFFECTS: Removes a single element from the rope.
+  //         Returns An iterator pointing to the element that followed the
+  //         element erased by the function call
+  Iterator erase(Iterator i) {
+    assert(i.rope_ptr == this);
+    assert(i.leaf_ptr != nullptr);
+    Leaf *leaf = i.leaf_ptr;
+    remove_items(leaf, i.offset, 1);
+    if (leaf->count == 0) {
+      Leaf *next = leaf->next;
+      remove_leaf(leaf);
+      return Iterator(this, next, 0);
+    }
+    return absorb_next(leaf, i.offset);
+  }
+
+  //REQUIRES: [range_begin, range_end) is a valid range of iterators
+  //          associated with this rope
+  //EFFECTS: Removes the elements in [range_begin, range_end), trimming
+  //         the leaves at either end and freeing the whole leaves in
+  //         between. Returns an iterator to the element that followed the
+  //         last one erased.
+  Iterator erase(Iterator range_begin, Iterator range_end) {
+    assert(range_begin.rope_ptr == this && range_end.rope_ptr == this);
+    if (range_begin == range_end) {
+      return range_end;
+    }
+    int count = index_of(range_end) - index_of(range_begin);
+    Leaf *leaf = range_begin.leaf_ptr;
+    int offset = range_begin.offset;
+    int n = std::min(count, leaf->count - offset);
+    remove_items(leaf, offset, n);
+    count -= n;
+    Leaf *next = leaf->next;
+    while (count > 0) {
+      n = std::min(count, next->count);
+      remove_items(next, 0, n);
+      count -= n;
+      if (next->count == 0) {
+        Leaf *after = next->next;
+        remove_leaf(next);
+        next = after;
+      }
+    }
+    if (leaf->count == 0) {
+      remove_leaf(leaf);
+      return Iterator(this, next, 0);
+    }
+    return absorb_next(leaf, offset);
+  }
+
+  //REQUIRES: i is a valid iterator associated with this rope
+  //EFFECTS: Inserts datum before the element at the specified position.
+  //         Returns an iterator to the the newly inserted element.
+  Iterator insert(Iterator i, const T &datum) {
+    assert(i.rope_ptr == this);
+    Leaf *leaf = i.leaf_ptr;
+    int offset = i.offset;
+    if (root == nullptr) {
+      leaf = first = last = new_leaf();
+      root = leaf;
+      offset = 0;
+    } else if (leaf == nullptr) { // append to the last leaf
+      leaf = last;
+      offset = last->count;
+    } else if (offset == 0 && leaf->prev != nullptr
+               && leaf->prev->count < LeafSize) {
+      // appending to the previous leaf avoids shifting this one
+      leaf = leaf->prev;
+      offset = leaf->count;
+    }
+    if (leaf->count == LeafSize) {
+      // appending at the end of a leaf starts a fresh one instead of
+      // leaving two half-full leaves behind
+      Leaf *upper = split_leaf(leaf, offset == LeafSize ? LeafSize
+                                                        : LeafSize / 2);
+      if (offset >= leaf->count) {
+        offset -= leaf->count;
+        leaf = upper;
+      }
+    }
+    T *items = writable(leaf);
+    std::memmove(items + offset + 1, items + offset,
+                 (leaf->count - offset) * sizeof(T));
+    items[offset] = datum;
+    ++leaf->count;
+    adjust(leaf, 1, datum == T('\n') ? 1 : 0);
+    return Iterator(this, leaf, offset);
+  }
+
+  //REQUIRES: i is a valid iterator associated with this rope
+  //EFFECTS: Inserts copies of the elements in [range_begin, range_end)
+  //         before the element at the specified position. The leaf
+  //         holding i is split once and the elements are copied into new
+  //         leaves after it, filled like assign() fills them. Returns an
+  //         iterator to the first inserted element, or i if the range is
+  //         empty.
+  template <typename InputIterator>
+  Iterator insert(Iterator i, InputIterator range_begin,
+                  InputIterator range_end) {
+    assert(i.rope_ptr == this);
+    if (range_begin == range_end) {
+      return i;
+    }
+    // the new elements go after the first offset elements of leaf
+    Leaf *leaf = i.leaf_ptr;
+    int offset = i.offset;
+    if (root == nullptr) {
+      leaf = first = last = new_leaf();
+      root = leaf;
+    } else if (leaf == nullptr) {
+      leaf = last;
+      offset = last->count;
+    } else if (offset == 0 && leaf->prev != nullptr) {
+      leaf = leaf->prev;
+      offset = leaf->count;
+    }
+    if (offset < leaf->count) {
+      split_leaf(leaf, offset);
+    }
+    const int fill = LeafSize - LeafSize / 8;
+    if (leaf->count >= fill) {
+      leaf = add_leaf_after(leaf);
+    }
+    Iterator result(this, leaf, leaf->count);
+    T *items = writable(leaf);
+    long added = 0;
+    long added_breaks = 0;
+    for (; range_begin != range_end; ++range_begin) {
+      if (leaf->count == fill) {
+        adjust(leaf, added, added_breaks);
+        added = added_breaks = 0;
+        leaf = add_leaf_after(leaf);
+        items = leaf->items;
+      }
+      T datum = *range_begin;
+      items[leaf->count++] = datum;
+      ++added;
+      added_breaks += (datum == T('\n') ? 1 : 0);
+    }
+    adjust(leaf, added, added_breaks);
+    return result;
+  }
+
+private:
+  Node *root;     // nullptr if the rope is empty
+  Leaf *first;    // leftmost leaf, or nullptr if the rope is empty
+  Leaf *last;     // rightmost leaf, or nullptr if the rope is empty
+
+  static Leaf * as_leaf(const Node *n) {
+    return static_cast<Leaf *>(const_cast<Node *>(n));
+  }
+
+  static Internal * as_internal(const Node *n) {
+    return static_cast<Internal *>(const_cast<Node *>(n));
+  }
+
+  //EFFECTS: returns an empty leaf that keeps its elements in block, or
+  //         in a block of its own if block is null
+  static Leaf * new_leaf(std::shared_ptr<T[]> block = nullptr) {
+    Leaf *leaf = new Leaf;
+    leaf->parent = nullptr;
+    leaf->is_leaf = true;
+    leaf->length = leaf->breaks = 0;
+    leaf->prev = leaf->next = nullptr;
+    leaf->count = 0;
+    leaf->block = block != nullptr ? std::move(block)
+                                   : std::shared_ptr<T[]>(new T[LeafSize]);
+    leaf->items = leaf->block.get();
+    return leaf;
+  }
+
+  //EFFECTS: returns the elements of leaf, copying its block first if a
+  //         copy of this rope also holds it
+  static T * writable(Leaf *leaf) {
+    if (leaf->block.use_count() > 1) {
+      std::shared_ptr<T[]> copy(new T[LeafSize]);
+      std::memcpy(copy.get(), leaf->items, leaf->count * sizeof(T));
+      leaf->block = std::move(copy);
+      leaf->items = leaf->block.get();
+    }
+    return leaf->items;
+  }
+
+  //REQUIRES: rope is empty
+  //EFFECTS: makes this rope a copy of other whose leaves share the
+  //         blocks of other's leaves
+  void share(const Rope &other) {
+    std::vector<Node *> level;
+    for (const Leaf *from = other.first; from != nullptr;
+         from = from->next) {
+      Leaf *leaf = new_leaf(from->block);
+      leaf->count = from->count;
+      leaf->length = from->length;
+      leaf->breaks = from->breaks;
+      append_leaf(leaf, level);
+    }
+    build(level);
+  }
+
+  //EFFECTS: chains leaf after the last leaf and adds it to level
+  void append_leaf(Leaf *leaf, std::vector<Node *> &level) {
+    leaf->prev = last;
+    (last != nullptr ? last->next : first) = leaf;
+    last = leaf;
+    level.push_back(leaf);
+  }
+
+  //REQUIRES: level holds the leaves, chained in order
+  //EFFECTS: builds the tree bottom-up over the leaves in level
+  void build(std::vector<Node *> &level) {
+    while (level.size() > 1) {
+      std::vector<Node *> parents;
+      for (std::size_t i = 0; i < level.size(); i += Fanout) {
+        Internal *node = new_internal();
+        for (std::size_t j = i; j < level.size() && j < i + Fanout; ++j) {
+          node->children[node->count++] = level[j];
+          level[j]->parent = node;
+        }
+        recount(node);
+        parents.push_back(node);
+      }
+      level.swap(parents);
+    }
+    root = level.empty() ? nullptr : level[0];
+  }
+
+  static Internal * new_internal() {
+    Internal *node = new Internal;
+    node->parent = nullptr;
+    node->is_leaf = false;
+    node->length = node->breaks = 0;
+    node->count = 0;
+    return node;
+  }
+
+  //EFFECTS: frees node and everything beneath it
+  static void destroy(Node *node) {
+    if (node == nullptr) {
+      return;
+    }
+    if (node->is_leaf) {
+      delete as_leaf(node);
+    } else {
+      Internal *in = as_internal(node);
+      for (int i = 0; i < in->count; ++i) {
+        destroy(in->children[i]);
+      }
+      delete in;
+    }
+  }
+
+  //EFFECTS: recomputes the cached counts of node from its contents
+  static void recount(Node *node) {
+    if (node->is_leaf) {
+      recount(as_leaf(node));
+    } else {
+      recount(as_internal(node));
+    }
+  }
+
+  static void recount(Leaf *leaf) {
+    leaf->length = leaf->count;
+    leaf->breaks = std::count(leaf->items, leaf->items + leaf->count,
+                              T('\n'));
+  }
+
+  static void recount(Internal *in) {
+    in->length = in->breaks = 0;
+    for (int i = 0; i < in->count; ++i) {
+      in->length += in->children[i]->length;
+      in->breaks += in->children[i]->breaks;
+    }
+  }
+
+  //EFFECTS: adds the given deltas to the counts of node and its ancestors
+  static void adjust(Node *node, long length, long breaks) {
+    for (; node != nullptr; node = node->parent) {
+      node->length += length;
+      node->breaks += breaks;
+    }
+  }
+
+  //REQUIRES: 0 <= keep <= leaf->count
+  //EFFECTS: moves the elements of leaf past the first keep into a new
+  //         leaf that follows it in the chain and in the tree, and
+  //         returns the new leaf
+  Leaf * split_leaf(Leaf *leaf, int keep) {
+    Leaf *upper = add_leaf_after(leaf);
+    upper->count = leaf->count - keep;
+    std::memcpy(upper->items, leaf->items + keep, upper->count * sizeof(T));
+    leaf->count = keep;
+    long moved = upper->count;
+    long moved_breaks = std::count(upper->items, upper->items + upper->count,
+                                   T('\n'));
+    adjust(leaf, -moved, -moved_breaks);
+    adjust(upper, moved, moved_breaks);
+    return upper;
+  }
+
+  //EFFECTS: creates an empty leaf that follows leaf in the chain and in
+  //         the tree, and returns it
+  Leaf * add_leaf_after(Leaf *leaf) {
+    Leaf *fresh = new_leaf();
+    fresh->prev = leaf;
+    fresh->next = leaf->next;
+    (leaf->next != nullptr ? leaf->next->prev : last) = fresh;
+    leaf->next = fresh;
+    insert_after(leaf, fresh);
+    // ancestors split along the way were recounted before fresh was
+    // attached, so bring both paths up to date from the bottom
+    recount_path(fresh->parent);
+    recount_path(leaf->parent);
+    return fresh;
+  }
+
+  //REQUIRES: 0 <= offset, offset + n <= leaf->count
+  //EFFECTS: removes n elements of leaf starting at offset and updates
+  //         the counts of its ancestors
+  static void remove_items(Leaf *leaf, int offset, int n) {
+    long breaks = std::count(leaf->items + offset, leaf->items + offset + n,
+                             T('\n'));
+    if (offset + n < leaf->count) {
+      T *items = writable(leaf);
+      std::memmove(items + offset, items + offset + n,
+                   (leaf->count - offset - n) * sizeof(T));
+    }
+    leaf->count -= n;
+    adjust(leaf, -n, -breaks);
+  }
+
+  //REQUIRES: leaf is not empty, 0 <= offset <= leaf->count
+  //EFFECTS: keeps leaves at least half full on average by moving the
+  //         next leaf into leaf if both fit in half a leaf, and returns
+  //         an iterator to the element at offset in leaf
+  Iterator absorb_next(Leaf *leaf, int offset) {
+    Leaf *next = leaf->next;
+    if (next != nullptr && leaf->count + next->count <= LeafSize / 2) {
+      long moved = next->count;
+      long moved_breaks = static_cast<long>(next->breaks);
+      std::memcpy(writable(leaf) + leaf->count, next->items,
+                  next->count * sizeof(T));
+      leaf->count += next->count;
+      next->count = 0;
+      adjust(leaf, moved, moved_breaks);
+      adjust(next, -moved, -moved_breaks);
+      remove_leaf(next);
+    }
+    if (offset == leaf->count) {
+      return Iterator(this, leaf->next, 0);
+    }
+    return Iterator(this, leaf, offset);
+  }
+
+  //EFFECTS: recomputes the counts of node and all of its ancestors
+  static void recount_path(Internal *node) {
+    for (; node != nullptr; node = node->parent) {
+      recount(node);
+    }
+  }
+
+  //EFFECTS: makes sibling the next child after node, splitting full
+  //         ancestors (and growing a new root) as needed. Counts of the
+  //         ancestors are left for the caller to recompute.
+  void insert_after(Node *node, Node *sibling) {
+    Internal *parent = node->parent;
+    if (parent == nullptr) {
+      Internal *new_root = new_internal();
+      new_root->children[0] = node;
+      new_root->children[1] = sibling;
+      new_root->count = 2;
+      node->parent = sibling->parent = new_root;
+      root = new_root;
+      return;
+    }
+    if (parent->count == Fanout) {
+      Internal *upper = new_internal();
+      int keep = Fanout / 2;
+      for (int i = keep; i < Fanout; ++i) {
+        upper->children[upper->count++] = parent->children[i];
+        parent->children[i]->parent = upper;
+      }
+      parent->count = keep;
+      recount(parent);
+      recount(upper);
+      insert_after(parent, upper);
+      parent = node->parent;
+    }
+    int pos = 0;
+    while (parent->children[pos] != node) {
+      ++pos;
+    }
+    for (int i = parent->count; i > pos + 1; --i) {
+      parent->children[i] = parent->children[i - 1];
+    }
+    parent->children[pos + 1] = sibling;
+    ++parent->count;
+    sibling->parent = parent;
+  }
+
+  //REQUIRES: leaf is empty
+  //EFFECTS: unlinks leaf from the chain and the tree and frees it
+  void remove_leaf(Leaf *leaf) {
+    (leaf->prev != nullptr ? leaf->prev->next : first) = leaf->next;
+    (leaf->next != nullptr ? leaf->next->prev : last) = leaf->prev;
+    remove_node(leaf);
+    // a root with a single child adds height without adding anything
+    while (root != nullptr && !root->is_leaf
+           && as_internal(root)->count == 1) {
+      Internal *old_root = as_internal(root);
+      root = old_root->children[0];
+      root->parent = nullptr;
+      delete old_root;
+    }
+  }
+
+  //REQUIRES: node's subtree is empty
+  //EFFECTS: detaches node from its parent and frees it, along with any
+  //         ancestors left without children
+  void remove_node(Node *node) {
+    Internal *parent = node->parent;
+    if (parent != nullptr) {
+      int pos = 0;
+      while (parent->children[pos] != node) {
+        ++pos;
+      }
+      for (int i = pos + 1; i < parent->count; ++i) {
+        parent->children[i - 1] = parent->children[i];
+      }
+      --parent->count;
+    }
+    if (node->is_leaf) {
+      delete as_leaf(node);
+    } else {
+      delete as_internal(node);
+    }
+    if (parent == nullptr) {
+      root = nullptr;
+    } else if (parent->count == 0) {
+      remove_node(parent);
+    }
+  }
+};//Rope
+
+#endif // ROPE_HPP
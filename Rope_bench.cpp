@@ -0,0 +1,171 @@
+/* Rope_bench.cpp
+ *
+ * Stress test of Rope<char> on a large synthetic text: latency of edits
+ * at random positions and of jumping to random rows (what goto_line
+ * needs), compared with GapBuffer<char>, which has to move its gap for
+ * every far-away edit and scan for newlines to find a row.
+ *
+ * Usage: ./Rope_bench.exe [megabytes]   (default 1024, i.e. 1 GB)
+ * Each storage runs in a forked child so only one copy is resident.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "GapBuffer.hpp"
+#include "Rope.hpp"
+
+using namespace std;
+
+static volatile long sink; // keeps results alive under optimization
+
+// EFFECTS: Returns n bytes of log-like text with lines of 20-120 chars.
+static string synthetic_text(size_t n) {
+  string text(n, ' ');
+  mt19937 gen(280);
+  size_t line_end = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (i == line_end) {
+      text[i] = '\n';
+      line_end = i + 21 + gen() % 100;
+    } else {
+      text[i] = static_cast<char>('a' + (i * 7 + line_end) % 26);
+    }
+  }
+  return text;
+}
+
+// Collects per-operation latencies and prints percentiles.
+class Latencies {
+public:
+  void time(const function<void()> &f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    samples.push_back(chrono::duration<double, micro>(
+                        chrono::steady_clock::now() - start).count());
+  }
+
+  void report(const char *what) {
+    sort(samples.begin(), samples.end());
+    printf("  %-22s n=%-7zu p50 %10.2f us  p99 %10.2f us  max %10.2f us\n",
+           what, samples.size(), samples[samples.size() / 2],
+           samples[samples.size() * 99 / 100], samples.back());
+    fflush(stdout);
+  }
+
+private:
+  vector<double> samples;
+};
+
+// EFFECTS: Times random-position inserts/erases and random row seeks
+//          on a rope built over text.
+static void run_rope(string text, int edits, int seeks) {
+  Rope<char> rope;
+  auto start = chrono::steady_clock::now();
+  rope.assign(text);
+  double build = chrono::duration<double>(chrono::steady_clock::now()
+                                          - start).count();
+  int rows = rope.row_count();
+  text = string(); // release the source text
+  printf("Rope<char>: %d rows, height %d, built in %.2f s\n", rows,
+         rope.height(), build);
+
+  mt19937 gen(1);
+  Latencies edit;
+  for (int i = 0; i < edits; ++i) {
+    int index = gen() % rope.size();
+    edit.time([&]() {
+      auto it = rope.at(index);
+      if (i % 2 == 0) {
+        rope.insert(it, 'x');
+      } else {
+        rope.erase(it);
+      }
+    });
+  }
+  edit.report("random edit");
+
+  Latencies seek;
+  for (int i = 0; i < seeks; ++i) {
+    int row = 1 + gen() % rows;
+    seek.time([&]() {
+      sink = rope.index_of(rope.row_begin(row));
+    });
+  }
+  seek.report("goto_line (seek row)");
+}
+
+// EFFECTS: Same as run_rope, on a gap buffer: rows are found by
+//          counting newlines from the start.
+static void run_gap(string text, int edits, int seeks) {
+  GapBuffer<char> gap;
+  gap.assign(text);
+  text = string();
+  printf("GapBuffer<char>:\n");
+
+  mt19937 gen(1);
+  Latencies edit;
+  for (int i = 0; i < edits; ++i) {
+    int index = gen() % gap.size();
+    edit.time([&]() {
+      auto it = gap.begin();
+      for (int step = 0; step < index; ++step) {
+        ++it; // index based: folds into one addition with NDEBUG
+      }
+      if (i % 2 == 0) {
+        gap.insert(it, 'x');
+      } else {
+        gap.erase(it);
+      }
+    });
+  }
+  edit.report("random edit");
+
+  Latencies seek;
+  const GapBuffer<char> &reader = gap; // reads skip the copy-on-write check
+  for (int i = 0; i < seeks; ++i) {
+    int row = 1 + gen() % 1000000;
+    seek.time([&]() {
+      int index = 0;
+      for (int r = 1; r < row && index < reader.size(); ++index) {
+        r += (reader[index] == '\n');
+      }
+      sink = index;
+    });
+  }
+  seek.report("goto_line (scan)");
+}
+
+// EFFECTS: Runs f in a child process and prints the child's peak RSS.
+static void isolated(const function<void()> &f) {
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    f();
+    _exit(0);
+  }
+  int status;
+  struct rusage usage;
+  wait4(pid, &status, 0, &usage);
+  printf("  peak RSS %.1f MB\n", usage.ru_maxrss / 1024.0);
+}
+
+int main(int argc, char **argv) {
+  size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1024;
+  printf("Rope stress benchmark, %zu MB of synthetic text\n", megabytes);
+  isolated([megabytes]() {
+    run_rope(synthetic_text(megabytes << 20), 200000, 200000);
+  });
+  // every gap move is a memmove of up to the whole buffer, so far fewer
+  isolated([megabytes]() {
+    run_gap(synthetic_text(megabytes << 20), 200, 200);
+  });
+}
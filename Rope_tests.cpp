@@ -0,0 +1,242 @@
+#include "Rope.hpp"
+#include "unit_test_framework.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Tiny leaves and fanout so that splits, merges, and new levels happen
+// after a handful of operations.
+using SmallRope = Rope<char, 4, 4>;
+
+// EFFECTS: returns the contents of rope, walking forward by Iterator
+static string forward_contents(const SmallRope &rope) {
+    return string(rope.begin(), rope.end());
+}
+
+// EFFECTS: returns the contents of rope, walking backward by Iterator
+static string backward_contents(const SmallRope &rope) {
+    string result;
+    for (SmallRope::Iterator it = rope.end(); it != rope.begin();) {
+        --it;
+        result.insert(result.begin(), *it);
+    }
+    return result;
+}
+
+TEST(test_default_ctor) {
+    SmallRope rope;
+    ASSERT_TRUE(rope.empty());
+    ASSERT_EQUAL(rope.size(), 0);
+    ASSERT_EQUAL(rope.row_count(), 1);
+    ASSERT_EQUAL(rope.height(), 0);
+    ASSERT_TRUE(rope.begin() == rope.end());
+    ASSERT_TRUE(rope.row_begin(1) == rope.end());
+}
+
+TEST(test_assign_and_seek) {
+    SmallRope rope;
+    string text = "zero\none\ntwo\nthree\nfour\nfive\nsix\nseven\n";
+    rope.assign(text);
+    ASSERT_EQUAL(rope.size(), static_cast<int>(text.size()));
+    ASSERT_EQUAL(rope.row_count(), 9);
+    ASSERT_EQUAL(rope.str(), text);
+    ASSERT_EQUAL(backward_contents(rope), text);
+    for (int i = 0; i <= rope.size(); ++i) {
+        SmallRope::Iterator it = rope.at(i);
+        ASSERT_EQUAL(rope.index_of(it), i);
+        if (i < rope.size()) {
+            ASSERT_EQUAL(*it, text[i]);
+        }
+    }
+    ASSERT_EQUAL(*rope.row_begin(1), 'z');
+    ASSERT_EQUAL(*rope.row_begin(4), 't');
+    ASSERT_EQUAL(rope.index_of(rope.row_begin(4)), 13);
+    ASSERT_EQUAL(*rope.row_begin(8), 's');
+    ASSERT_TRUE(rope.row_begin(9) == rope.end()); // empty last row
+    ASSERT_TRUE(rope.row_begin(10) == rope.end());
+}
+
+TEST(test_typing_keeps_counts) {
+    SmallRope rope;
+    SmallRope::Iterator it = rope.end();
+    string expected;
+    for (int i = 0; i < 300; ++i) {
+        char c = (i % 7 == 6 ? '\n' : static_cast<char>('a' + i % 26));
+        it = rope.insert(it, c);
+        ++it;
+        expected.push_back(c);
+    }
+    ASSERT_EQUAL(rope.str(), expected);
+    ASSERT_EQUAL(rope.row_count(), 300 / 7 + 1);
+    // the tree stays shallow even though every leaf holds 4 elements
+    ASSERT_TRUE(rope.height() <= 7);
+    ASSERT_EQUAL(rope.index_of(rope.row_begin(3)), 14);
+}
+
+TEST(test_erase_everything) {
+    SmallRope rope;
+    rope.assign("ab\ncd\nef\ngh\nij\nkl\nmn\nop\n");
+    SmallRope::Iterator it = rope.at(5);
+    while (it != rope.end()) {
+        it = rope.erase(it);
+    }
+    ASSERT_EQUAL(rope.str(), "ab\ncd");
+    ASSERT_EQUAL(rope.row_count(), 2);
+    while (!rope.empty()) {
+        rope.pop_front();
+    }
+    ASSERT_EQUAL(rope.height(), 0);
+    rope.push_back('x');
+    ASSERT_EQUAL(rope.str(), "x");
+}
+
+TEST(test_copy_and_assign) {
+    SmallRope a;
+    a.assign("one\ntwo\nthree\n");
+    SmallRope b(a);
+    a.clear();
+    ASSERT_EQUAL(b.str(), "one\ntwo\nthree\n");
+    a = b;
+    b.clear();
+    ASSERT_EQUAL(a.row_count(), 4);
+    ASSERT_EQUAL(backward_contents(a), "one\ntwo\nthree\n");
+}
+
+TEST(test_copies_keep_their_contents_while_edited) {
+    srand(282);
+    SmallRope rope;
+    rope.assign("one\ntwo\nthree\n");
+    vector<SmallRope> copies;
+    vector<string> expected;
+    for (int step = 0; step < 2000; ++step) {
+        if (step % 100 == 0) {
+            copies.push_back(rope);
+            expected.push_back(rope.str());
+        }
+        int pos = rand() % (rope.size() + 1);
+        if (rand() % 3 != 0) {
+            char c = (rand() % 8 == 0) ? '\n'
+                                        : static_cast<char>('a' + rand() % 26);
+            rope.insert(rope.at(pos), c);
+        } else if (pos < rope.size()) {
+            int count = rand() % (rope.size() - pos + 1);
+            rope.erase(rope.at(pos), rope.at(pos + count));
+        }
+        if (!rope.empty() && rope.back() != '\n' && step % 7 == 0) {
+            rope.back() = 'z';
+        }
+    }
+    for (size_t i = 0; i < copies.size(); ++i) {
+        ASSERT_EQUAL(copies[i].str(), expected[i]);
+        ASSERT_EQUAL(forward_contents(copies[i]), expected[i]);
+        ASSERT_EQUAL(copies[i].row_count(),
+                     static_cast<int>(count(expected[i].begin(),
+                                            expected[i].end(), '\n')) + 1);
+    }
+}
+
+TEST(test_random_edits_match_std_list) {
+    srand(280);
+    SmallRope rope;
+    std::list<char> reference;
+    SmallRope::Iterator it = rope.begin();
+    std::list<char>::iterator ref_it = reference.begin();
+    int index = 0;
+    for (int step = 0; step < 20000; ++step) {
+        int op = rand() % 5;
+        if (op == 0 && ref_it != reference.end()) {
+            it = rope.erase(it);
+            ref_it = reference.erase(ref_it);
+        } else if (op == 1) {
+            char c = (rand() % 5 == 0 ? '\n'
+                      : static_cast<char>('a' + rand() % 26));
+            it = rope.insert(it, c);
+            ref_it = reference.insert(ref_it, c);
+            ++it;
+            ++ref_it;
+            ++index;
+        } else if (op == 2 && ref_it != reference.end()) {
+            ++it;
+            ++ref_it;
+            ++index;
+        } else if (op == 3 && ref_it != reference.begin()) {
+            --it;
+            --ref_it;
+            --index;
+        } else if (op == 4) {
+            // jump to a random position through the index
+            index = rand() % (rope.size() + 1);
+            it = rope.at(index);
+            ref_it = reference.begin();
+            for (int i = 0; i < index; ++i) {
+                ++ref_it;
+            }
+        }
+        ASSERT_EQUAL(rope.size(), static_cast<int>(reference.size()));
+        ASSERT_EQUAL(rope.index_of(it), index);
+        ASSERT_EQUAL(it == rope.end(), ref_it == reference.end());
+        if (ref_it != reference.end()) {
+            ASSERT_EQUAL(*it, *ref_it);
+        }
+    }
+    string expected(reference.begin(), reference.end());
+    ASSERT_EQUAL(rope.str(), expected);
+    ASSERT_EQUAL(forward_contents(rope), expected);
+    ASSERT_EQUAL(backward_contents(rope), expected);
+    int rows = 1;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        if (expected[i] == '\n') {
+            ++rows;
+            if (i + 1 < expected.size()) {
+                ASSERT_EQUAL(rope.index_of(rope.row_begin(rows)),
+                             static_cast<int>(i + 1));
+            }
+        }
+    }
+    ASSERT_EQUAL(rope.row_count(), rows);
+}
+
+TEST(test_random_range_edits_match_std_list) {
+    srand(281);
+    SmallRope rope;
+    std::list<char> reference;
+    for (int step = 0; step < 2000; ++step) {
+        int size = static_cast<int>(reference.size());
+        int pos = rand() % (size + 1);
+        std::list<char>::iterator ref_it = reference.begin();
+        advance(ref_it, pos);
+        if (rand() % 2 == 0) {
+            string text(rand() % 20, static_cast<char>('a' + step % 26));
+            if (!text.empty()) {
+                text[rand() % text.size()] = '\n';
+            }
+            SmallRope::Iterator it = rope.insert(rope.at(pos), text.begin(),
+                                                 text.end());
+            reference.insert(ref_it, text.begin(), text.end());
+            ASSERT_EQUAL(rope.index_of(it), pos);
+        } else {
+            int count = rand() % (size - pos + 1);
+            std::list<char>::iterator ref_last = ref_it;
+            advance(ref_last, count);
+            SmallRope::Iterator it = rope.erase(rope.at(pos),
+                                                rope.at(pos + count));
+            reference.erase(ref_it, ref_last);
+            ASSERT_EQUAL(rope.index_of(it), pos);
+        }
+        ASSERT_EQUAL(rope.size(), static_cast<int>(reference.size()));
+    }
+    string expected(reference.begin(), reference.end());
+    ASSERT_EQUAL(rope.str(), expected);
+    ASSERT_EQUAL(forward_contents(rope), expected);
+    ASSERT_EQUAL(backward_contents(rope), expected);
+    ASSERT_EQUAL(rope.row_count(),
+                 static_cast<int>(count(expected.begin(), expected.end(),
+                                        '\n')) + 1);
+}
+
+TEST_MAIN()
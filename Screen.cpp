@@ -0,0 +1,137 @@
+/* Screen.cpp
+ *
+ * Off-screen model of a terminal, drawn through curses-like panes.
+ */
+
+#include "Screen.hpp"
+
+//EFFECTS: Creates an empty pane that is not on any screen.
+Screen::Pane::Pane()
+  : screen(nullptr), origin_y(0), origin_x(0), rows(0), cols(0),
+    y(0), x(0), attributes(NORMAL) {}
+
+//REQUIRES: the region lies within screen
+//EFFECTS:  Creates a pane over the given region of screen, with the
+//          cursor at its top left.
+Screen::Pane::Pane(Screen *screen_in, int top, int left,
+                   int rows_in, int cols_in)
+  : screen(screen_in), origin_y(top), origin_x(left),
+    rows(rows_in), cols(cols_in), y(0), x(0), attributes(NORMAL) {}
+
+//MODIFIES: *this
+//EFFECTS:  Moves the cursor, if (new_y, new_x) is in the pane.
+void Screen::Pane::move_to(int new_y, int new_x) {
+  if (0 <= new_y && new_y < rows && 0 <= new_x && new_x < cols) {
+    y = new_y;
+    x = new_x;
+  }
+}
+
+//MODIFIES: *this, the screen
+//EFFECTS:  Writes c with the pane's attributes at the cursor and
+//          advances the cursor. Returns false if the cursor could
+//          not advance because it is at the end of the last line.
+bool Screen::Pane::add(Cell c) {
+  if (rows == 0 || cols == 0) {
+    return false;
+  }
+  unsigned char ch = c & CHARACTER;
+  Cell attrs = c & ~CHARACTER;
+  if (ch == '\n') {
+    clear_to_eol();
+    if (y + 1 == rows) {
+      return false;           // no scrolling
+    }
+    ++y;
+    x = 0;
+    return true;
+  } else if (ch == '\r') {
+    x = 0;
+    return true;
+  } else if (ch == '\b') {
+    if (x > 0) {
+      --x;
+    }
+    return true;
+  } else if (ch == '\t') {
+    int stop = x + TAB_SIZE - x % TAB_SIZE;
+    if (stop >= cols && y + 1 < rows) {
+      // the tab stop is past the edge: go to the next line instead
+      clear_to_eol();
+      ++y;
+      x = 0;
+      return true;
+    }
+    while (x < stop) {
+      if (!put(BLANK|attrs)) {
+        return false;
+      }
+    }
+    return true;
+  } else if (ch < ' ' || ch == 0x7f) {
+    // show control characters as ^X, like curses' unctrl()
+    return put('^'|attrs) && put((ch == 0x7f ? '?' : ch + '@')|attrs);
+  }
+  return put(c);
+}
+
+//MODIFIES: *this, the screen
+//EFFECTS:  Writes each character of str as add() does.
+void Screen::Pane::add(const char *str) {
+  for (; *str; ++str) {
+    add(static_cast<unsigned char>(*str));
+  }
+}
+
+//MODIFIES: *this, the screen
+//EFFECTS:  Blanks the whole pane and moves the cursor to its top left.
+void Screen::Pane::blank() {
+  for (y = 0; y < rows; ++y) {
+    x = 0;
+    clear_to_eol();
+  }
+  y = x = 0;
+}
+
+//MODIFIES: the screen
+//EFFECTS:  Blanks the cells from the cursor to the end of its line.
+void Screen::Pane::clear_to_eol() {
+  Cell *line = &screen->cells[(origin_y + y) * screen->width + origin_x];
+  for (int i = x; i < cols; ++i) {
+    line[i] = BLANK;
+  }
+}
+
+// Writes c at the cursor and advances it, wrapping at the right edge.
+bool Screen::Pane::put(Cell c) {
+  screen->cells[(origin_y + y) * screen->width + origin_x + x] =
+    c | attributes;
+  if (x + 1 < cols) {
+    ++x;
+  } else if (y + 1 < rows) {
+    ++y;
+    x = 0;
+  } else {
+    return false;             // stays on the last cell
+  }
+  return true;
+}
+
+//REQUIRES: rows >= 0, cols >= 0
+//EFFECTS:  Creates a blank screen, which the terminal is assumed to
+//          show already.
+Screen::Screen(int rows, int cols) {
+  reset(rows, cols);
+}
+
+//REQUIRES: rows >= 0, cols >= 0
+//MODIFIES: *this
+//EFFECTS:  Changes the size of the screen and blanks it, assuming the
+//          terminal has been cleared. Panes over the old size must be
+//          made again.
+void Screen::reset(int rows, int cols) {
+  height = rows;
+  width = cols;
+  cells.assign(height * width, BLANK);
+  shown = cells;
+}
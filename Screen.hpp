@@ -0,0 +1,156 @@
+#ifndef SCREEN_HPP
+#define SCREEN_HPP
+/* Screen.hpp
+ *
+ * Off-screen model of a terminal: a grid of cells (a character and its
+ * attributes) that an editor draws into through panes, rectangular
+ * regions with their own cursor that behave like curses windows. The
+ * screen also remembers what the terminal shows, so that only the cells
+ * that changed since the last frame need to be sent to it.
+ */
+
+#include <vector>
+
+class Screen {
+  //OVERVIEW: A rows x cols grid of cells. Cells are drawn through
+  //          Panes; changes() lists the cells that differ from what the
+  //          terminal was last told to show, and presented() records
+  //          that the terminal now shows the drawn cells.
+public:
+  // A character in the low byte, with attribute bits above it.
+  using Cell = unsigned;
+  static constexpr Cell CHARACTER = 0xff;
+  static constexpr Cell NORMAL = 0;
+  static constexpr Cell STANDOUT = 1u << 8;
+  static constexpr Cell REVERSE = 1u << 9;
+  static constexpr Cell UNDERLINE = 1u << 10;
+  static constexpr Cell BLANK = ' ';
+  static constexpr int TAB_SIZE = 8;
+
+  class Pane {
+    //OVERVIEW: A rectangular region of a screen with a cursor and a set
+    //          of attributes that are added to every cell written.
+    //          Writing follows curses: '\n' clears the rest of the line
+    //          and moves to the next one, '\t' advances to the next tab
+    //          stop, other control characters show as ^X, and the
+    //          cursor wraps at the right edge but never scrolls.
+  public:
+    //EFFECTS: Creates an empty pane that is not on any screen.
+    Pane();
+
+    //REQUIRES: the region lies within screen
+    //EFFECTS:  Creates a pane over the given region of screen, with the
+    //          cursor at its top left.
+    Pane(Screen *screen, int top, int left, int rows, int cols);
+
+    int height() const { return rows; }
+    int width() const { return cols; }
+    int top() const { return origin_y; }
+    int left() const { return origin_x; }
+    int cursor_y() const { return y; }
+    int cursor_x() const { return x; }
+
+    //MODIFIES: *this
+    //EFFECTS:  Moves the cursor, if (new_y, new_x) is in the pane.
+    void move_to(int new_y, int new_x);
+
+    //MODIFIES: *this, the screen
+    //EFFECTS:  Writes c with the pane's attributes at the cursor and
+    //          advances the cursor. Returns false if the cursor could
+    //          not advance because it is at the end of the last line.
+    bool add(Cell c);
+
+    //MODIFIES: *this, the screen
+    //EFFECTS:  Writes each character of str as add() does.
+    void add(const char *str);
+
+    //MODIFIES: *this, the screen
+    //EFFECTS:  Blanks the whole pane and moves the cursor to its top left.
+    void blank();
+
+    //MODIFIES: the screen
+    //EFFECTS:  Blanks the cells from the cursor to the end of its line.
+    void clear_to_eol();
+
+    //MODIFIES: *this
+    //EFFECTS:  Adds or removes attributes from those the pane writes with.
+    void attributes_on(Cell attributes) { this->attributes |= attributes; }
+    void attributes_off(Cell attributes) { this->attributes &= ~attributes; }
+
+  private:
+    Screen *screen;
+    int origin_y, origin_x;   // position of the pane on the screen
+    int rows, cols;
+    int y, x;                 // cursor, relative to the pane
+    Cell attributes;
+
+    // Writes c at the cursor and advances it, wrapping at the right edge.
+    bool put(Cell c);
+  };
+
+  //REQUIRES: rows >= 0, cols >= 0
+  //EFFECTS:  Creates a blank screen, which the terminal is assumed to
+  //          show already.
+  Screen(int rows, int cols);
+
+  int rows() const { return height; }
+  int cols() const { return width; }
+
+  //REQUIRES: 0 <= y < rows(), 0 <= x < cols()
+  //EFFECTS:  Returns the cell drawn at (y, x).
+  Cell at(int y, int x) const { return cells[y * width + x]; }
+
+  //REQUIRES: 0 <= y < rows(), 0 <= x < cols()
+  //EFFECTS:  Returns the cell the terminal was last told to show at (y, x).
+  Cell shown_at(int y, int x) const { return shown[y * width + x]; }
+
+  //REQUIRES: rows >= 0, cols >= 0
+  //MODIFIES: *this
+  //EFFECTS:  Changes the size of the screen and blanks it, assuming the
+  //          terminal has been cleared. Panes over the old size must be
+  //          made again.
+  void reset(int rows, int cols);
+
+  //EFFECTS:  Calls changed(y, x, count) for each run of cells in a line
+  //          that differ from what the terminal shows, top to bottom and
+  //          left to right. Runs that are gap cells or fewer apart are
+  //          joined, since resending a few unchanged cells is cheaper
+  //          than moving the terminal's cursor past them.
+  template <typename Changed>
+  void changes(Changed changed, int gap = 0) const;
+
+  //MODIFIES: *this
+  //EFFECTS:  Records that the terminal now shows the drawn cells.
+  void presented() { shown = cells; }
+
+private:
+  int height, width;
+  std::vector<Cell> cells;    // what has been drawn
+  std::vector<Cell> shown;    // what the terminal shows
+};
+
+template <typename Changed>
+void Screen::changes(Changed changed, int gap) const {
+  for (int y = 0; y < height; ++y) {
+    const Cell *row = &cells[y * width], *row_shown = &shown[y * width];
+    int start = -1, end = -1;  // current run is [start, end)
+    for (int x = 0; x < width; ++x) {
+      if (row[x] == row_shown[x]) {
+        continue;
+      }
+      if (start >= 0 && x - end > gap) {
+        changed(y, start, end - start);
+        start = -1;
+      }
+      if (start < 0) {
+        start = x;
+      }
+      end = x + 1;
+    }
+    if (start >= 0) {
+      changed(y, start, end - start);
+    }
+  }
+}
+
+#endif // SCREEN_HPP
@@ -0,0 +1,109 @@
+#include "Screen.hpp"
+#include "unit_test_framework.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// EFFECTS: returns the characters drawn in row y of screen
+static string row_text(const Screen &screen, int y) {
+    string text;
+    for (int x = 0; x < screen.cols(); ++x) {
+        text.push_back(screen.at(y, x) & Screen::CHARACTER);
+    }
+    return text;
+}
+
+TEST(test_blank_screen) {
+    Screen screen(2, 3);
+    ASSERT_EQUAL(screen.rows(), 2);
+    ASSERT_EQUAL(screen.cols(), 3);
+    ASSERT_EQUAL(row_text(screen, 1), "   ");
+    int runs = 0;
+    screen.changes([&runs](int, int, int) { ++runs; });
+    ASSERT_EQUAL(runs, 0);
+}
+
+TEST(test_pane_wraps_and_stops_at_the_end) {
+    Screen screen(3, 5);
+    Screen::Pane pane(&screen, 1, 1, 2, 3);
+    ASSERT_TRUE(pane.add('a'));
+    pane.add("bcde");
+    ASSERT_EQUAL(pane.cursor_y(), 1);
+    ASSERT_EQUAL(pane.cursor_x(), 2);
+    ASSERT_FALSE(pane.add('f'));    // no scrolling: stays on the last cell
+    ASSERT_FALSE(pane.add('g'));
+    ASSERT_EQUAL(row_text(screen, 0), "     ");
+    ASSERT_EQUAL(row_text(screen, 1), " abc ");
+    ASSERT_EQUAL(row_text(screen, 2), " deg ");
+    pane.move_to(5, 0);             // outside the pane: ignored
+    ASSERT_EQUAL(pane.cursor_y(), 1);
+    pane.blank();
+    ASSERT_EQUAL(row_text(screen, 2), "     ");
+    ASSERT_EQUAL(pane.cursor_x(), 0);
+}
+
+TEST(test_pane_control_characters) {
+    Screen screen(3, 12);
+    Screen::Pane pane(&screen, 0, 0, 3, 12);
+    pane.add("xxxxxxxxxxxx");
+    pane.move_to(0, 2);
+    pane.add("ab\n");               // clears the rest of the row
+    pane.add("\tc\x01");
+    pane.add("d\b\x7f");
+    ASSERT_EQUAL(row_text(screen, 0), "xxab        ");
+    ASSERT_EQUAL(row_text(screen, 1), "        c^Ad");
+    ASSERT_EQUAL(row_text(screen, 2), "^?          ");
+    pane.move_to(2, 6);
+    pane.add("\t\t");               // stops at the edge of the last row
+    ASSERT_EQUAL(pane.cursor_x(), 11);
+}
+
+TEST(test_pane_attributes) {
+    Screen screen(1, 4);
+    Screen::Pane pane(&screen, 0, 0, 1, 4);
+    pane.attributes_on(Screen::REVERSE);
+    pane.add('a'|Screen::STANDOUT);
+    pane.attributes_off(Screen::REVERSE);
+    pane.add('b');
+    ASSERT_EQUAL(screen.at(0, 0), 'a'|Screen::STANDOUT|Screen::REVERSE);
+    ASSERT_EQUAL(screen.at(0, 1), static_cast<Screen::Cell>('b'));
+}
+
+TEST(test_changes_since_presented) {
+    Screen screen(2, 8);
+    Screen::Pane pane(&screen, 0, 0, 2, 8);
+    pane.add("abcdefgh");
+    screen.presented();
+    pane.move_to(0, 1);
+    pane.add('B');
+    pane.move_to(0, 3);
+    pane.add('D');
+    pane.move_to(1, 7);
+    pane.add('!');
+    pane.move_to(0, 6);
+    pane.add('g');                  // same as what is shown
+    vector<int> runs;
+    screen.changes([&runs](int y, int x, int count) {
+        runs.push_back(y);
+        runs.push_back(x);
+        runs.push_back(count);
+    });
+    ASSERT_TRUE(runs == vector<int>({0, 1, 1, 0, 3, 1, 1, 7, 1}));
+    runs.clear();
+    screen.changes([&runs](int y, int x, int count) {
+        runs.push_back(y);
+        runs.push_back(x);
+        runs.push_back(count);
+    }, 1);                          // joins runs one unchanged cell apart
+    ASSERT_TRUE(runs == vector<int>({0, 1, 3, 1, 7, 1}));
+    ASSERT_EQUAL(screen.shown_at(0, 1), static_cast<Screen::Cell>('b'));
+    screen.presented();
+    ASSERT_EQUAL(screen.shown_at(0, 1), static_cast<Screen::Cell>('B'));
+    int count = 0;
+    screen.changes([&count](int, int, int) { ++count; });
+    ASSERT_EQUAL(count, 0);
+}
+
+TEST_MAIN()
@@ -0,0 +1,145 @@
+/* Search.cpp
+ *
+ * Finds a string in blocks of text with memchr() on its rarest byte.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <utility>
+#include "Search.hpp"
+
+// Bytes from about the most to the least common in prose and code;
+// bytes not listed (capitals, most punctuation) count as rarer still.
+static const char COMMON_BYTES[] =
+  " e\ntaoinsrhldcu0mfp1gw2yb3v4k5x6j7q8z9_,.;()=/-\"'*:<>{}";
+
+// After this many places where the rare byte turned up but the string
+// did not, memchr() must have skipped at least MIN_SKIP bytes per place
+// to go on being used.
+static const int MAX_MISSES = 64;
+static const std::ptrdiff_t MIN_SKIP = 4;
+
+// EFFECTS: Returns how common c is: 0 for the most common byte, more for
+//          rarer ones.
+static int commonness_rank(char c) {
+  const char *found = c ? std::strchr(COMMON_BYTES, c) : nullptr;
+  return found ? found - COMMON_BYTES : sizeof COMMON_BYTES;
+}
+
+//EFFECTS: Records pattern_in as the pattern.
+Search::Search(std::string pattern_in) : expression(std::move(pattern_in)) {}
+
+//REQUIRES: pattern_in is not empty
+//EFFECTS:  Prepares to search for pattern_in.
+SubstringSearch::SubstringSearch(std::string pattern_in)
+  : Search(std::move(pattern_in)), rare(0) {
+  const std::string &needle = pattern();
+  assert(!needle.empty());
+  for (std::size_t i = 1; i < needle.size(); ++i) {
+    if (commonness_rank(needle[i]) > commonness_rank(needle[rare])) {
+      rare = i;
+    }
+  }
+}
+
+//EFFECTS: Returns the offset in text of the first occurrence of the
+//         pattern, or std::string_view::npos if there is none.
+std::size_t SubstringSearch::find_in(std::string_view text) const {
+  const std::string &needle = pattern();
+  std::size_t size = needle.size();
+  if (text.size() < size) {
+    return std::string_view::npos;
+  }
+  const char *start = text.data();
+  // the rare byte of a match is somewhere in [next, last]
+  const char *next = start + rare;
+  const char *last = start + (text.size() - size) + rare;
+  const char *checkpoint = next;
+  int misses = 0;
+  while (next <= last) {
+    const char *hit = static_cast<const char *>(
+      std::memchr(next, needle[rare], last - next + 1));
+    if (!hit) {
+      break;
+    }
+    if (std::memcmp(hit - rare, needle.data(), size) == 0) {
+      return hit - rare - start;
+    }
+    next = hit + 1;
+    if (++misses < MAX_MISSES) {
+      continue;
+    } else if (next - checkpoint < MAX_MISSES * MIN_SKIP) {
+      // the byte is too common here to be worth looking for
+      const char *from = next - rare;
+      const void *match = ::memmem(from, start + text.size() - from,
+                                   needle.data(), size);
+      return match ? static_cast<const char *>(match) - start
+                   : std::string_view::npos;
+    }
+    misses = 0;
+    checkpoint = next;
+  }
+  return std::string_view::npos;
+}
+
+//EFFECTS: Returns the offset in text of the first occurrence of the
+//         pattern that starts at or after from, or
+//         std::string_view::npos if there is none.
+std::size_t SubstringSearch::find_in(std::string_view text,
+                                     std::size_t from) const {
+  if (from > text.size()) {
+    return std::string_view::npos;
+  }
+  std::size_t at = find_in(text.substr(from));
+  return at == std::string_view::npos ? at : from + at;
+}
+
+//EFFECTS: Calls found with the index and length of every occurrence of
+//         the pattern within [begin, end), overlapping ones included, in
+//         order, until it returns false.
+void SubstringSearch::scan(const Reader &read, int, int begin, int end,
+                           const MatchVisitor &found) const {
+  Scan scan(*this, begin, found);
+  read(begin, end, [&scan](std::string_view chunk) {
+    return scan.feed(chunk);
+  });
+}
+
+// EFFECTS: Starts a search of text that begins at index position_in and
+//          reports matches to found_in.
+SubstringSearch::Scan::Scan(const SubstringSearch &search_in,
+                            int position_in, const MatchVisitor &found_in)
+  : search(search_in), position(position_in), found(found_in) {}
+
+// EFFECTS: Reports the matches that end in the next chunk, starting with
+//          those that start in the chunks before it. Returns false once
+//          found does.
+bool SubstringSearch::Scan::feed(std::string_view chunk) {
+  std::size_t keep = search.pattern().size() - 1;
+  if (!tail.empty()) {
+    // matches found here that start in the chunk are found again below
+    window.assign(tail);
+    window.append(chunk.substr(0, keep));
+    for (std::size_t at = search.find_in(window); at < tail.size();
+         at = search.find_in(window, at + 1)) {
+      if (!found(position - tail.size() + at, keep + 1)) {
+        return false;
+      }
+    }
+  }
+  for (std::size_t at = search.find_in(chunk);
+       at != std::string_view::npos; at = search.find_in(chunk, at + 1)) {
+    if (!found(position + at, keep + 1)) {
+      return false;
+    }
+  }
+  if (chunk.size() >= keep) {
+    tail.assign(chunk.substr(chunk.size() - keep));
+  } else {
+    tail.append(chunk);
+    tail.erase(0, tail.size() - std::min(tail.size(), keep));
+  }
+  position += chunk.size();
+  return true;
+}
@@ -0,0 +1,161 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+/* Search.hpp
+ *
+ * Finds a string, or a regular expression (Regex.hpp), in a text buffer
+ * without copying the buffer: its chunks are scanned where they are,
+ * one after another, and a match that straddles two chunks is found
+ * like any other.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+class Search {
+  //OVERVIEW: Something to look for in a text, prepared for searching.
+  //          A search reads the text through a Reader, so one compiled
+  //          search works on any kind of text buffer; the templates
+  //          below make a Reader out of a buffer's for_each_chunk().
+public:
+  // Called with each chunk of a text; returns whether to go on.
+  using ChunkVisitor = std::function<bool(std::string_view)>;
+  // Reads the characters of a text with indices in [begin, end) like
+  // TextBuffer::for_each_chunk(begin, end, visit).
+  using Reader = std::function<void(int, int, const ChunkVisitor &)>;
+  // Called with the index and length of each match; returns whether to
+  // go on.
+  using MatchVisitor = std::function<bool(int, int)>;
+
+  virtual ~Search() {}
+
+  //EFFECTS: Returns the string or expression searched for.
+  const std::string &pattern() const {
+    return expression;
+  }
+
+  //EFFECTS: Returns whether the pattern is a regular expression.
+  virtual bool is_regex() const = 0;
+
+  //EFFECTS: Returns the length of every match, or -1 if matches may be
+  //         of any length but never span lines.
+  virtual int match_length() const = 0;
+
+  //REQUIRES: 0 <= begin <= end <= size; read reads a text of size
+  //          characters
+  //EFFECTS:  Calls found with the index and length of every match that
+  //          lies within [begin, end), in order, until it returns false.
+  //          The range is read once, and only up to where found returns
+  //          false, plus at most the characters on either side of it.
+  virtual void scan(const Reader &read, int size, int begin, int end,
+                    const MatchVisitor &found) const = 0;
+
+  //REQUIRES: 0 <= begin <= end <= text.size(); Text has for_each_chunk()
+  //          like TextBuffer's
+  //EFFECTS:  Calls found with the index and length of every match that
+  //          lies within [begin, end), in order, until it returns false.
+  template <typename Text>
+  void find_all(const Text &text, int begin, int end,
+                const MatchVisitor &found) const {
+    scan([&text](int from, int to, const ChunkVisitor &visit) {
+      text.for_each_chunk(from, to, visit);
+    }, text.size(), begin, end, found);
+  }
+
+  //REQUIRES: 0 <= begin <= end <= text.size(); Text has for_each_chunk()
+  //          like TextBuffer's
+  //EFFECTS:  Returns the index in text of the first match that lies
+  //          within [begin, end), or -1 if there is none, and sets length
+  //          to its length if there is one. Only the chunks up to the
+  //          match are read.
+  template <typename Text>
+  int find(const Text &text, int begin, int end, int &length) const {
+    int first = -1;
+    find_all(text, begin, end, [&first, &length](int at, int size) {
+      first = at;
+      length = size;
+      return false;
+    });
+    return first;
+  }
+
+  //REQUIRES: 0 <= begin <= end <= text.size(); Text has for_each_chunk()
+  //          like TextBuffer's
+  //EFFECTS:  Returns the index in text of the first match that lies
+  //          within [begin, end), or -1 if there is none.
+  template <typename Text>
+  int find(const Text &text, int begin, int end) const {
+    int length;
+    return find(text, begin, end, length);
+  }
+
+protected:
+  //EFFECTS: Records pattern_in as the pattern.
+  explicit Search(std::string pattern_in);
+
+private:
+  std::string expression;     // the pattern
+};
+
+class SubstringSearch : public Search {
+  //OVERVIEW: A string to look for, prepared for searching. Within a
+  //          block of text, memchr() skips ahead to the byte of the
+  //          string that is least common in text (going by a fixed
+  //          ranking of how common bytes are), and only the places it
+  //          turns up are compared with the whole string. Should that
+  //          byte turn up too often to pay off, the rest of the block
+  //          is left to memmem(), whose Two-Way search takes linear time
+  //          however repetitive the text and string are. Overlapping
+  //          matches are all found.
+public:
+  //REQUIRES: pattern_in is not empty
+  //EFFECTS:  Prepares to search for pattern_in.
+  explicit SubstringSearch(std::string pattern_in);
+
+  bool is_regex() const override {
+    return false;
+  }
+
+  int match_length() const override {
+    return pattern().size();
+  }
+
+  //EFFECTS: Returns the offset in text of the first occurrence of the
+  //         pattern, or std::string_view::npos if there is none.
+  std::size_t find_in(std::string_view text) const;
+
+  //EFFECTS: Returns the offset in text of the first occurrence of the
+  //         pattern that starts at or after from, or
+  //         std::string_view::npos if there is none.
+  std::size_t find_in(std::string_view text, std::size_t from) const;
+
+  void scan(const Reader &read, int size, int begin, int end,
+            const MatchVisitor &found) const override;
+
+private:
+  std::size_t rare;           // index in the pattern of its least
+                              // common byte
+
+  // A search through consecutive chunks of a text.
+  struct Scan {
+    // EFFECTS: Starts a search of text that begins at index position_in
+    //          and reports matches to found_in.
+    Scan(const SubstringSearch &search_in, int position_in,
+         const MatchVisitor &found_in);
+
+    // EFFECTS: Reports the matches that end in the next chunk, starting
+    //          with those that start in the chunks before it. Returns
+    //          false once found does.
+    bool feed(std::string_view chunk);
+
+    const SubstringSearch &search;
+    int position;             // index of the start of the next chunk
+    const MatchVisitor &found;
+    std::string tail;         // the last characters fed, one fewer than
+                              // the pattern has
+    std::string window;       // tail and the start of the next chunk
+  };
+};
+
+#endif // SEARCH_HPP
@@ -0,0 +1,171 @@
+/* Search_bench.cpp
+ *
+ * Throughput of finding every occurrence of a string in a large
+ * synthetic text, for a rare string, a missing one, a frequent one, and
+ * a long one, one search after another as repeated ^F would find them:
+ * SubstringSearch through a TextBuffer's chunks (a GapBuffer, and a
+ * PieceTable cut into many pieces by edits), against
+ * std::string::find() and memmem() on the same text in one string, and
+ * against the deque window that handle_find() used to slide over the
+ * buffer one forward() at a time (on the first few MB only, as it is
+ * slow). On the piece table, also all matches in one find_all() pass,
+ * the way MatchIndex finds them.
+ *
+ * Usage: ./Search_bench.exe [megabytes]   (default 1024, i.e. 1 GB)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "Search.hpp"
+#include "TextBuffer.hpp"
+
+using namespace std;
+
+static const char *const PATTERNS[] = {
+  "needle", "zebra", "the ", "fox jumps over the lazy dog"
+};
+
+// The deque window is this slow, in MB of text it gets through.
+static const size_t OLD_MEGABYTES = 16;
+
+// EFFECTS: Returns n bytes of text with lines of 20-120 chars, made of
+//          words; one line in every 200 or so holds the word "needle".
+static string synthetic_text(size_t n) {
+  static const char *const words[] = {
+    "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog",
+    "int", "return", "while", "std::string", "{", "}", "//", "buffer"
+  };
+  string text;
+  text.reserve(n + 128);
+  mt19937 gen(280);
+  while (text.size() < n) {
+    size_t line_end = text.size() + 20 + gen() % 100;
+    if (gen() % 200 == 0) {
+      text += "needle ";
+    }
+    while (text.size() < line_end) {
+      text += words[gen() % 16];
+      text.push_back(' ');
+    }
+    text.back() = '\n';
+  }
+  text.resize(n);
+  return text;
+}
+
+// EFFECTS: Prints how long it takes find to find every match in bytes
+//          of text. find(from) returns the offset of the first match at
+//          or after from, or -1.
+static void report(const char *what, size_t bytes,
+                   const function<long(long)> &find) {
+  auto start = chrono::steady_clock::now();
+  long matches = 0;
+  for (long at = find(0); at != -1; at = find(at + 1)) {
+    ++matches;
+  }
+  double seconds = chrono::duration<double>(chrono::steady_clock::now()
+                                            - start).count();
+  printf("    %-28s %9ld matches %8.3f s %7.0f MB/s\n", what, matches,
+         seconds, bytes / seconds / 1e6);
+  fflush(stdout);
+}
+
+// EFFECTS: Returns the index of the first match of search at or after
+//          the cursor, moving the cursor to its last character, like the
+//          old find_helper(), or -1.
+static long deque_find(TextBuffer &text, const deque<char> &search) {
+  deque<char> window;
+  for (; !text.is_at_end(); text.forward()) {
+    if (window.size() == search.size()) {
+      window.pop_front();
+    }
+    window.push_back(text.data_at_cursor());
+    if (window == search) {
+      return text.get_index() - search.size() + 1;
+    }
+  }
+  return -1;
+}
+
+// EFFECTS: Reports how long SubstringSearch takes to find every match of
+//          pattern in buffer.
+template <typename CharList>
+static void report_buffer(const char *what,
+                          const BasicTextBuffer<CharList> &buffer,
+                          const char *pattern) {
+  SubstringSearch search(pattern);
+  report(what, buffer.size(), [&](long from) {
+    return search.find(buffer, min<long>(from, buffer.size()),
+                       buffer.size());
+  });
+}
+
+int main(int argc, char **argv) {
+  size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1024;
+  printf("search benchmark, %zu MB of synthetic text\n", megabytes);
+  string text = synthetic_text(megabytes << 20);
+
+  TextBuffer old_buffer;
+  old_buffer.assign(text.substr(0, min(text.size(), OLD_MEGABYTES << 20)));
+  {
+    TextBuffer buffer;
+    buffer.assign(text);
+    for (const char *pattern : PATTERNS) {
+      printf("  \"%s\"\n", pattern);
+      string_view all(text);
+      report("std::string::find", text.size(), [&](long from) {
+        size_t at = all.find(pattern, from);
+        return at == string_view::npos ? -1 : static_cast<long>(at);
+      });
+      report("memmem", text.size(), [&](long from) {
+        const void *at = memmem(text.data() + from, text.size() - from,
+                                pattern, strlen(pattern));
+        return at ? static_cast<const char *>(at) - text.data() : -1;
+      });
+      report_buffer("SubstringSearch, GapBuffer", buffer, pattern);
+      deque<char> window(pattern, pattern + strlen(pattern));
+      report("old deque window", old_buffer.size(), [&](long from) {
+        old_buffer.seek_index(min<long>(from, old_buffer.size()));
+        return deque_find(old_buffer, window);
+      });
+    }
+  }
+
+  // edits cut the original text of a piece table into many pieces
+  BasicTextBuffer<PieceTable<char>> pieces;
+  pieces.assign(move(text));
+  mt19937 gen(2800);
+  for (int i = 0; i < 10000; ++i) {
+    pieces.seek_index(gen() % pieces.size());
+    pieces.insert("the ");
+  }
+  // each search starts by finding its piece, in O(pieces), so a
+  // frequent string's matches are only found in one pass, as MatchIndex
+  // finds them
+  for (const char *pattern : PATTERNS) {
+    printf("  \"%s\", piece table after 10000 edits\n", pattern);
+    if (strcmp(pattern, "the ") != 0) {
+      report_buffer("one search at a time", pieces, pattern);
+    }
+    auto start = chrono::steady_clock::now();
+    long matches = 0;
+    SubstringSearch(pattern).find_all(pieces, 0, pieces.size(),
+                                      [&matches](int, int) {
+      ++matches;
+      return true;
+    });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now()
+                                              - start).count();
+    printf("    %-28s %9ld matches %8.3f s %7.0f MB/s\n", "one pass",
+           matches, seconds, pieces.size() / seconds / 1e6);
+  }
+}
@@ -0,0 +1,89 @@
+#include "Search.hpp"
+#include "TextBuffer.hpp"
+#include "unit_test_framework.hpp"
+
+#include <list>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+static const size_t NPOS = string_view::npos;
+
+TEST(test_find_in) {
+    SubstringSearch search("needle");
+    ASSERT_EQUAL(search.pattern(), "needle");
+    ASSERT_EQUAL(search.find_in("hay needle hay needle"), 4u);
+    ASSERT_EQUAL(search.find_in("needle"), 0u);
+    ASSERT_EQUAL(search.find_in("a haystack with a needl"), NPOS);
+    ASSERT_EQUAL(search.find_in("need"), NPOS);
+    ASSERT_EQUAL(search.find_in(""), NPOS);
+    ASSERT_EQUAL(SubstringSearch("x").find_in("abcx"), 3u);
+    ASSERT_EQUAL(SubstringSearch("x").find_in("abc"), NPOS);
+    ASSERT_EQUAL(SubstringSearch("\n\n").find_in("a\nb\n\nc"), 3u);
+}
+
+TEST(test_find_in_repetitive_text) {
+    // 'b' is the rarer byte, but it is everywhere in this text
+    string text(10000, 'b');
+    ASSERT_EQUAL(SubstringSearch("ba").find_in(text + "a"), 9999u);
+    ASSERT_EQUAL(SubstringSearch("ba").find_in(text), NPOS);
+    text[5000] = 'a';
+    ASSERT_EQUAL(SubstringSearch("ba").find_in(text), 4999u);
+    ASSERT_EQUAL(SubstringSearch("bbbbc").find_in(text + "bc"), 9997u);
+}
+
+TEST(test_find_in_text_buffer) {
+    TextBuffer buffer;
+    buffer.insert("one two\nthree two\n");
+    SubstringSearch search("two");
+    ASSERT_EQUAL(search.find(buffer, 0, buffer.size()), 4);
+    ASSERT_EQUAL(search.find(buffer, 5, buffer.size()), 14);
+    ASSERT_EQUAL(search.find(buffer, 5, 16), -1); // the match ends at 17
+    ASSERT_EQUAL(search.find(buffer, 5, 17), 14);
+    ASSERT_EQUAL(search.find(buffer, 15, buffer.size()), -1);
+    ASSERT_EQUAL(search.find(buffer, 0, 0), -1);
+}
+
+// EFFECTS: Returns the contents of a buffer with storage CharList that
+//          is made of many small pieces, with "abc" spread over them.
+template <typename CharList>
+static BasicTextBuffer<CharList> pieces() {
+    BasicTextBuffer<CharList> buffer;
+    buffer.insert(string(50, 'x') + "ab" + string(50, 'x'));
+    for (int i = 0; i < 40; ++i) {
+        buffer.seek_index(i * 2 + 1);
+        buffer.insert(i % 3 == 0 ? 'c' : 'a');
+        buffer.seek_index(i * 3);
+        buffer.insert(i % 5 == 0 ? "ab" : "b");
+    }
+    return buffer;
+}
+
+// EFFECTS: Checks that every search of buffer finds what
+//          std::string::find() finds in its contents.
+template <typename CharList>
+static void check_against_string(const BasicTextBuffer<CharList> &buffer) {
+    string text = buffer.stringify();
+    for (const char *pattern : {"abc", "ab", "c", "xab", "bcx", "cab"}) {
+        SubstringSearch search(pattern);
+        for (int begin = 0; begin < text.size(); begin += 7) {
+            for (int end : {static_cast<int>(text.size()), begin + 9}) {
+                end = min(end, static_cast<int>(text.size()));
+                size_t at = text.substr(0, end).find(pattern, begin);
+                int expected = at == string::npos ? -1 : static_cast<int>(at);
+                ASSERT_EQUAL(search.find(buffer, begin, end), expected);
+            }
+        }
+    }
+}
+
+TEST(test_matches_across_chunks) {
+    check_against_string(pieces<PieceTable<char>>());
+    check_against_string(pieces<UnrolledList<char>>());
+    check_against_string(pieces<GapBuffer<char>>());
+    check_against_string(pieces<Rope<char>>());
+    check_against_string(pieces<std::list<char>>());
+}
+
+TEST_MAIN()
@@ -0,0 +1,203 @@
+/* Terminal.cpp
+ *
+ * Sends Screen frames to the terminal with terminfo codes.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <ncurses.h>
+#include <term.h>
+#include "Terminal.hpp"
+
+//EFFECTS: Creates a terminal that has not been started.
+Terminal::Terminal()
+  : resumed(false), visibility(1), cursor_y(-1), cursor_x(-1),
+    attributes(Screen::NORMAL) {}
+
+//MODIFIES: *this, the terminal
+//EFFECTS:  Starts curses, which clears the terminal.
+// look the other way if you've ever programmed using curses
+void Terminal::start(bool raw) {
+  initscr();
+  if (raw) {
+    ::raw();
+  } else {
+    cbreak();
+  }
+  noecho();
+  keypad(stdscr, true);
+  visibility = curs_set(0);
+  refresh(); // curses clears the terminal now, and not over our frames
+}
+
+//REQUIRES: start() has been called
+//MODIFIES: *this, screen, the terminal
+//EFFECTS:  Clears the terminal and resets screen to the terminal's
+//          current size. Returns the number of bytes written.
+std::size_t Terminal::reset(Screen &screen) {
+  if (resumed) {
+    endwin();
+    refresh(); // back from endwin(), with the terminal's current size
+  }
+  resumed = true;
+  use_attributes(Screen::NORMAL);
+  append(clear_screen);
+  cursor_y = cursor_x = 0;
+  screen.reset(getmaxy(stdscr), getmaxx(stdscr));
+  return flush();
+}
+
+//REQUIRES: curses has been initialized
+//MODIFIES: screen, the terminal
+//EFFECTS:  Sends the cells of screen that differ from what the
+//          terminal shows and records them as shown. Returns the
+//          number of bytes written.
+std::size_t Terminal::present(Screen &screen) {
+  // rewriting unchanged cells is cheaper than a jump shorter than this
+  int gap = cursor_address ? std::strlen(tiparm(cursor_address, 10, 10)) : 0;
+  screen.changes([&](int y, int x, int count) {
+    for (int i = x; i < x + count; ++i) {
+      send(screen, y, i);
+    }
+  }, gap - 1);
+  screen.presented();
+  return flush();
+}
+
+//REQUIRES: start() has been called
+//EFFECTS:  Returns the next key from curses.
+int Terminal::read_key() {
+  return getch();
+}
+
+//REQUIRES: start() has been called
+//EFFECTS:  Waits up to seconds for a key from curses, and returns
+//          whether one came in. The key is left for read_key().
+bool Terminal::wait_for_key(double seconds) {
+  timeout(static_cast<int>(seconds * 1000));
+  int key = getch();
+  timeout(-1);                // read_key() waits as long as it takes
+  if (key == ERR) {
+    return false;
+  }
+  ungetch(key);
+  return true;
+}
+
+void Terminal::beep() {
+  ::beep();
+}
+
+//MODIFIES: *this, the terminal
+//EFFECTS:  Puts the cursor back where curses last left it and shuts
+//          curses down, restoring the terminal.
+void Terminal::stop() {
+  // curses still thinks the cursor is at the top left with no
+  // attributes, so endwin() restores the terminal from there
+  use_attributes(Screen::NORMAL);
+  move_to(0, 0);
+  flush();
+  curs_set(visibility); // restore prior visibility
+  endwin();
+}
+
+// Appends a terminfo string, if the terminal has it.
+void Terminal::append(const char *code) {
+  if (code) {
+    output += code;
+  }
+}
+
+// Appends codes to move the terminal's cursor to (y, x).
+void Terminal::move_to(int y, int x) {
+  if (y == cursor_y && x == cursor_x) {
+    return;
+  }
+  if (attributes != Screen::NORMAL && !move_standout_mode) {
+    use_attributes(Screen::NORMAL); // not safe to move with them on
+  }
+  if (cursor_address) {
+    append(tiparm(cursor_address, y, x));
+  }
+  cursor_y = y;
+  cursor_x = x;
+}
+
+// Appends codes to switch the terminal to the given attributes.
+void Terminal::use_attributes(Screen::Cell new_attributes) {
+  if (new_attributes == attributes) {
+    return;
+  }
+  if (attributes != Screen::NORMAL) {
+    append(exit_attribute_mode);
+  }
+  if (new_attributes & Screen::STANDOUT) {
+    append(enter_standout_mode);
+  }
+  if (new_attributes & Screen::REVERSE) {
+    append(enter_reverse_mode);
+  }
+  if (new_attributes & Screen::UNDERLINE) {
+    append(enter_underline_mode);
+  }
+  attributes = new_attributes;
+}
+
+// Appends the codes to show the cell of screen at (y, x).
+void Terminal::send(const Screen &screen, int y, int x) {
+  Screen::Cell cell = screen.at(y, x);
+  bool last_column = x + 1 == screen.cols();
+  if (last_column && y + 1 == screen.rows() && auto_right_margin) {
+    // Writing the bottom right cell would scroll the terminal. Instead,
+    // write it one cell to the left and push it over by inserting the
+    // cell that belongs there, if the terminal can insert.
+    if (x == 0 || !(enter_insert_mode || insert_character)) {
+      return;
+    }
+    move_to(y, x - 1);
+    use_attributes(cell & ~Screen::CHARACTER);
+    output.push_back(cell & Screen::CHARACTER);
+    cursor_y = cursor_x = -1;
+    move_to(y, x - 1);
+    Screen::Cell before = screen.at(y, x - 1);
+    use_attributes(before & ~Screen::CHARACTER);
+    if (enter_insert_mode) {
+      append(enter_insert_mode);
+      output.push_back(before & Screen::CHARACTER);
+      append(exit_insert_mode);
+    } else {
+      append(insert_character);
+      output.push_back(before & Screen::CHARACTER);
+    }
+    cursor_y = cursor_x = -1;
+    return;
+  }
+  move_to(y, x);
+  use_attributes(cell & ~Screen::CHARACTER);
+  output.push_back(cell & Screen::CHARACTER);
+  if (last_column) {
+    cursor_y = cursor_x = -1; // terminals differ on where it goes now
+  } else {
+    ++cursor_x;
+  }
+}
+
+// Writes out the frame and returns its size in bytes.
+std::size_t Terminal::flush() {
+  std::size_t size = output.size();
+  const char *data = output.data();
+  std::size_t left = size;
+  while (left > 0) {
+    ssize_t written = ::write(STDOUT_FILENO, data, left);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    } else if (written <= 0) {
+      break;                  // the terminal is gone; drop the frame
+    }
+    data += written;
+    left -= written;
+  }
+  output.clear();
+  return size;
+}
@@ -0,0 +1,81 @@
+#ifndef TERMINAL_HPP
+#define TERMINAL_HPP
+/* Terminal.hpp
+ *
+ * The display on the terminal, set up with curses. Only the cells of a
+ * Screen that changed since the last frame are sent, using the
+ * terminal's own cursor-movement and attribute codes from terminfo, and
+ * every byte written is counted.
+ */
+
+#include <cstddef>
+#include <string>
+#include "Display.hpp"
+#include "Screen.hpp"
+
+class Terminal : public Display {
+  //OVERVIEW: Writes frames of a Screen to standard output and reads
+  //          keys with curses. Curses is only used to set the terminal
+  //          up and to read keys; the screen's contents never go through
+  //          curses' own windows.
+public:
+  //EFFECTS: Creates a terminal that has not been started.
+  Terminal();
+
+  //MODIFIES: *this, the terminal
+  //EFFECTS:  Starts curses, which clears the terminal.
+  void start(bool raw) override;
+
+  //REQUIRES: start() has been called
+  //MODIFIES: *this, screen, the terminal
+  //EFFECTS:  Clears the terminal and resets screen to the terminal's
+  //          current size. Returns the number of bytes written.
+  std::size_t reset(Screen &screen) override;
+
+  //REQUIRES: start() has been called
+  //MODIFIES: *this, screen, the terminal
+  //EFFECTS:  Sends the cells of screen that differ from what the
+  //          terminal shows and records them as shown. Returns the
+  //          number of bytes written.
+  std::size_t present(Screen &screen) override;
+
+  //REQUIRES: start() has been called
+  //EFFECTS:  Returns the next key from curses.
+  int read_key() override;
+
+  //REQUIRES: start() has been called
+  //EFFECTS:  Waits up to seconds for a key from curses, and returns
+  //          whether one came in.
+  bool wait_for_key(double seconds) override;
+
+  void beep() override;
+
+  //MODIFIES: *this, the terminal
+  //EFFECTS:  Puts the cursor back where curses last left it and shuts
+  //          curses down, restoring the terminal.
+  void stop() override;
+
+private:
+  bool resumed;               // whether curses must be resumed on reset()
+  int visibility;             // cursor visibility before start()
+  std::string output;         // bytes of the frame being written
+  int cursor_y, cursor_x;     // terminal's cursor, -1 if unknown
+  Screen::Cell attributes;    // attributes in effect on the terminal
+
+  // Appends a terminfo string, if the terminal has it.
+  void append(const char *code);
+
+  // Appends codes to move the terminal's cursor to (y, x).
+  void move_to(int y, int x);
+
+  // Appends codes to switch the terminal to the given attributes.
+  void use_attributes(Screen::Cell new_attributes);
+
+  // Appends the codes to show the cell of screen at (y, x).
+  void send(const Screen &screen, int y, int x);
+
+  // Writes out the frame and returns its size in bytes.
+  std::size_t flush();
+};
+
+#endif // TERMINAL_HPP
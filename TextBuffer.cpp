@@ -5,15 +5,225 @@
 //  Created by Bends on 7/7/24.
 //
 
+#include <algorithm>
+#include <cstdlib>
 #include "TextBuffer.hpp"
 
+namespace {
+  // Farthest a cursor is walked to reach an index on a CharList that can
+  // jump there with at(); at() may itself walk blocks or pieces from one
+  // end of the list, so short moves are cheaper taken one step at a time.
+  const int NEAR = 256;
+
+  //EFFECTS: Returns cursor (at index from) moved to index target, one
+  //         character at a time.
+  template <typename Iterator>
+  Iterator walk(Iterator cursor, int from, int target) {
+      for (; from < target; ++from) {
+          ++cursor;
+      }
+      for (; from > target; --from) {
+          --cursor;
+      }
+      return cursor;
+  }
+
+  //EFFECTS: Returns an iterator to the character at index target of a
+  //         CharList that can jump there with at(), walking from cursor
+  //         (at index from) instead when target is near it.
+  template <typename Container, typename Iterator>
+  auto iterator_at(Container &data, Iterator cursor, int from, int target,
+                   int) -> decltype(data.at(target)) {
+      if (std::abs(target - from) <= NEAR) {
+          return walk(cursor, from, target);
+      }
+      return data.at(target);
+  }
+
+  //EFFECTS: Returns an iterator to the character at index target of any
+  //         other CharList, walking from whichever of cursor (at index
+  //         from), the beginning, or the end is closest.
+  template <typename Container, typename Iterator>
+  Iterator iterator_at(Container &data, Iterator cursor, int from,
+                       int target, long) {
+      int size = data.size();
+      if (target < std::abs(target - from)) {
+          cursor = data.begin();
+          from = 0;
+      }
+      if (size - target < std::abs(target - from)) {
+          cursor = data.end();
+          from = size;
+      }
+      return walk(cursor, from, target);
+  }
+
+  //EFFECTS: Calls visit with the characters in [begin, end) of a CharList
+  //         that keeps them in blocks, one view per block, in place.
+  template <typename Container, typename Visitor>
+  auto visit_chunks(const Container &data, int begin, int end,
+                    const Visitor &visit, int)
+      -> decltype(data.for_each_chunk(begin, end, visit)) {
+      data.for_each_chunk(begin, end, [&visit](const char *chunk, int count) {
+          return visit(std::string_view(chunk, count));
+      });
+  }
+
+  //EFFECTS: Calls visit with the characters in [begin, end) of any other
+  //         CharList, copied a block at a time into a small buffer.
+  template <typename Container, typename Visitor>
+  void visit_chunks(const Container &data, int begin, int end,
+                    const Visitor &visit, long) {
+      char block[256];
+      int count = 0;
+      auto it = iterator_at(data, data.begin(), 0, begin, 0);
+      for (int i = begin; i < end; ++i, ++it) {
+          block[count++] = *it;
+          if (count == sizeof(block) || i + 1 == end) {
+              if (!visit(std::string_view(block, count))) {
+                  return;
+              }
+              count = 0;
+          }
+      }
+  }
+
+  //MODIFIES: data
+  //EFFECTS: Replaces the contents of any CharList with a copy of text,
+  //         one character at a time.
+  template <typename Container>
+  void assign_contents(Container &data, std::string_view text,
+                       std::shared_ptr<const void>) {
+      data.clear();
+      for (char c : text) {
+          data.push_back(c);
+      }
+  }
+
+  //MODIFIES: data
+  //EFFECTS: Replaces the contents of a gap buffer with one block copy.
+  inline void assign_contents(GapBuffer<char> &data, std::string_view text,
+                              std::shared_ptr<const void>) {
+      data.assign(text);
+  }
+
+  //MODIFIES: data
+  //EFFECTS: Builds a rope over text bottom-up in linear time.
+  inline void assign_contents(Rope<char> &data, std::string_view text,
+                              std::shared_ptr<const void>) {
+      data.assign(text);
+  }
+
+  //MODIFIES: data
+  //EFFECTS: Makes text, kept alive by owner, a piece table's original
+  //         buffer in place.
+  inline void assign_contents(PieceTable<char> &data, std::string_view text,
+                              std::shared_ptr<const void> owner) {
+      data.assign(text, std::move(owner));
+  }
+
+  //EFFECTS: Returns whether assign_contents() with an owner makes any
+  //         CharList refer to the text in place, rather than copy it.
+  template <typename Container>
+  bool keeps_in_place(const Container &) {
+      return false;
+  }
+
+  inline bool keeps_in_place(const PieceTable<char> &) {
+      return true;
+  }
+
+  //EFFECTS: Returns a reader of a copy of the contents of any CharList,
+  //         made with one pass over its blocks into a single string.
+  template <typename Container>
+  TextSnapshot::Reader snapshot_reader(const Container &data) {
+      auto copy = std::make_shared<std::string>();
+      copy->reserve(data.size());
+      visit_chunks(data, 0, data.size(), [&copy](std::string_view chunk) {
+          copy->append(chunk);
+          return true;
+      }, 0);
+      return [copy](const TextSnapshot::ChunkVisitor &visit) {
+          if (!copy->empty()) {
+              visit(*copy);
+          }
+      };
+  }
+
+  //EFFECTS: Returns a reader of a copy of a CharList that shares its
+  //         blocks with data, so only the structure over them is copied.
+  template <typename Container>
+  TextSnapshot::Reader shared_reader(const Container &data) {
+      auto copy = std::make_shared<const Container>(data);
+      return [copy](const TextSnapshot::ChunkVisitor &visit) {
+          visit_chunks(*copy, 0, copy->size(), visit, 0);
+      };
+  }
+
+  inline TextSnapshot::Reader snapshot_reader(const UnrolledList<char> &data) {
+      return shared_reader(data);
+  }
+
+  inline TextSnapshot::Reader snapshot_reader(const GapBuffer<char> &data) {
+      return shared_reader(data);
+  }
+
+  inline TextSnapshot::Reader snapshot_reader(const PieceTable<char> &data) {
+      return shared_reader(data);
+  }
+
+  inline TextSnapshot::Reader snapshot_reader(const Rope<char> &data) {
+      return shared_reader(data);
+  }
+
+  //EFFECTS: Returns whether snapshot_reader() shares the storage of a
+  //         CharList rather than copying its contents.
+  template <typename Container>
+  bool shares_storage(const Container &) {
+      return false;
+  }
+
+  inline bool shares_storage(const UnrolledList<char> &) {
+      return true;
+  }
+
+  inline bool shares_storage(const GapBuffer<char> &) {
+      return true;
+  }
+
+  inline bool shares_storage(const PieceTable<char> &) {
+      return true;
+  }
+
+  inline bool shares_storage(const Rope<char> &) {
+      return true;
+  }
+
+  //MODIFIES: data
+  //EFFECTS: Replaces the contents of any CharList with a copy of text.
+  template <typename Container>
+  void assign_contents(Container &data, std::string &&text) {
+      assign_contents(data, std::string_view(text), nullptr);
+  }
+
+  //MODIFIES: data
+  //EFFECTS: Hands text to a piece table as its original buffer.
+  inline void assign_contents(PieceTable<char> &data, std::string &&text) {
+      data.assign(std::move(text));
+  }
+}
+
 //EFFECTS: Creates an empty text buffer. Its cursor is at the past-the-end
 //         position, with row 1, column 0, and index 0.
-TextBuffer::TextBuffer() {
+template <typename CharList>
+BasicTextBuffer<CharList>::BasicTextBuffer() {
     data.clear();   // data should already be empty, but sanity check
     cursor = data.end();
     row = 1;
-    column = index = 0;
+    column = index = row_start = 0;
+    logged_size = 0;
+    logged_rows = 1;
+    change_log.reserve(MAX_CHANGES); // the log never allocates after this
 }
 
 
@@ -23,7 +233,8 @@ TextBuffer::TextBuffer() {
 //          in which case this does nothing and returns false.
 //NOTE:     Your implementation must update the row, column, and index
 //          if appropriate to maintain all invariants.
-bool TextBuffer::forward() {
+template <typename CharList>
+bool BasicTextBuffer<CharList>::forward() {
     if (cursor == data.end()) {     // if cursor is on the last iterator / node
         return false;
     }
@@ -31,6 +242,7 @@ bool TextBuffer::forward() {
         ++row;
         column = 0;
         ++cursor;
+        row_start = index + 1;
     }
     else {                          // if not newline char, row unchanged, ++column, and ++cursor;
         ++column;
@@ -49,19 +261,21 @@ bool TextBuffer::forward() {
 //          beginning of a line to the end of the previous one.
 //NOTE:     Your implementation must update the row, column, and index
 //          if appropriate to maintain all invariants.
-bool TextBuffer::backward() {
+template <typename CharList>
+bool BasicTextBuffer<CharList>::backward() {
     if (cursor == data.begin()) {   // if cursor is on the first iterator / node
         return false;
     }
     --cursor;
+    --index;            // compute_column() relies on index being current
     if (data_at_cursor() == '\n') {
         --row;
+        row_start = lines.row_start(row);
         column = compute_column();
     }
     else {
         --column;
     }
-    --index;
     return true;
 }
 
@@ -74,20 +288,118 @@ bool TextBuffer::backward() {
 //          character was the last one in the buffer.
 //NOTE:     Your implementation must update the row, column, and index
 //          if appropriate to maintain all invariants.
-bool TextBuffer::remove() {
+template <typename CharList>
+bool BasicTextBuffer<CharList>::remove() {
     if (cursor == data.end()) {     // if cursor is on the last iterator / node
         return false;
     }
     
-    --index;            // index decreases either way
-    data.erase(cursor);    // TODO: do i need to do cursor =?
-    // column doesn't change either way
-    if (data_at_cursor() == '\n') {    // if erasing newline, gets rid of a row, so row decrements and column doesn't change
-        --row;
+    bool newline = data_at_cursor() == '\n';
+    if (newline) {
+        lines.join_rows(row);
     }
+    else {
+        lines.resize_row(row, -1);
+    }
+    // erase hands back the element that followed the removed one, so the
+    // cursor stays valid; row, column, and index are all unchanged
+    cursor = data.erase(cursor);
+    log_change(index, row, 1, newline, 0, 0);
     return true;
 }
 
+//REQUIRES: count >= 0
+//MODIFIES: *this
+//EFFECTS:  Removes up to count characters starting at the cursor and
+//          returns the number of characters removed.
+template <typename CharList>
+int BasicTextBuffer<CharList>::remove(int count) {
+    count = std::min(count, size() - index);
+    if (count <= 0) {
+        return 0;
+    }
+    int removed_rows = lines.erase(row, column, count);
+    // like remove(), row, column, and index are all unchanged
+    cursor = data.erase(cursor, iterator_at(data, cursor, index,
+                                            index + count, 0));
+    log_change(index, row, count, removed_rows, 0, 0);
+    return count;
+}
+
+//REQUIRES: 0 <= begin <= end <= size()
+//MODIFIES: *this
+//EFFECTS:  Moves the cursor to index begin and removes the characters
+//          with indices in [begin, end).
+template <typename CharList>
+void BasicTextBuffer<CharList>::remove_range(int begin, int end) {
+    seek_index(begin);
+    remove(end - begin);
+}
+
+//REQUIRES: ranges are (index, length) pairs in increasing order of
+//          index that do not overlap, each within [0, size()]
+//MODIFIES: *this
+//EFFECTS:  Replaces the characters in each range with replacement, as
+//          one remove() and one insert() of the text they span. An
+//          empty range inserts replacement at its index.
+template <typename CharList>
+void BasicTextBuffer<CharList>::replace_all(
+    const std::vector<std::pair<int, int>> &ranges,
+    std::string_view replacement) {
+    if (ranges.empty()) {
+        return;
+    }
+    int first = ranges.front().first;
+    int last = ranges.back().first + ranges.back().second;
+    long long new_size = last - first;
+    for (const std::pair<int, int> &range : ranges) {
+        new_size += static_cast<long long>(replacement.size()) - range.second;
+    }
+
+    // where the cursor goes, shifted by each range wholly before it
+    int new_index = index;
+    long long shift = 0;
+    for (const std::pair<int, int> &range : ranges) {
+        if (range.first + range.second > index) {
+            new_index = std::min(index, range.first);
+            break;
+        }
+        shift += static_cast<long long>(replacement.size()) - range.second;
+    }
+    new_index += shift;
+
+    std::string text;
+    text.reserve(new_size);
+    std::size_t next = 0;   // the first range not replaced yet
+    int at = first;         // index of the chunk's first character
+    int copied = first;     // the characters before this are in text
+    for_each_chunk(first, last, [&](std::string_view chunk) {
+        int chunk_end = at + chunk.size();
+        for (; next < ranges.size() && ranges[next].first < chunk_end;
+             ++next) {
+            text.append(chunk.substr(copied - at,
+                                     ranges[next].first - copied));
+            text.append(replacement);
+            copied = ranges[next].first + ranges[next].second;
+        }
+        if (copied < chunk_end) {
+            text.append(chunk.substr(copied - at));
+            copied = chunk_end;
+        }
+        at = chunk_end;
+        return true;
+    });
+    // empty ranges at the end of the span lie past every chunk
+    for (; next < ranges.size(); ++next) {
+        text.append(replacement);
+    }
+
+    seek_index(first);
+    remove(last - first);
+    insert(text);   // logged together with the removal
+    seek_index(new_index);
+}
+
 //MODIFIES: *this
 //EFFECTS:  Inserts a character in the buffer before the cursor position.
 //          If the cursor is at the past-the-end position, this means the
@@ -95,35 +407,65 @@ bool TextBuffer::remove() {
 //          The cursor remains in the same place as before the insertion.
 //NOTE:     Your implementation must update the row, column, and index
 //          if appropriate to maintain all invariants.
-void TextBuffer::insert(char c) {
-    data.insert(cursor, c); // inserting char 'c' right before cursor location - func takes care of edge cases
+template <typename CharList>
+void BasicTextBuffer<CharList>::insert(char c) {
+    // inserting char 'c' right before cursor location - func takes care of edge cases.
+    // Chunked storage may move the cursor's element, so step past the new char
+    // instead of assuming the old iterator is still valid
+    cursor = data.insert(cursor, c);
+    ++cursor;
+    int at = index, at_row = row;
     if (c == '\n') {    // if newline, new row and column resets
+        lines.split_row(row, column);
         ++row;
         column = 0;
+        row_start = index + 1;
     }
     else {              // if not newline, same row, column increases by 1
+        lines.resize_row(row, 1);
         ++column;
     }
     ++index;            // index increases either way
+    // logged once the rows are counted, like the other edits
+    log_change(at, at_row, 0, 0, 1, c == '\n');
+}
+
+//MODIFIES: *this
+//EFFECTS:  Inserts text in the buffer before the cursor position, with
+//          the same result as inserting its characters one at a time.
+template <typename CharList>
+void BasicTextBuffer<CharList>::insert(std::string_view text) {
+    if (text.empty()) {
+        return;
+    }
+    int length = text.size();
+    int new_rows = std::count(text.begin(), text.end(), '\n');
+    lines.insert(row, column, text);
+    // insert hands back the first new char; the cursor's char follows
+    // the last one
+    cursor = data.insert(cursor, text.begin(), text.end());
+    cursor = iterator_at(data, cursor, index, index + length, 0);
+    log_change(index, row, 0, 0, length, new_rows);
+    std::size_t last_newline = text.rfind('\n');
+    if (last_newline == std::string_view::npos) {
+        column += length;
+    }
+    else {              // the cursor ends up in the row after the last newline
+        row += new_rows;
+        row_start = index + last_newline + 1;
+        column = index + length - row_start;
+    }
+    index += length;
 }
 
 //MODIFIES: *this
 //EFFECTS:  Moves the cursor to the start of the current row (column 0).
 //NOTE:     Your implementation must update the row, column, and index
 //          if appropriate to maintain all invariants.
-void TextBuffer::move_to_row_start() {
-    do {
-        --cursor;
-        --index;
-    }
-    while(data_at_cursor() != '\n' && cursor != data.begin()); // if cursor value isn't newline AND if cursor isn't first node
-    
-    if (data_at_cursor() == '\n') { // cursor get's reset to first char in row
-        ++cursor;
-        ++index;
-    }
-    // column reset to 0, row get's unchanged;
-    column = 0;
+template <typename CharList>
+void BasicTextBuffer<CharList>::move_to_row_start() {
+    jump_to_column(0);
+    // row get's unchanged
   }
 
 //MODIFIES: *this
@@ -132,19 +474,11 @@ void TextBuffer::move_to_row_start() {
 //          position if the row is the last one in the buffer).
 //NOTE:     Your implementation must update the row, column, and index
 //          if appropriate to maintain all invariants.
-void TextBuffer::move_to_row_end() {
-    // order of while loop conditions important here bc you can't do a data_at_cursor at end() iterator
-    //std::cout << "Entering move_to_row_end()" << std::endl;
-    
-    //std::cout << "Index 1: " << index << std::endl;
-
-    while (cursor != data.end() && data_at_cursor() != '\n') {  // cursor only increments if not at end of row already
-        ++cursor;
-        ++index;
-    }
-    //std::cout << "Index 2: " << index << std::endl;
-    // column value changes, row stays the same
-    column = compute_column();
+template <typename CharList>
+void BasicTextBuffer<CharList>::move_to_row_end() {
+    // the line index knows the row's length, so there is no need to
+    // look for the newline; column value changes, row stays the same
+    jump_to_column(row_end_column());
 }
 
 //REQUIRES: new_column >= 0
@@ -156,22 +490,11 @@ void TextBuffer::move_to_row_end() {
 //          the last one in the buffer).
 //NOTE:     Your implementation must update the row, column, and index
 //          if appropriate to maintain all invariants.
-void TextBuffer::move_to_column(int new_column) {
-    //std::cout << "Entering move_to_column()" << std::endl;
-
-    // TODO: check to see if condition where new_column == column should be included
-    //std::cout << "New Column: " << new_column << std::endl;
-    //std::cout << "Column 1: " << column << std::endl;
-
-    move_to_row_end();
-    //std::cout << "Column 2: " << column << std::endl;
-    //std::cout << "Index 3: " << index << std::endl;
-
-    if (new_column < column) {
-        while (column != new_column) {
-            backward(); // decrements cursor backwards and all other invariants
-        }
-    }
+template <typename CharList>
+void BasicTextBuffer<CharList>::move_to_column(int new_column) {
+    // move by the difference in columns instead of going to the row end
+    // and walking back
+    jump_to_column(std::min(new_column, row_end_column()));
 }
 
 
@@ -189,7 +512,8 @@ void TextBuffer::move_to_column(int new_column) {
 //          not (i.e. if the cursor was already in the first row).
 //NOTE:     Your implementation must update the row, column, and index
 //          if appropriate to maintain all invariants.
-bool TextBuffer::up() {
+template <typename CharList>
+bool BasicTextBuffer<CharList>::up() {
     //std::cout << "Entering up()" << std::endl;
     if (row == 1) {
         return false;
@@ -200,7 +524,7 @@ bool TextBuffer::up() {
         move_to_row_start();    // go to beginning of row, to keep track of index
         backward();             // go back one to previous row's \n
         //std::cout << "Index 0: " << index << std::endl;
-        move_to_column(original_row_column);             // move to row end
+        move_to_column(original_row_column);             // or the row end if shorter
         //std::cout << "Entering up()" << std::endl;
         return true;
     }
@@ -217,7 +541,8 @@ bool TextBuffer::up() {
 //          not (i.e. if the cursor was already in the last row).
 //NOTE:     Your implementation must update the row, column, and index
 //          if appropriate to maintain all invariants.
-bool TextBuffer::down() {
+template <typename CharList>
+bool BasicTextBuffer<CharList>::down() {
     int original_row_column = column;
     move_to_row_end();
     if (is_at_end()) {                               // if we're at the end of the buffer, there's no more rows
@@ -225,12 +550,60 @@ bool TextBuffer::down() {
         return false;                                // And return false
     }
     forward();                              // step into the new row
-    move_to_column(original_row_column);    // func defaults to end of row and walks backwards to original_row_column
+    move_to_column(original_row_column);    // jumps straight to original_row_column, or the row end
     return true;
 }
 
+//REQUIRES: new_row >= 1
+//MODIFIES: *this
+//EFFECTS:  Moves the cursor to the start of the given row, or of the
+//          last row if there are fewer rows, without walking the rows
+//          in between.
+template <typename CharList>
+void BasicTextBuffer<CharList>::seek_row(int new_row) {
+    seek(new_row, 0);
+}
+
+//REQUIRES: new_row >= 1, new_column >= 0
+//MODIFIES: *this
+//EFFECTS:  Moves the cursor to the given row like seek_row(), then to
+//          the given column like move_to_column().
+template <typename CharList>
+void BasicTextBuffer<CharList>::seek(int new_row, int new_column) {
+    row = lines.rows_up_to(std::max(new_row, 1));
+    row_start = lines.row_start(row);
+    // the cursor is still at its old index until it jumps
+    column = index - row_start;
+    jump_to_column(std::min(std::max(new_column, 0), row_end_column()));
+}
+
+//REQUIRES: 0 <= new_index <= size()
+//MODIFIES: *this
+//EFFECTS:  Moves the cursor to the given index, finding its row and
+//          column in O(log rows).
+template <typename CharList>
+void BasicTextBuffer<CharList>::seek_index(int new_index) {
+    int new_column = new_index;
+    int new_row = lines.locate(new_column);
+    seek(new_row, new_column);
+}
+
+//EFFECTS:  Returns the number of rows in the buffer (at least 1).
+template <typename CharList>
+int BasicTextBuffer<CharList>::row_count() const {
+    return lines.row_count();
+}
+
+//EFFECTS:  Returns the smaller of row_count() and limit, reading text
+//          assigned in place only as far as row limit.
+template <typename CharList>
+int BasicTextBuffer<CharList>::rows_up_to(int limit) const {
+    return lines.rows_up_to(limit);
+}
+
 //EFFECTS:  Returns whether the cursor is at the past-the-end position.
-  bool TextBuffer::is_at_end() const {
+  template <typename CharList>
+  bool BasicTextBuffer<CharList>::is_at_end() const {
       if (cursor == data.end()) {
           return true;
       }
@@ -239,25 +612,29 @@ bool TextBuffer::down() {
 
 //REQUIRES: the cursor is not at the past-the-end position
 //EFFECTS:  Returns the character at the current cursor
-  char TextBuffer::data_at_cursor() const {
+  template <typename CharList>
+  char BasicTextBuffer<CharList>::data_at_cursor() const {
       assert(!is_at_end());
       return *cursor;
   }
 
 //EFFECTS:  Returns the row of the character at the current cursor.
-  int TextBuffer::get_row() const {
+  template <typename CharList>
+  int BasicTextBuffer<CharList>::get_row() const {
       return row;
   }
 
 //EFFECTS:  Returns the column of the character at the current cursor.
-  int TextBuffer::get_column() const {
+  template <typename CharList>
+  int BasicTextBuffer<CharList>::get_column() const {
       return column;
   }
 
 //EFFECTS:  Returns the index of the character at the current cursor
 //          with respect to the entire contents. If the cursor is at
 //          the past-the-end position, returns size() as the index.
-  int TextBuffer::get_index() const {
+  template <typename CharList>
+  int BasicTextBuffer<CharList>::get_index() const {
       if (is_at_end()) {
           return size();
       }
@@ -265,17 +642,212 @@ bool TextBuffer::down() {
   }
 
 //EFFECTS:  Returns the number of characters in the buffer.
-  int TextBuffer::size() const {
+  template <typename CharList>
+  int BasicTextBuffer<CharList>::size() const {
       return data.size();
   }
 
+//REQUIRES: 0 <= index <= size()
+//MODIFIES: begin, end
+//EFFECTS:  Sets [begin, end) to the row that holds the character at
+//          index (the last row for size()), not counting its '\n'.
+template <typename CharList>
+void BasicTextBuffer<CharList>::row_range(int index, int &begin,
+                                          int &end) const {
+    int column = index;
+    int row = lines.locate(column);
+    begin = index - column;
+    end = begin + lines.row_length(row) - (lines.is_last_row(row) ? 0 : 1);
+}
+
+//MODIFIES: *this
+//EFFECTS:  Replaces the contents of the buffer with text and moves the
+//          cursor to the start, with row 1, column 0, and index 0.
+template <typename CharList>
+void BasicTextBuffer<CharList>::assign(std::string text) {
+    lines.assign(text);
+    assign_contents(data, std::move(text));
+    start_over();
+}
+
+//REQUIRES: text stays valid and unchanged as long as owner is alive
+//MODIFIES: *this
+//EFFECTS:  Replaces the contents of the buffer with text like
+//          assign(std::string), referring to text in place where the
+//          storage can.
+template <typename CharList>
+void BasicTextBuffer<CharList>::assign(std::string_view text,
+                                       std::shared_ptr<const void> owner) {
+    if (keeps_in_place(data)) {
+        lines.assign(text, owner); // text stays where it is to be read
+    } else {
+        lines.assign(text);
+    }
+    assign_contents(data, text, std::move(owner));
+    start_over();
+}
+
 //EFFECTS:  Returns the contents of the text buffer as a string.
 //HINT: Implement this using the string constructor that takes a
 //      begin and end iterator. You may use this implementation:
 //        return std::string(data.begin(), data.end());
-std::string TextBuffer::stringify() const {
-      if (data.empty()) {   // if empty buffer
-          return "";
-      }
-      return std::string(data.begin(), data.end());
+template <typename CharList>
+std::string BasicTextBuffer<CharList>::stringify() const {
+      return substr(0, size());
+}
+
+//REQUIRES: 0 <= begin <= end <= size()
+//EFFECTS:  Calls visit with consecutive views of the characters with
+//          indices in [begin, end), in order, until it returns false.
+template <typename CharList>
+void BasicTextBuffer<CharList>::for_each_chunk(
+    int begin, int end, const ChunkVisitor &visit) const {
+    if (begin < end) {
+        visit_chunks(data, begin, end, visit, 0);
+    }
+}
+
+//EFFECTS:  Calls visit with consecutive views of the whole contents, in
+//          order, until it returns false.
+template <typename CharList>
+void BasicTextBuffer<CharList>::for_each_chunk(
+    const ChunkVisitor &visit) const {
+    for_each_chunk(0, size(), visit);
+}
+
+//REQUIRES: 0 <= begin <= size(), length >= 0
+//EFFECTS:  Returns the (up to) length characters starting at index
+//          begin, copying only those characters.
+template <typename CharList>
+std::string BasicTextBuffer<CharList>::substr(int begin, int length) const {
+    std::string result;
+    int end = begin + std::min(length, size() - begin);
+    result.reserve(end - begin);
+    for_each_chunk(begin, end, [&result](std::string_view chunk) {
+        result.append(chunk);
+        return true;
+    });
+    return result;
+}
+
+//EFFECTS:  Returns a snapshot of the contents, sharing the storage if
+//          it can and copying the characters otherwise.
+template <typename CharList>
+TextSnapshot BasicTextBuffer<CharList>::snapshot() const {
+    return TextSnapshot(size(), snapshot_reader(data));
+}
+
+//EFFECTS:  Returns whether snapshot() shares the storage.
+template <typename CharList>
+bool BasicTextBuffer<CharList>::snapshot_is_cheap() const {
+    return shares_storage(data);
+}
+
+//EFFECTS:  Returns the edits made since the last clear_changes(), in
+//          order.
+template <typename CharList>
+const std::vector<TextChange> &BasicTextBuffer<CharList>::changes() const {
+    return change_log;
+}
+
+//MODIFIES: *this
+//EFFECTS:  Empties the change log, keeping its storage.
+template <typename CharList>
+void BasicTextBuffer<CharList>::clear_changes() {
+    change_log.clear();
+    logged_size = size();
+    logged_rows = lines.rows_found();
+}
+
+//REQUIRES: removed or inserted is 0, and the edit has been made
+//MODIFIES: *this
+//EFFECTS: Adds the insertion or removal at index `at` in row `at_row`
+//         to the change log.
+template <typename CharList>
+void BasicTextBuffer<CharList>::log_change(int at, int at_row,
+                                           int removed, int removed_rows,
+                                           int inserted, int inserted_rows) {
+    if (!change_log.empty()) {
+        TextChange &last = change_log.back();
+        int last_end = last.index + last.inserted;
+        if (removed == 0 && last.index <= at && at <= last_end) {
+            // inserting within or right next to the last edit's text
+            last.inserted += inserted;
+            last.inserted_rows += inserted_rows;
+            return;
+        }
+        if (inserted == 0 && last.index <= at && at + removed <= last_end) {
+            // removing text the last edit inserted
+            last.inserted -= removed;
+            last.inserted_rows -= removed_rows;
+            return;
+        }
+        if (inserted == 0 && at == last_end) {
+            // removing the text right after the last edit (delete key)
+            last.removed += removed;
+            last.removed_rows += removed_rows;
+            return;
+        }
+        if (inserted == 0 && at + removed == last.index) {
+            // removing the text right before the last edit (backspace)
+            last.index = at;
+            last.row = at_row;
+            last.removed += removed;
+            last.removed_rows += removed_rows;
+            return;
+        }
+    }
+    if (static_cast<int>(change_log.size()) == MAX_CHANGES) {
+        // too many edits to be worth listing: replace the whole buffer
+        change_log.assign(1, {0, 1, logged_size, logged_rows - 1,
+                              size(), lines.rows_found() - 1});
+        return;
+    }
+    change_log.push_back({at, at_row, removed, removed_rows,
+                          inserted, inserted_rows});
 }
+
+//MODIFIES: *this
+//EFFECTS: Moves the cursor to the start of newly assigned contents and
+//         logs them as replacing the whole buffer.
+template <typename CharList>
+void BasicTextBuffer<CharList>::start_over() {
+    cursor = data.begin();
+    row = 1;
+    column = index = row_start = 0;
+    // whatever was logged before, the net change is the whole buffer
+    change_log.assign(1, {0, 1, logged_size, logged_rows - 1,
+                          size(), lines.rows_found() - 1});
+}
+
+//EFFECTS: Returns the column of the end of the current row: its
+//         newline, or the past-the-end position for the last row.
+template <typename CharList>
+int BasicTextBuffer<CharList>::row_end_column() const {
+    int length = lines.row_length(row);
+    // every row but the last ends in a newline
+    return lines.is_last_row(row) ? length : length - 1;
+}
+
+//REQUIRES: 0 <= new_column <= row_end_column()
+//MODIFIES: *this
+//EFFECTS: Moves the cursor straight to new_column of the current row,
+//         without stepping through the characters in between when the
+//         storage can jump to an index.
+template <typename CharList>
+void BasicTextBuffer<CharList>::jump_to_column(int new_column) {
+    int target = row_start + new_column;
+    cursor = iterator_at(data, cursor, index, target, 0);
+    index = target;
+    column = new_column;
+}
+
+// Compile every storage engine here so any of them can back a buffer
+// (see TEXTBUFFER_ENGINE in TextBuffer.hpp) while the member definitions
+// stay out of the header.
+template class BasicTextBuffer<std::list<char>>;
+template class BasicTextBuffer<List<char>>;
+template class BasicTextBuffer<UnrolledList<char>>;
+template class BasicTextBuffer<GapBuffer<char>>;
+template class BasicTextBuffer<PieceTable<char>>;
+template class BasicTextBuffer<Rope<char>>;
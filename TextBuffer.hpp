@@ -9,25 +9,95 @@
  * EECS 280 Project 4
  */
 
+#include <functional>
 #include <list>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 // Uncomment the following line to use your List implementation
 #include "List.hpp"
+#include "UnrolledList.hpp"
+#include "GapBuffer.hpp"
+#include "PieceTable.hpp"
+#include "Rope.hpp"
+#include "LineIndex.hpp"
 
-class TextBuffer {
-  // Comment out the following two lines and uncomment the two below
-  // to use your List implementation
-  //using CharList = std::list<char>;
-  //using Iterator = std::list<char>::iterator;
-  using CharList = List<char>;
-  using Iterator = List<char>::Iterator;
+#ifndef TEXTBUFFER_ENGINE // default storage engine for TextBuffer
+#  define TEXTBUFFER_ENGINE GapBuffer
+#endif
+
+// One entry in a text buffer's change log: the characters with indices
+// [index, index + removed) before the edit were replaced by those with
+// indices [index, index + inserted) after it. The edit starts in `row`,
+// so rows [row, row + removed_rows] became [row, row + inserted_rows].
+struct TextChange {
+  int index;
+  int row;
+  int removed;
+  int removed_rows;        // newlines among the removed characters
+  int inserted;
+  int inserted_rows;       // newlines among the inserted characters
+};
+
+// A copy of a text buffer's contents at one point in time. It never
+// changes, and it shares nothing that the buffer goes on to modify, so
+// it can be read on another thread while the buffer is being edited.
+class TextSnapshot {
+public:
+  // Called with each view of the contents; returns whether to go on.
+  using ChunkVisitor = std::function<bool(std::string_view)>;
+  // Calls a visitor with the views of a copy, in order.
+  using Reader = std::function<void(const ChunkVisitor &)>;
+
+  //EFFECTS: Creates an empty snapshot.
+  TextSnapshot() : length(0), reader([](const ChunkVisitor &) {}) {}
+
+  //REQUIRES: reader_in reads length_in characters that never change
+  //EFFECTS:  Creates a snapshot that is read with reader_in.
+  TextSnapshot(int length_in, Reader reader_in)
+    : length(length_in), reader(std::move(reader_in)) {}
+
+  //EFFECTS: Returns the number of characters in the snapshot.
+  int size() const {
+    return length;
+  }
+
+  //EFFECTS: Calls visit with consecutive views of the contents, in
+  //         order, until it returns false. A view is only valid during
+  //         the call.
+  void for_each_chunk(const ChunkVisitor &visit) const {
+    reader(visit);
+  }
 
 private:
-  CharList data;           // linked list that contains the characters
+  int length;
+  Reader reader;
+};
+
+template <typename CharList>
+class BasicTextBuffer {
+  //OVERVIEW: CharList is the storage engine that holds the characters:
+  //          std::list<char>, List<char>, UnrolledList<char>,
+  //          GapBuffer<char>, PieceTable<char>, Rope<char>, or any other
+  //          container with List's interface. It is fixed at compile
+  //          time, so calls into it are direct (and usually inlined).
+  //          TextBuffer.cpp instantiates every engine above.
+  using Iterator = decltype(std::declval<CharList &>().begin());
+
+private:
+  CharList data;           // container that holds the characters
   Iterator cursor;         // iterator to current element in the list
   int row;                 // current row
   int column;              // current column
   int index;               // current index
+  int row_start;           // index of the first character in the row
+  mutable LineIndex lines; // start and length of every row, found as
+                           // they are needed for text assigned in place
+  std::vector<TextChange> change_log; // edits since the last clear_changes()
+  int logged_size;         // size() at the last clear_changes()
+  int logged_rows;         // rows found at the last clear_changes()
 
   // INVARIANT (cursor iterator):
   //   `cursor` points at an actual character in the list, or is
@@ -45,6 +115,18 @@ private:
   //   list if the cursor is at the past-the-end position.
   //   0 <= index <= data.size()
 
+  // INVARIANT: (lines)
+  //   `lines` holds the length of every row of the buffer, so that
+  //   lines.row_start(row) + column == index.
+
+  // INVARIANT: (row_start)
+  //   row_start == lines.row_start(row), i.e. index - column.
+
+  // INVARIANT: (change_log)
+  //   Applying the changes in change_log in order to the contents at the
+  //   last clear_changes() (logged_size characters, in which logged_rows
+  //   rows had been found) gives the current contents.
+
   // The above invariants are established by the constructor and are
   // assumed to hold at the start of any member function call (i.e.
   // they are implicit conditions in the REQUIRES clause). Each function
@@ -54,7 +136,7 @@ private:
 public:
   //EFFECTS: Creates an empty text buffer. Its cursor is at the past-the-end
   //         position, with row 1, column 0, and index 0.
-  TextBuffer();
+  BasicTextBuffer();
 
   //MODIFIES: *this
   //EFFECTS:  Moves the cursor one position forward and returns true,
@@ -84,6 +166,13 @@ public:
   //          if appropriate to maintain all invariants.
   void insert(char c);
 
+  //MODIFIES: *this
+  //EFFECTS:  Inserts text in the buffer before the cursor position, with
+  //          the same result as inserting its characters one at a time.
+  //          The storage gets the whole text in one splice and the row,
+  //          column, index, and line index are updated once.
+  void insert(std::string_view text);
+
   //MODIFIES: *this
   //EFFECTS:  Removes the character from the buffer that is at the cursor and
   //          returns true, unless the cursor is at the past-the-end position,
@@ -95,6 +184,35 @@ public:
   //          if appropriate to maintain all invariants.
   bool remove();
 
+  //REQUIRES: count >= 0
+  //MODIFIES: *this
+  //EFFECTS:  Removes up to count characters starting at the cursor, with
+  //          the same result as calling remove() count times, and returns
+  //          the number of characters removed. The storage erases them
+  //          as one range.
+  int remove(int count);
+
+  //REQUIRES: 0 <= begin <= end <= size()
+  //MODIFIES: *this
+  //EFFECTS:  Moves the cursor to index begin and removes the characters
+  //          with indices in [begin, end).
+  void remove_range(int begin, int end);
+
+  //REQUIRES: ranges are (index, length) pairs in increasing order of
+  //          index that do not overlap, each within [0, size()]
+  //MODIFIES: *this
+  //EFFECTS:  Replaces the characters in each range with replacement, as
+  //          one edit: the text from the first range to the end of the
+  //          last is copied once with the replacements made, then
+  //          spliced in with one remove() and one insert(), so the
+  //          storage, line index and change log are updated once however
+  //          many ranges there are. The cursor stays on the character it
+  //          was on, or goes to the start of the replacement of a range
+  //          it was inside. An empty range, e.g. a match of a regex that
+  //          can match nothing, inserts replacement at its index.
+  void replace_all(const std::vector<std::pair<int, int>> &ranges,
+                   std::string_view replacement);
+
   //MODIFIES: *this
   //EFFECTS:  Moves the cursor to the start of the current row (column 0).
   //NOTE:     Your implementation must update the row, column, and index
@@ -145,6 +263,37 @@ public:
   //          if appropriate to maintain all invariants.
   bool down();
 
+  //REQUIRES: new_row >= 1
+  //MODIFIES: *this
+  //EFFECTS:  Moves the cursor to the start of the given row, or of the
+  //          last row if there are fewer rows, without walking the rows
+  //          in between. Takes O(log rows) to find the row, plus
+  //          whatever the storage needs to reach an index: a short
+  //          walk from the cursor when it is near, else O(1) for
+  //          GapBuffer and O(log n) for Rope.
+  void seek_row(int new_row);
+
+  //REQUIRES: new_row >= 1, new_column >= 0
+  //MODIFIES: *this
+  //EFFECTS:  Moves the cursor to the given row like seek_row(), then to
+  //          the given column like move_to_column().
+  void seek(int new_row, int new_column);
+
+  //REQUIRES: 0 <= new_index <= size()
+  //MODIFIES: *this
+  //EFFECTS:  Moves the cursor to the given index, finding its row and
+  //          column in O(log rows), e.g. to go to a match found with
+  //          for_each_chunk().
+  void seek_index(int new_index);
+
+  //EFFECTS:  Returns the number of rows in the buffer (at least 1).
+  //          For text assigned in place, this reads all of it.
+  int row_count() const;
+
+  //EFFECTS:  Returns the smaller of row_count() and limit, reading text
+  //          assigned in place only as far as row limit.
+  int rows_up_to(int limit) const;
+
   //EFFECTS:  Returns whether the cursor is at the past-the-end position.
   bool is_at_end() const;
 
@@ -166,30 +315,123 @@ public:
   //EFFECTS:  Returns the number of characters in the buffer.
   int size() const;
 
+  //REQUIRES: 0 <= index <= size()
+  //MODIFIES: begin, end
+  //EFFECTS:  Sets [begin, end) to the row that holds the character at
+  //          index (the last row for size()), not counting its '\n'.
+  void row_range(int index, int &begin, int &end) const;
+
+  //MODIFIES: *this
+  //EFFECTS:  Replaces the contents of the buffer with text and moves the
+  //          cursor to the start, with row 1, column 0, and index 0.
+  //          Storage that can adopt a string wholesale (e.g. PieceTable)
+  //          takes text without copying it.
+  void assign(std::string text);
+
+  //REQUIRES: text stays valid and unchanged as long as owner is alive
+  //MODIFIES: *this
+  //EFFECTS:  Replaces the contents of the buffer with text like
+  //          assign(std::string). Storage that can refer to text in place
+  //          (PieceTable) keeps owner and reads text where it is, e.g.
+  //          in a memory-mapped file, so only the parts of it that are
+  //          looked at are ever brought into memory; other storage
+  //          copies text. Its rows are then found as they are looked
+  //          up, SCAN_BLOCK characters at a time (see LineIndex), so
+  //          assigning takes O(1) however long text is.
+  void assign(std::string_view text, std::shared_ptr<const void> owner);
+
   //EFFECTS:  Returns the contents of the text buffer as a string.
   //HINT: Implement this using the string constructor that takes a
   //      begin and end iterator. You may use this implementation:
   //        return std::string(data.begin(), data.end());
   std::string stringify() const;
 
+  // Called with each view of the contents; returns whether to go on.
+  using ChunkVisitor = std::function<bool(std::string_view)>;
+
+  //REQUIRES: 0 <= begin <= end <= size()
+  //EFFECTS:  Calls visit with consecutive views of the characters with
+  //          indices in [begin, end), in order, until it returns false.
+  //          Storage that keeps characters in blocks (GapBuffer,
+  //          UnrolledList, PieceTable, Rope) is viewed in place, one
+  //          view per block, without copying; other storage is copied a
+  //          small block at a time. A view is only valid during the call.
+  void for_each_chunk(int begin, int end, const ChunkVisitor &visit) const;
+
+  //EFFECTS:  Calls visit with consecutive views of the whole contents, in
+  //          order, until it returns false.
+  void for_each_chunk(const ChunkVisitor &visit) const;
+
+  //REQUIRES: 0 <= begin <= size(), length >= 0
+  //EFFECTS:  Returns the (up to) length characters starting at index
+  //          begin, copying only those characters.
+  std::string substr(int begin, int length) const;
+
+  //EFFECTS:  Returns a snapshot of the contents. UnrolledList, GapBuffer,
+  //          PieceTable and Rope share their blocks of characters with
+  //          the snapshot, copying only the structure over them;
+  //          std::list and List are copied into one string.
+  TextSnapshot snapshot() const;
+
+  //EFFECTS:  Returns whether snapshot() shares the storage, so that it
+  //          copies no characters, only pointers to blocks of them.
+  bool snapshot_is_cheap() const;
+
+  //EFFECTS:  Returns the edits made since the last clear_changes(), in
+  //          order. An edit that touches the one before it (typing or
+  //          deleting a run of characters) extends that entry instead of
+  //          adding one, and a long log collapses into a single entry
+  //          that replaces the whole buffer. Such an entry, like the one
+  //          assign() logs, counts only the rows found so far of text
+  //          assigned in place, so the rows it changes are all those
+  //          from its row to the end of the text.
+  const std::vector<TextChange> &changes() const;
+
+  //MODIFIES: *this
+  //EFFECTS:  Empties the change log. Its storage is kept, so logging the
+  //          next edits does not allocate.
+  void clear_changes();
+
 private:
+  // Longest the change log gets before it collapses into one entry.
+  static const int MAX_CHANGES = 64;
+
+  //REQUIRES: removed or inserted is 0, and the edit has been made
+  //MODIFIES: *this
+  //EFFECTS: Adds the insertion or removal at index `at` in row `at_row`
+  //         to the change log.
+    void log_change(int at, int at_row, int removed, int removed_rows,
+                    int inserted, int inserted_rows);
+
   //EFFECTS: Computes the column of the cursor within the current row.
   //NOTE: This does not assume that the "column" member variable has
-  //      a correct value (i.e. the row/column INVARIANT can be broken).
+  //      a correct value (i.e. the row/column INVARIANT can be broken),
+  //      only that row_start is the start of the current row.
     int compute_column() const {
-        if (row == 1) {
-            return index;
-        }
-        else {
-            int temp = 0;
-            Iterator temp_cursor(cursor);
-            do {
-                --temp_cursor;
-                ++temp;
-            } while (*temp_cursor != '\n');
-            return (temp - 1);
-        }
+        return index - row_start;
     }
+
+  //MODIFIES: *this
+  //EFFECTS: Moves the cursor to the start of newly assigned contents and
+  //         logs them as replacing the whole buffer.
+    void start_over();
+
+  //EFFECTS: Returns the column of the end of the current row: its
+  //         newline, or the past-the-end position for the last row.
+    int row_end_column() const;
+
+  //REQUIRES: 0 <= new_column <= row_end_column()
+  //MODIFIES: *this
+  //EFFECTS: Moves the cursor straight to new_column of the current row,
+  //         without stepping through the characters in between when the
+  //         storage can jump to an index.
+    void jump_to_column(int new_column);
 };
 
+// The text buffer used by the editors and tests. Its storage engine is
+// chosen per build with -DTEXTBUFFER_ENGINE=<container template>, e.g.
+// -DTEXTBUFFER_ENGINE=Rope or -DTEXTBUFFER_ENGINE=std::list (see the
+// per-engine targets in the Makefile).
+using TextBuffer = BasicTextBuffer<TEXTBUFFER_ENGINE<char>>;
+
 #endif // TEXTBUFFER_HPP
@@ -1,6 +1,14 @@
 #include "TextBuffer.hpp"
 #include "unit_test_framework.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 using namespace std;
 
 // Add your test cases here
@@ -47,6 +55,535 @@ TEST(test_forward) {
     ASSERT_EQUAL(buffer.data_at_cursor() , 'G');
 }
 
+TEST(test_assign) {
+    TextBuffer buffer;
+    buffer.insert('x');
+    buffer.assign("ab\ncd\n");
+    ASSERT_EQUAL(buffer.stringify(), "ab\ncd\n");
+    ASSERT_EQUAL(buffer.size(), 6);
+    ASSERT_EQUAL(buffer.get_row(), 1);
+    ASSERT_EQUAL(buffer.get_column(), 0);
+    ASSERT_EQUAL(buffer.get_index(), 0);
+    ASSERT_EQUAL(buffer.data_at_cursor(), 'a');
+    ASSERT_TRUE(buffer.down());
+    ASSERT_EQUAL(buffer.data_at_cursor(), 'c');
+    buffer.insert('!');
+    ASSERT_EQUAL(buffer.stringify(), "ab\n!cd\n");
+    buffer.assign("");
+    ASSERT_TRUE(buffer.is_at_end());
+    ASSERT_EQUAL(buffer.get_index(), 0);
+}
+
+TEST(test_seek) {
+    TextBuffer buffer;
+    buffer.assign("first\nsecond row\n\nlast");
+    ASSERT_EQUAL(buffer.row_count(), 4);
+    buffer.seek_row(2);
+    ASSERT_EQUAL(buffer.data_at_cursor(), 's');
+    ASSERT_EQUAL(buffer.get_index(), 6);
+    buffer.seek(2, 3);
+    ASSERT_EQUAL(buffer.data_at_cursor(), 'o');
+    ASSERT_EQUAL(buffer.get_column(), 3);
+    buffer.seek(1, 80);             // past the end of a row: its newline
+    ASSERT_EQUAL(buffer.data_at_cursor(), '\n');
+    ASSERT_EQUAL(buffer.get_column(), 5);
+    buffer.seek(9, 80);             // past the last row: end of buffer
+    ASSERT_TRUE(buffer.is_at_end());
+    ASSERT_EQUAL(buffer.get_row(), 4);
+    ASSERT_EQUAL(buffer.get_column(), 4);
+
+    // the index follows edits
+    buffer.seek(2, 6);
+    buffer.insert('\n');            // "second" / " row"
+    buffer.seek(1, 0);
+    buffer.remove();                // "irst"
+    buffer.seek_row(3);
+    ASSERT_EQUAL(buffer.data_at_cursor(), ' ');
+    ASSERT_EQUAL(buffer.get_index(), 12);
+    buffer.seek(1, 4);
+    buffer.remove();                // joins "irst" and "second"
+    ASSERT_EQUAL(buffer.row_count(), 4);
+    buffer.seek_row(4);
+    ASSERT_EQUAL(buffer.stringify(), "irstsecond\n row\n\nlast");
+    ASSERT_EQUAL(buffer.get_index(), 17);
+    ASSERT_TRUE(buffer.backward());
+    ASSERT_EQUAL(buffer.get_row(), 3);
+    ASSERT_EQUAL(buffer.get_column(), 0);
+}
+
+TEST(test_long_row_columns) {
+    // one very long row, like minified JSON, between two short ones
+    TextBuffer buffer;
+    buffer.assign("ab\n" + std::string(100000, 'x') + "\ncd");
+    buffer.seek(2, 99990);
+    ASSERT_TRUE(buffer.up());       // clamps to the newline of row 1
+    ASSERT_EQUAL(buffer.get_column(), 2);
+    ASSERT_EQUAL(buffer.get_index(), 2);
+    buffer.forward();
+    buffer.move_to_column(50000);
+    ASSERT_EQUAL(buffer.get_index(), 50003);
+    buffer.move_to_row_end();
+    ASSERT_EQUAL(buffer.get_column(), 100000);
+    ASSERT_EQUAL(buffer.data_at_cursor(), '\n');
+    buffer.move_to_column(7);
+    ASSERT_EQUAL(buffer.get_index(), 10);
+    ASSERT_TRUE(buffer.down());
+    ASSERT_EQUAL(buffer.get_column(), 2);
+    ASSERT_TRUE(buffer.is_at_end());
+    buffer.move_to_row_start();
+    ASSERT_TRUE(buffer.backward()); // back onto the long row's newline
+    ASSERT_EQUAL(buffer.get_row(), 2);
+    ASSERT_EQUAL(buffer.get_column(), 100000);
+    buffer.insert('y');
+    ASSERT_EQUAL(buffer.get_column(), 100001);
+    buffer.move_to_row_start();
+    ASSERT_EQUAL(buffer.get_index(), 3);
+}
+
+TEST(test_bulk_insert_and_remove) {
+    TextBuffer buffer;
+    buffer.assign("ab\ncd");
+    buffer.seek(1, 1);
+    buffer.insert("XY\nZ\n123");    // "aXY" / "Z" / "123b" / "cd"
+    ASSERT_EQUAL(buffer.stringify(), "aXY\nZ\n123b\ncd");
+    ASSERT_EQUAL(buffer.data_at_cursor(), 'b');
+    ASSERT_EQUAL(buffer.get_row(), 3);
+    ASSERT_EQUAL(buffer.get_column(), 3);
+    ASSERT_EQUAL(buffer.get_index(), 9);
+    ASSERT_EQUAL(buffer.row_count(), 4);
+    buffer.insert("");
+    ASSERT_EQUAL(buffer.get_index(), 9);
+    buffer.insert("++");
+    ASSERT_EQUAL(buffer.get_column(), 5);
+    ASSERT_TRUE(buffer.up());
+    ASSERT_EQUAL(buffer.get_column(), 1);
+
+    // remove across rows, then past the end
+    buffer.seek(1, 2);
+    ASSERT_EQUAL(buffer.remove(6), 6);  // "Y\nZ\n12"
+    ASSERT_EQUAL(buffer.stringify(), "aX3++b\ncd");
+    ASSERT_EQUAL(buffer.data_at_cursor(), '3');
+    ASSERT_EQUAL(buffer.get_row(), 1);
+    ASSERT_EQUAL(buffer.get_column(), 2);
+    ASSERT_EQUAL(buffer.row_count(), 2);
+    ASSERT_TRUE(buffer.down());
+    ASSERT_TRUE(buffer.is_at_end());
+    ASSERT_EQUAL(buffer.get_index(), 9);
+    buffer.remove_range(1, 7);
+    ASSERT_EQUAL(buffer.stringify(), "acd");
+    ASSERT_EQUAL(buffer.get_index(), 1);
+    ASSERT_EQUAL(buffer.row_count(), 1);
+    ASSERT_EQUAL(buffer.remove(80), 2);
+    ASSERT_TRUE(buffer.is_at_end());
+    ASSERT_EQUAL(buffer.remove(1), 0);
+    ASSERT_EQUAL(buffer.stringify(), "a");
+}
+
+// Runs the same edits on a buffer backed by engine CharList and returns
+// the contents followed by the final row, column, and index.
+template <typename CharList>
+std::string edit_script() {
+    BasicTextBuffer<CharList> buffer;
+    for (char c : std::string("one\ntwo\nthree")) {
+        buffer.insert(c);
+    }
+    buffer.up();
+    buffer.remove();
+    buffer.insert('W');
+    buffer.move_to_row_start();
+    buffer.backward();
+    buffer.remove();
+    buffer.down();
+    buffer.move_to_column(2);
+    buffer.seek(1, 4);
+    return buffer.stringify() + " " + std::to_string(buffer.get_row()) + ","
+        + std::to_string(buffer.get_column()) + ","
+        + std::to_string(buffer.get_index());
+}
+
+TEST(test_engines_agree) {
+    const std::string expected = edit_script<std::list<char>>();
+    ASSERT_EQUAL(expected, "onetwoWthree 1,4,4");
+    ASSERT_EQUAL(edit_script<List<char>>(), expected);
+    ASSERT_EQUAL(edit_script<UnrolledList<char>>(), expected);
+    ASSERT_EQUAL(edit_script<GapBuffer<char>>(), expected);
+    ASSERT_EQUAL(edit_script<PieceTable<char>>(), expected);
+    ASSERT_EQUAL(edit_script<Rope<char>>(), expected);
+}
+
+// Runs bulk edits on a buffer backed by engine CharList and returns the
+// contents followed by the final row, column, and index.
+template <typename CharList>
+std::string bulk_edit_script() {
+    BasicTextBuffer<CharList> buffer;
+    buffer.insert(std::string(3000, 'x') + "\none\ntwo\n"
+                  + std::string(3000, 'y'));
+    buffer.seek(2, 1);
+    buffer.insert("\nNEW\n");
+    buffer.remove_range(2990, 3010);    // joins rows 1 to 5
+    buffer.seek(2, 0);
+    buffer.remove(2000);
+    buffer.insert(std::string(2500, 'z'));
+    buffer.up();
+    return std::to_string(buffer.stringify().size()) + " "
+        + buffer.stringify().substr(2985, 20) + " "
+        + std::to_string(buffer.get_row()) + ","
+        + std::to_string(buffer.get_column()) + ","
+        + std::to_string(buffer.get_index());
+}
+
+TEST(test_bulk_engines_agree) {
+    const std::string expected = bulk_edit_script<std::list<char>>();
+    ASSERT_EQUAL(expected, "6494 xxxxxtwo\nzzzzzzzzzzz 1,2500,2500");
+    ASSERT_EQUAL(bulk_edit_script<List<char>>(), expected);
+    ASSERT_EQUAL(bulk_edit_script<UnrolledList<char>>(), expected);
+    ASSERT_EQUAL(bulk_edit_script<GapBuffer<char>>(), expected);
+    ASSERT_EQUAL(bulk_edit_script<PieceTable<char>>(), expected);
+    ASSERT_EQUAL(bulk_edit_script<Rope<char>>(), expected);
+}
+
+// Reads windows of a buffer backed by engine CharList through
+// for_each_chunk and substr, and checks them against stringify().
+template <typename CharList>
+bool chunked_reads_match() {
+    BasicTextBuffer<CharList> buffer;
+    std::string text;
+    for (int i = 0; i < 3000; ++i) {
+        text.push_back(i % 50 == 49 ? '\n' : static_cast<char>('a' + i % 26));
+    }
+    buffer.insert(text);
+    buffer.seek(20, 7);
+    buffer.insert("typed");         // breaks up the storage's blocks
+    text = buffer.stringify();
+    std::string read;
+    buffer.for_each_chunk([&read](std::string_view chunk) {
+        read.append(chunk);
+        return true;
+    });
+    int calls = 0;
+    buffer.for_each_chunk(10, 2000, [&calls](std::string_view) {
+        ++calls;
+        return false;               // stops after the first view
+    });
+    return read == text && calls == 1
+        && buffer.substr(990, 40) == text.substr(990, 40)
+        && buffer.substr(2990, 100) == text.substr(2990)
+        && buffer.substr(7, 0).empty();
+}
+
+TEST(test_chunked_reads) {
+    ASSERT_TRUE(chunked_reads_match<std::list<char>>());
+    ASSERT_TRUE(chunked_reads_match<List<char>>());
+    ASSERT_TRUE(chunked_reads_match<UnrolledList<char>>());
+    ASSERT_TRUE(chunked_reads_match<GapBuffer<char>>());
+    ASSERT_TRUE(chunked_reads_match<PieceTable<char>>());
+    ASSERT_TRUE(chunked_reads_match<Rope<char>>());
+}
+
+TEST(test_row_range) {
+    TextBuffer buffer;
+    buffer.insert("one\n\nthree");
+    int begin = -1, end = -1;
+    buffer.row_range(0, begin, end);
+    ASSERT_EQUAL(begin, 0);
+    ASSERT_EQUAL(end, 3);
+    buffer.row_range(3, begin, end);    // the '\n' belongs to its row
+    ASSERT_EQUAL(begin, 0);
+    ASSERT_EQUAL(end, 3);
+    buffer.row_range(4, begin, end);
+    ASSERT_EQUAL(begin, 4);
+    ASSERT_EQUAL(end, 4);
+    buffer.row_range(buffer.size(), begin, end);
+    ASSERT_EQUAL(begin, 5);
+    ASSERT_EQUAL(end, 10);
+}
+
+// Returns whether change has the given fields.
+static bool change_is(const TextChange &change, int index, int row,
+                      int removed, int removed_rows,
+                      int inserted, int inserted_rows) {
+    return change.index == index && change.row == row
+        && change.removed == removed && change.removed_rows == removed_rows
+        && change.inserted == inserted
+        && change.inserted_rows == inserted_rows;
+}
+
+TEST(test_change_log) {
+    TextBuffer buffer;
+    buffer.assign("ab\ncd\nef");
+    ASSERT_EQUAL(buffer.changes().size(), 1u);
+    ASSERT_TRUE(change_is(buffer.changes()[0], 0, 1, 0, 0, 8, 2));
+    buffer.clear_changes();
+    ASSERT_TRUE(buffer.changes().empty());
+    auto capacity = buffer.changes().capacity();
+
+    // typing, fixing a typo, backspacing and deleting around one spot
+    // is a single entry
+    buffer.seek(2, 1);
+    buffer.insert('x');
+    buffer.insert('\n');
+    buffer.insert('y');             // "ab\ncx\nyd\nef"
+    buffer.backward();
+    buffer.remove();                // "ab\ncx\nd\nef"
+    buffer.seek(2, 0);
+    buffer.remove();                // "ab\nx\nd\nef"
+    buffer.seek(3, 0);
+    buffer.remove(2);               // "ab\nx\nef"
+    ASSERT_EQUAL(buffer.stringify(), "ab\nx\nef");
+    ASSERT_EQUAL(buffer.changes().size(), 1u);
+    ASSERT_TRUE(change_is(buffer.changes()[0], 3, 2, 3, 1, 2, 1));
+
+    // an edit elsewhere is another entry
+    buffer.seek(1, 0);
+    buffer.insert("Q\n");
+    ASSERT_EQUAL(buffer.changes().size(), 2u);
+    ASSERT_TRUE(change_is(buffer.changes()[1], 0, 1, 0, 0, 2, 1));
+    ASSERT_EQUAL(buffer.changes().capacity(), capacity);
+
+    // scattered edits collapse into one replacement of the whole buffer
+    buffer.clear_changes();
+    for (int i = 0; i < 100; ++i) {
+        buffer.seek(1, 0);
+        buffer.insert('<');
+        buffer.seek(4, 2);
+        buffer.insert('>');
+    }
+    ASSERT_EQUAL(buffer.changes().size(), 1u);
+    ASSERT_TRUE(change_is(buffer.changes()[0], 0, 1, 9, 3, 209, 3));
+    ASSERT_EQUAL(buffer.changes().capacity(), capacity);
+
+    // including the row added by the edit that overflows the log
+    buffer.clear_changes();
+    for (int i = 0; i < 100; ++i) {
+        buffer.seek(1, 0);
+        buffer.insert('\n');
+        buffer.seek_index(buffer.size());
+        buffer.insert('\n');
+    }
+    ASSERT_EQUAL(buffer.row_count(), 204);
+    ASSERT_EQUAL(buffer.changes().size(), 1u);
+    ASSERT_TRUE(change_is(buffer.changes()[0], 0, 1, 209, 3, 409, 203));
+}
+
+TEST(test_assign_in_place) {
+    auto owner = make_shared<string>("ab\ncd\n");
+    TextBuffer buffer;
+    buffer.insert('x');
+    buffer.clear_changes();
+    buffer.assign(string_view(*owner), owner);
+    owner.reset();                  // the buffer keeps it alive if it needs it
+    ASSERT_EQUAL(buffer.stringify(), "ab\ncd\n");
+    ASSERT_EQUAL(buffer.row_count(), 3);
+    ASSERT_EQUAL(buffer.get_index(), 0);
+    ASSERT_EQUAL(buffer.changes().size(), 1u);
+    ASSERT_EQUAL(buffer.changes()[0].removed, 1);
+    ASSERT_EQUAL(buffer.changes()[0].inserted, 6);
+    buffer.seek(2, 1);
+    buffer.insert('!');
+    ASSERT_EQUAL(buffer.stringify(), "ab\nc!d\n");
+}
+
+TEST(test_edit_long_text_assigned_in_place) {
+    string text;
+    for (int i = 0; text.size() < 4 * LineIndex::SCAN_BLOCK; ++i) {
+        text += "row " + to_string(i) + "\n";
+    }
+    auto original = make_shared<const string>(text);
+    TextBuffer buffer;
+    buffer.assign(string_view(*original), original);
+    TextBuffer copied;
+    copied.assign(text);
+    buffer.seek(1000, 2);
+    copied.seek(1000, 2);
+    ASSERT_EQUAL(buffer.get_index(), copied.get_index());
+    buffer.remove(20);          // joins three rows
+    copied.remove(20);
+    buffer.insert("a\nb");
+    copied.insert("a\nb");
+    int begin, end, copied_begin, copied_end;
+    buffer.row_range(buffer.get_index(), begin, end);
+    copied.row_range(copied.get_index(), copied_begin, copied_end);
+    ASSERT_EQUAL(begin, copied_begin);
+    ASSERT_EQUAL(end, copied_end);
+    ASSERT_EQUAL(buffer.rows_up_to(2000), 2000);
+    buffer.seek_index(buffer.size());
+    copied.seek_index(copied.size());
+    ASSERT_EQUAL(buffer.get_row(), copied.get_row());
+    ASSERT_EQUAL(buffer.row_count(), copied.row_count());
+    ASSERT_EQUAL(buffer.stringify(), copied.stringify());
+}
+
+TEST(test_replace_all) {
+    TextBuffer buffer;
+    buffer.insert("one two\none three\ntwo one");
+    buffer.seek(2, 5);                  // on the 'h' of "three"
+    buffer.clear_changes();
+    buffer.replace_all({{0, 3}, {8, 3}, {22, 3}}, "1\n");
+    ASSERT_EQUAL(buffer.stringify(), "1\n two\n1\n three\ntwo 1\n");
+    ASSERT_EQUAL(buffer.data_at_cursor(), 'h');
+    ASSERT_EQUAL(buffer.get_row(), 4);
+    ASSERT_EQUAL(buffer.get_column(), 2);
+    ASSERT_EQUAL(buffer.get_index(), 11);
+    ASSERT_EQUAL(buffer.row_count(), 6);
+    // one entry, from the first range to the end of the last
+    ASSERT_EQUAL(buffer.changes().size(), 1u);
+    ASSERT_EQUAL(buffer.changes()[0].index, 0);
+    ASSERT_EQUAL(buffer.changes()[0].removed, 25);
+    ASSERT_EQUAL(buffer.changes()[0].removed_rows, 2);
+    ASSERT_EQUAL(buffer.changes()[0].inserted, 22);
+    ASSERT_EQUAL(buffer.changes()[0].inserted_rows, 5);
+
+    // a cursor inside a range goes to the start of its replacement
+    buffer.seek(4, 3);                  // on the 'r' of "three"
+    buffer.replace_all({{6, 1}, {10, 5}}, "");
+    ASSERT_EQUAL(buffer.stringify(), "1\n two1\n \ntwo 1\n");
+    ASSERT_EQUAL(buffer.get_index(), 9);
+    ASSERT_EQUAL(buffer.get_row(), 3);
+    ASSERT_EQUAL(buffer.get_column(), 1);
+    buffer.replace_all({}, "x");
+    ASSERT_EQUAL(buffer.stringify(), "1\n two1\n \ntwo 1\n");
+
+    // empty ranges insert the replacement, even at the very end
+    buffer.assign("abc");
+    buffer.seek_index(2);               // on the 'c'
+    buffer.replace_all({{0, 0}, {2, 0}, {3, 0}}, "-");
+    ASSERT_EQUAL(buffer.stringify(), "-ab-c-");
+    ASSERT_EQUAL(buffer.data_at_cursor(), 'c');
+    buffer.replace_all({{6, 0}}, "!");
+    ASSERT_EQUAL(buffer.stringify(), "-ab-c-!");
+}
+
+// Replaces random ranges of a buffer backed by engine CharList, made of
+// many pieces, and checks the result against the same replacements made
+// to a string.
+template <typename CharList>
+bool replace_all_matches() {
+    mt19937 gen(280);
+    BasicTextBuffer<CharList> buffer;
+    for (int i = 0; i < 300; ++i) {
+        buffer.seek_index(gen() % (buffer.size() + 1));
+        buffer.insert(std::string(1 + gen() % 20, "ab\n"[gen() % 3]));
+    }
+    std::string text = buffer.stringify();
+    std::vector<std::pair<int, int>> ranges;
+    std::string expected;
+    int copied = 0;
+    for (int at = gen() % 10; at < static_cast<int>(text.size());
+         at += gen() % 30) {
+        int length = std::min<int>(gen() % 12, text.size() - at);
+        ranges.emplace_back(at, length);
+        expected.append(text, copied, at - copied);
+        expected.append("<\n>");
+        at += length;
+        copied = at;
+    }
+    expected.append(text, copied, std::string::npos);
+    buffer.seek_index(text.size());
+    buffer.replace_all(ranges, "<\n>");
+    return buffer.stringify() == expected
+        && buffer.get_index() == static_cast<int>(expected.size())
+        && buffer.row_count()
+           == std::count(expected.begin(), expected.end(), '\n') + 1;
+}
+
+TEST(test_replace_all_engines_agree) {
+    ASSERT_TRUE(replace_all_matches<std::list<char>>());
+    ASSERT_TRUE(replace_all_matches<List<char>>());
+    ASSERT_TRUE(replace_all_matches<UnrolledList<char>>());
+    ASSERT_TRUE(replace_all_matches<GapBuffer<char>>());
+    ASSERT_TRUE(replace_all_matches<PieceTable<char>>());
+    ASSERT_TRUE(replace_all_matches<Rope<char>>());
+}
+
+TEST(test_snapshot_is_unchanged_by_edits) {
+    TextBuffer buffer;
+    buffer.assign(string("hello\nworld"));
+    TextSnapshot snapshot = buffer.snapshot();
+    buffer.seek(2, 4);
+    buffer.insert('!');
+    buffer.backward();
+    buffer.remove();
+    buffer.remove();
+    ASSERT_EQUAL(buffer.stringify(), "hello\nworl");
+    string copy;
+    snapshot.for_each_chunk([&copy](string_view chunk) {
+        copy.append(chunk);
+        return true;
+    });
+    ASSERT_EQUAL(snapshot.size(), 11);
+    ASSERT_EQUAL(copy, "hello\nworld");
+    ASSERT_EQUAL(TextSnapshot().size(), 0);
+}
+
+TEST(test_piece_table_snapshot_shares_storage) {
+    BasicTextBuffer<PieceTable<char>> buffer;
+    buffer.assign(string("abc\n"));
+    buffer.insert("xy");
+    ASSERT_TRUE(buffer.snapshot_is_cheap());
+    TextSnapshot snapshot = buffer.snapshot();
+    buffer.insert('z');             // goes on in another block of the table
+    buffer.seek_index(0);
+    buffer.remove(2);
+    ASSERT_EQUAL(buffer.stringify(), "zabc\n");
+    string copy;
+    snapshot.for_each_chunk([&copy](string_view chunk) {
+        copy.append(chunk);
+        return true;
+    });
+    ASSERT_EQUAL(copy, "xyabc\n");
+    ASSERT_FALSE(BasicTextBuffer<List<char>>().snapshot_is_cheap());
+}
 
+// Takes a snapshot of a buffer backed by engine CharList, edits the
+// buffer all over, and checks that the snapshot still reads the text it
+// was taken of, and whether it shares the buffer's storage.
+template <typename CharList>
+bool snapshot_survives_edits(bool cheap) {
+    mt19937 gen(281);
+    BasicTextBuffer<CharList> buffer;
+    std::string text;
+    for (int i = 0; i < 20000; ++i) {
+        text += "line " + std::to_string(i) + "\n";
+    }
+    buffer.assign(text);
+    TextSnapshot snapshot = buffer.snapshot();
+    for (int i = 0; i < 300; ++i) {
+        buffer.seek_index(gen() % (buffer.size() + 1));
+        if (i % 3 == 0) {
+            buffer.remove(gen() % 100);
+        } else {
+            buffer.insert(std::string(1 + gen() % 20, "ab\n"[gen() % 3]));
+        }
+    }
+    std::string copy;
+    snapshot.for_each_chunk([&copy](std::string_view chunk) {
+        copy.append(chunk);
+        return true;
+    });
+    return copy == text && snapshot.size() == static_cast<int>(text.size())
+        && buffer.snapshot_is_cheap() == cheap;
+}
+
+TEST(test_snapshot_survives_edits_with_every_engine) {
+    ASSERT_TRUE(snapshot_survives_edits<std::list<char>>(false));
+    ASSERT_TRUE(snapshot_survives_edits<List<char>>(false));
+    ASSERT_TRUE(snapshot_survives_edits<UnrolledList<char>>(true));
+    ASSERT_TRUE(snapshot_survives_edits<GapBuffer<char>>(true));
+    ASSERT_TRUE(snapshot_survives_edits<PieceTable<char>>(true));
+    ASSERT_TRUE(snapshot_survives_edits<Rope<char>>(true));
+}
+
+TEST(test_piece_table_assign_in_place_finds_rows_later) {
+    string text(3 * LineIndex::SCAN_BLOCK, '\n');
+    auto original = make_shared<const string>(text);
+    BasicTextBuffer<PieceTable<char>> buffer;
+    buffer.assign(string_view(*original), original);
+    // the entry replacing the whole buffer counts the rows found so far
+    ASSERT_EQUAL(buffer.changes().size(), 1u);
+    ASSERT_EQUAL(buffer.changes()[0].inserted, buffer.size());
+    ASSERT_TRUE(buffer.changes()[0].inserted_rows < buffer.size());
+    ASSERT_EQUAL(buffer.rows_up_to(10), 10);
+    ASSERT_EQUAL(buffer.row_count(), buffer.size() + 1);
+}
 
 TEST_MAIN()
@@ -0,0 +1,553 @@
+#ifndef UNROLLEDLIST_HPP
+#define UNROLLEDLIST_HPP
+/* UnrolledList.hpp
+ *
+ * unrolled (chunked) doubly-linked list with the same interface as List
+ * EECS 280 Project 4
+ */
+
+#include <iterator>    //std::bidirectional_iterator_tag
+#include <cassert>     //assert
+#include <cstddef>     //std::size_t
+#include <cstring>     //std::memmove, std::memcpy
+#include <memory>      //std::allocator, std::allocator_traits,
+                       //std::allocate_shared, std::shared_ptr
+#include <type_traits> //std::is_trivially_copyable
+#include <utility>     //std::move
+
+
+// The default ChunkSize makes the block of a List<char>-sized chunk,
+// together with its reference counts, about 256 bytes.
+template <typename T, int ChunkSize = 236,
+          typename Allocator = std::allocator<T>>
+class UnrolledList {
+  //OVERVIEW: a doubly-linked list of fixed-size arrays ("chunks") with
+  //          the same interface as List. Neighboring elements share a
+  //          chunk, so sequential walks stay within a cache line most
+  //          of the time and per-element overhead is a fraction of a
+  //          byte instead of two pointers. The elements of a chunk are
+  //          kept in a block that copies of the list share, and a list
+  //          copies a block before it writes to one that a copy also
+  //          holds, so copying only takes O(chunks) and a copy can be
+  //          read on one thread while the list is edited on another.
+  //NOTE:     Elements are moved with memmove, so T must be trivially
+  //          copyable. Unlike List, insert() and erase() may invalidate
+  //          every iterator into the affected chunk (and its neighbor),
+  //          not just the erased one; use the returned iterator. Writing
+  //          an element through an Iterator also writes it in every copy
+  //          that shares its block; use front() or back() instead.
+  static_assert(std::is_trivially_copyable<T>::value,
+                "UnrolledList requires a trivially copyable element type");
+  static_assert(ChunkSize >= 4, "chunks must hold at least 4 elements");
+
+  struct Block {
+    T items[ChunkSize];
+  };
+
+  struct Chunk {
+    Chunk *next;
+    Chunk *prev;
+    int count;          // number of elements in use, 0 < count <= ChunkSize
+    T *items;           // block->items
+    std::shared_ptr<Block> block; // shared by copies of the list
+  };
+
+  using ChunkAllocator = typename std::allocator_traits<Allocator>::
+    template rebind_alloc<Chunk>;
+  using ChunkTraits = std::allocator_traits<ChunkAllocator>;
+  using BlockAllocator = typename std::allocator_traits<Allocator>::
+    template rebind_alloc<Block>;
+
+public:
+  // default ctor
+  UnrolledList() : UnrolledList(Allocator()) {}
+
+  // ctor with an explicit allocator for the chunks
+  explicit UnrolledList(const Allocator &alloc_in)
+    : list_size(0), first(nullptr), last(nullptr), chunk_alloc(alloc_in) {}
+
+  // copy ctor
+  UnrolledList(const UnrolledList &other)
+    : UnrolledList(ChunkTraits::
+                   select_on_container_copy_construction(other.chunk_alloc)) {
+    copy_all(other);
+  }
+
+  // assignment operator
+  UnrolledList & operator=(const UnrolledList &rhs) {
+    if (this != &rhs) {
+      clear();
+      copy_all(rhs);
+    }
+    return *this;
+  }
+
+  // dtor
+  ~UnrolledList() {
+    clear();
+  }
+
+  //EFFECTS:  returns true if the list is empty
+  bool empty() const {
+    return list_size == 0;
+  }
+
+  //EFFECTS: returns the number of elements in this list
+  int size() const {
+    return list_size;
+  }
+
+  //REQUIRES: list is not empty
+  //EFFECTS: Returns the first element in the list by reference
+  T & front() {
+    assert(!empty());
+    return writable(first)[0];
+  }
+
+  //REQUIRES: list is not empty
+  //EFFECTS: Returns the last element in the list by reference
+  T & back() {
+    assert(!empty());
+    return writable(last)[last->count - 1];
+  }
+
+  //EFFECTS:  inserts datum into the front of the list
+  void push_front(const T &datum) {
+    insert(begin(), datum);
+  }
+
+  //EFFECTS:  inserts datum into the back of the list
+  void push_back(const T &datum) {
+    if (last == nullptr || last->count == ChunkSize) {
+      link_after(last, new_chunk());
+    }
+    writable(last)[last->count++] = datum;
+    ++list_size;
+  }
+
+  //REQUIRES: list is not empty
+  //MODIFIES: may invalidate list iterators
+  //EFFECTS:  removes the item at the front of the list
+  void pop_front() {
+    assert(!empty());
+    erase(begin());
+  }
+
+  //REQUIRES: list is not empty
+  //MODIFIES: may invalidate list iterators
+  //EFFECTS:  removes the item at the back of the list
+  void pop_back() {
+    assert(!empty());
+    erase(Iterator(this, last, last->count - 1));
+  }
+
+  //MODIFIES: invalidates all list iterators
+  //EFFECTS:  removes all items from the list
+  void clear() {
+    while (first != nullptr) {
+      Chunk *victim = first;
+      first = first->next;
+      delete_chunk(victim);
+    }
+    last = nullptr;
+    list_size = 0;
+  }
+
+  ////////////////////////////////////////
+  class Iterator {
+    //OVERVIEW: Iterator interface to UnrolledList
+  public:
+    Iterator() : list_ptr(nullptr), chunk_ptr(nullptr), offset(0) {}
+
+    T & operator*() const {
+      assert(list_ptr != nullptr && chunk_ptr != nullptr);
+      return chunk_ptr->items[offset];
+    }
+
+    T * operator->() const {
+      return &operator*();
+    }
+
+    Iterator & operator++() {
+      assert(list_ptr);
+      assert(chunk_ptr != nullptr);
+      if (++offset == chunk_ptr->count) {
+        chunk_ptr = chunk_ptr->next;
+        offset = 0;
+      }
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      operator++();
+      return copy;
+    }
+
+    Iterator & operator--() {
+      assert(list_ptr);
+      assert(*this != list_ptr->begin());
+      if (chunk_ptr == nullptr) { // end moves to the last element
+        chunk_ptr = list_ptr->last;
+        offset = chunk_ptr->count - 1;
+      } else if (offset == 0) {
+        chunk_ptr = chunk_ptr->prev;
+        offset = chunk_ptr->count - 1;
+      } else {
+        --offset;
+      }
+      return *this;
+    }
+
+    Iterator operator--(int) {
+      Iterator copy = *this;
+      operator--();
+      return copy;
+    }
+
+    bool operator==(const Iterator &rhs) const {
+      return list_ptr == rhs.list_ptr && chunk_ptr == rhs.chunk_ptr
+        && offset == rhs.offset;
+    }
+
+    bool operator!=(const Iterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+    // Type aliases required to work with STL algorithms.
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+  private:
+    const UnrolledList *list_ptr;
+    Chunk *chunk_ptr;   // nullptr for the past-the-end position
+    int offset;         // index into chunk_ptr->items
+
+    friend class UnrolledList;
+
+    Iterator(const UnrolledList *lp, Chunk *cp, int off)
+      : list_ptr(lp), chunk_ptr(cp), offset(off) {}
+  };//UnrolledList::Iterator
+  ////////////////////////////////////////
+
+  // return an Iterator pointing to the first element
+  Iterator begin() const {
+    return Iterator(this, first, 0);
+  }
+
+  // return an Iterator pointing to "past the end"
+  Iterator end() const {
+    return Iterator(this, nullptr, 0);
+  }
+
+  //REQUIRES: 0 <= index <= size()
+  //EFFECTS: returns an Iterator to the element at index, skipping whole
+  //         chunks from whichever end of the list is closer
+  Iterator at(int index) const {
+    assert(0 <= index && index <= size());
+    if (index == size()) {
+      return end();
+    }
+    if (index < size() / 2) {
+      Chunk *c = first;
+      for (; index >= c->count; c = c->next) {
+        index -= c->count;
+      }
+      return Iterator(this, c, index);
+    }
+    int remaining = size() - index;   // elements from index to the end
+    Chunk *c = last;
+    for (; remaining > c->count; c = c->prev) {
+      remaining -= c->count;
+    }
+    return Iterator(this, c, c->count - remaining);
+  }
+
+  //REQUIRES: 0 <= begin <= end <= size()
+  //EFFECTS: calls visit(pointer, count) with the elements in [begin, end)
+  //         in place, one block per chunk. visit returns whether to go on
+  //         to the next block.
+  template <typename Visitor>
+  void for_each_chunk(int begin, int end, Visitor visit) const {
+    assert(0 <= begin && begin <= end && end <= size());
+    int remaining = end - begin;
+    Iterator i = at(begin);
+    for (Chunk *c = i.chunk_ptr; remaining > 0; c = c->next) {
+      int count = c->count - i.offset < remaining ? c->count - i.offset
+                                                  : remaining;
+      if (!visit(c->items + i.offset, count)) {
+        return;
+      }
+      remaining -= count;
+      i.offset = 0;
+    }
+  }
+
+  //REQUIRES: i is a valid, dereferenceable iterator associated with this list
+  //MODIFIES: may invalidate other list iterators
+  //EFFECTS: Removes a single element from the list container.
+  //         Returns An iterator pointing to the element that followed the
+  //         element erased by the function call
+  Iterator erase(Iterator i) {
+    assert(i.list_ptr == this);
+    assert(i.chunk_ptr != nullptr);
+    Chunk *chunk = i.chunk_ptr;
+    int offset = i.offset;
+    T *items = writable(chunk);
+    std::memmove(items + offset, items + offset + 1,
+                 (chunk->count - offset - 1) * sizeof(T));
+    --chunk->count;
+    --list_size;
+    if (chunk->count == 0) {
+      Chunk *next = chunk->next;
+      unlink(chunk);
+      delete_chunk(chunk);
+      return Iterator(this, next, 0);
+    }
+    // keep chunks at least half full on average by absorbing the next one
+    Chunk *next = chunk->next;
+    if (next != nullptr && chunk->count + next->count <= ChunkSize / 2) {
+      std::memcpy(writable(chunk) + chunk->count, next->items,
+                  next->count * sizeof(T));
+      chunk->count += next->count;
+      unlink(next);
+      delete_chunk(next);
+    }
+    return normalize(Iterator(this, chunk, offset));
+  }
+
+  //REQUIRES: i is a valid iterator associated with this list
+  //MODIFIES: may invalidate other list iterators
+  //EFFECTS: Inserts datum before the element at the specified position.
+  //         Returns an iterator to the the newly inserted element.
+  Iterator insert(Iterator i, const T &datum) {
+    assert(i.list_ptr == this);
+    Chunk *chunk = i.chunk_ptr;
+    int offset = i.offset;
+    if (chunk == nullptr) {
+      push_back(datum);
+      return Iterator(this, last, last->count - 1);
+    }
+    if (offset == 0 && chunk->prev != nullptr
+        && chunk->prev->count < ChunkSize) {
+      // appending to the previous chunk avoids shifting this one
+      chunk = chunk->prev;
+      offset = chunk->count;
+    } else if (chunk->count == ChunkSize) {
+      // split the full chunk in half; insert into the half holding offset
+      Chunk *upper = new_chunk();
+      int keep = ChunkSize / 2;
+      upper->count = ChunkSize - keep;
+      std::memcpy(upper->items, chunk->items + keep, upper->count * sizeof(T));
+      chunk->count = keep;
+      link_after(chunk, upper);
+      if (offset > keep) {
+        chunk = upper;
+        offset -= keep;
+      }
+    }
+    T *items = writable(chunk);
+    std::memmove(items + offset + 1, items + offset,
+                 (chunk->count - offset) * sizeof(T));
+    items[offset] = datum;
+    ++chunk->count;
+    ++list_size;
+    return Iterator(this, chunk, offset);
+  }
+
+  //REQUIRES: i is a valid iterator associated with this list
+  //MODIFIES: may invalidate other list iterators
+  //EFFECTS: Inserts copies of the elements in [range_begin, range_end)
+  //         before the element at the specified position. The chunk
+  //         holding i is split once and the elements are copied into
+  //         full chunks after it. Returns an iterator to the first
+  //         inserted element, or i if the range is empty.
+  template <typename InputIterator>
+  Iterator insert(Iterator i, InputIterator range_begin,
+                  InputIterator range_end) {
+    assert(i.list_ptr == this);
+    if (range_begin == range_end) {
+      return i;
+    }
+    Chunk *chunk = i.chunk_ptr;
+    Chunk *before;  // the new elements go after the ones in this chunk
+    if (chunk == nullptr) {
+      before = last;
+    } else if (i.offset == 0) {
+      before = chunk->prev;
+    } else {
+      // move the elements from i on into a chunk of their own
+      Chunk *upper = new_chunk();
+      upper->count = chunk->count - i.offset;
+      std::memcpy(upper->items, chunk->items + i.offset,
+                  upper->count * sizeof(T));
+      chunk->count = i.offset;
+      link_after(chunk, upper);
+      before = chunk;
+    }
+    if (before == nullptr || before->count == ChunkSize) {
+      Chunk *fresh = new_chunk();
+      link_after(before, fresh);
+      before = fresh;
+    }
+    Iterator result(this, before, before->count);
+    T *items = writable(before);
+    for (; range_begin != range_end; ++range_begin) {
+      if (before->count == ChunkSize) {
+        Chunk *fresh = new_chunk();
+        link_after(before, fresh);
+        before = fresh;
+        items = fresh->items;
+      }
+      items[before->count++] = *range_begin;
+      ++list_size;
+    }
+    return result;
+  }
+
+  //REQUIRES: [range_begin, range_end) is a valid range of iterators
+  //          associated with this list
+  //MODIFIES: may invalidate other list iterators
+  //EFFECTS: Removes the elements in [range_begin, range_end), trimming
+  //         the chunks at either end and freeing the whole chunks in
+  //         between. Returns an iterator to the element that followed
+  //         the last one erased.
+  Iterator erase(Iterator range_begin, Iterator range_end) {
+    assert(range_begin.list_ptr == this && range_end.list_ptr == this);
+    if (range_begin == range_end) {
+      return range_end;
+    }
+    Chunk *chunk = range_begin.chunk_ptr;
+    int offset = range_begin.offset;
+    Chunk *stop = range_end.chunk_ptr;
+    if (chunk == stop) {
+      int n = range_end.offset - offset;
+      T *items = writable(chunk);
+      std::memmove(items + offset, items + range_end.offset,
+                   (chunk->count - range_end.offset) * sizeof(T));
+      chunk->count -= n;
+      list_size -= n;
+    } else {
+      list_size -= chunk->count - offset;
+      chunk->count = offset;
+      for (Chunk *c = chunk->next; c != stop;) {
+        Chunk *next = c->next;
+        list_size -= c->count;
+        unlink(c);
+        delete_chunk(c);
+        c = next;
+      }
+      if (stop != nullptr) {
+        int n = range_end.offset;
+        T *items = writable(stop);
+        std::memmove(items, items + n, (stop->count - n) * sizeof(T));
+        stop->count -= n;
+        list_size -= n;
+      }
+    }
+    if (chunk->count == 0) {
+      Chunk *next = chunk->next;
+      unlink(chunk);
+      delete_chunk(chunk);
+      return Iterator(this, next, 0);
+    }
+    // keep chunks at least half full on average by absorbing the next one
+    Chunk *next = chunk->next;
+    if (next != nullptr && chunk->count + next->count <= ChunkSize / 2) {
+      std::memcpy(writable(chunk) + chunk->count, next->items,
+                  next->count * sizeof(T));
+      chunk->count += next->count;
+      unlink(next);
+      delete_chunk(next);
+    }
+    return normalize(Iterator(this, chunk, offset));
+  }
+
+private:
+  int list_size;
+  Chunk *first;   // points to first Chunk in list, or nullptr if list is empty
+  Chunk *last;    // points to last Chunk in list, or nullptr if list is empty
+  ChunkAllocator chunk_alloc;
+
+  //REQUIRES: list is empty
+  //EFFECTS:  copies all chunks from other to this, sharing their blocks
+  void copy_all(const UnrolledList &other) {
+    assert(empty());
+    for (Chunk *c = other.first; c != nullptr; c = c->next) {
+      Chunk *copy = new_chunk(c->block);
+      copy->count = c->count;
+      link_after(last, copy);
+      list_size += c->count;
+    }
+  }
+
+  //EFFECTS: moves an iterator sitting one past the end of its chunk
+  //         to the start of the next chunk
+  Iterator normalize(Iterator i) const {
+    if (i.chunk_ptr != nullptr && i.offset == i.chunk_ptr->count) {
+      i.chunk_ptr = i.chunk_ptr->next;
+      i.offset = 0;
+    }
+    return i;
+  }
+
+  //EFFECTS: returns an empty chunk that keeps its elements in block, or
+  //         in a block of its own if block is null
+  Chunk * new_chunk(std::shared_ptr<Block> block = nullptr) {
+    Chunk *c = ChunkTraits::allocate(chunk_alloc, 1);
+    ChunkTraits::construct(chunk_alloc, c);
+    c->next = c->prev = nullptr;
+    c->count = 0;
+    c->block = block != nullptr
+               ? std::move(block)
+               : std::allocate_shared<Block>(BlockAllocator(chunk_alloc));
+    c->items = c->block->items;
+    return c;
+  }
+
+  void delete_chunk(Chunk *c) {
+    ChunkTraits::destroy(chunk_alloc, c);
+    ChunkTraits::deallocate(chunk_alloc, c, 1);
+  }
+
+  //EFFECTS: returns the elements of c, copying its block first if a copy
+  //         of this list also holds it
+  T * writable(Chunk *c) {
+    if (c->block.use_count() > 1) {
+      std::shared_ptr<Block> copy =
+        std::allocate_shared<Block>(BlockAllocator(chunk_alloc));
+      std::memcpy(copy->items, c->items, c->count * sizeof(T));
+      c->block = std::move(copy);
+      c->items = c->block->items;
+    }
+    return c->items;
+  }
+
+  //EFFECTS: links c into the list after pos, or at the front if pos is
+  //         nullptr
+  void link_after(Chunk *pos, Chunk *c) {
+    c->prev = pos;
+    c->next = (pos == nullptr ? first : pos->next);
+    if (c->next != nullptr) {
+      c->next->prev = c;
+    } else {
+      last = c;
+    }
+    if (pos != nullptr) {
+      pos->next = c;
+    } else {
+      first = c;
+    }
+  }
+
+  //EFFECTS: removes c from the chain of chunks without freeing it
+  void unlink(Chunk *c) {
+    (c->prev != nullptr ? c->prev->next : first) = c->next;
+    (c->next != nullptr ? c->next->prev : last) = c->prev;
+  }
+};//UnrolledList
+
+#endif // UNROLLEDLIST_HPP
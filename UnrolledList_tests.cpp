@@ -0,0 +1,222 @@
+#include "UnrolledList.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Small chunks so that splits and merges happen after a few operations.
+using SmallList = UnrolledList<char, 4>;
+
+// EFFECTS: returns the contents of list as a string, walking forward
+static string forward_contents(const SmallList &list) {
+    return string(list.begin(), list.end());
+}
+
+// EFFECTS: returns the contents of list as a string, walking backward
+static string backward_contents(const SmallList &list) {
+    string result;
+    for (SmallList::Iterator it = list.end(); it != list.begin();) {
+        --it;
+        result.insert(result.begin(), *it);
+    }
+    return result;
+}
+
+TEST(test_default_ctor) {
+    SmallList list;
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQUAL(list.size(), 0);
+    ASSERT_TRUE(list.begin() == list.end());
+}
+
+TEST(test_push_and_pop) {
+    SmallList list;
+    for (char c = 'a'; c <= 'j'; ++c) {
+        list.push_back(c);
+    }
+    list.push_front('0');
+    ASSERT_EQUAL(forward_contents(list), "0abcdefghij");
+    ASSERT_EQUAL(backward_contents(list), "0abcdefghij");
+    ASSERT_EQUAL(list.front(), '0');
+    ASSERT_EQUAL(list.back(), 'j');
+    list.pop_front();
+    list.pop_back();
+    ASSERT_EQUAL(forward_contents(list), "abcdefghi");
+    ASSERT_EQUAL(list.size(), 9);
+}
+
+TEST(test_insert_returns_new_element) {
+    SmallList list;
+    for (char c = 'a'; c <= 'h'; ++c) {
+        list.push_back(c);
+    }
+    SmallList::Iterator it = list.begin();
+    for (int i = 0; i < 4; ++i) {
+        ++it;
+    }
+    // typing at a fixed cursor: insert before it, then step past
+    for (char c = 'A'; c <= 'F'; ++c) {
+        it = list.insert(it, c);
+        ASSERT_EQUAL(*it, c);
+        ++it;
+        ASSERT_EQUAL(*it, 'e');
+    }
+    ASSERT_EQUAL(forward_contents(list), "abcdABCDEFefgh");
+    ASSERT_EQUAL(backward_contents(list), "abcdABCDEFefgh");
+}
+
+TEST(test_erase_returns_next_element) {
+    SmallList list;
+    for (char c = 'a'; c <= 'l'; ++c) {
+        list.push_back(c);
+    }
+    SmallList::Iterator it = list.begin();
+    ++it;
+    ++it;
+    for (int i = 0; i < 6; ++i) {
+        it = list.erase(it);
+    }
+    ASSERT_EQUAL(*it, 'i');
+    ASSERT_EQUAL(forward_contents(list), "abijkl");
+    ASSERT_EQUAL(backward_contents(list), "abijkl");
+    while (it != list.end()) {
+        it = list.erase(it);
+    }
+    ASSERT_EQUAL(forward_contents(list), "ab");
+}
+
+TEST(test_copy_and_assign) {
+    SmallList a;
+    for (char c = 'a'; c <= 'z'; ++c) {
+        a.push_back(c);
+    }
+    SmallList b(a);
+    a.clear();
+    ASSERT_TRUE(a.empty());
+    ASSERT_EQUAL(forward_contents(b), "abcdefghijklmnopqrstuvwxyz");
+    a = b;
+    b.clear();
+    ASSERT_EQUAL(backward_contents(a), "abcdefghijklmnopqrstuvwxyz");
+}
+
+TEST(test_copies_keep_their_contents_while_edited) {
+    srand(282);
+    SmallList list;
+    string text = "one two three";
+    list.insert(list.end(), text.begin(), text.end());
+    vector<SmallList> copies;
+    vector<string> expected;
+    for (int step = 0; step < 2000; ++step) {
+        if (step % 100 == 0) {
+            copies.push_back(list);
+            expected.push_back(forward_contents(list));
+        }
+        int pos = rand() % (list.size() + 1);
+        int op = rand() % 4;
+        if (op == 0) {
+            list.push_back(static_cast<char>('a' + rand() % 26));
+        } else if (op == 1) {
+            list.insert(list.at(pos), static_cast<char>('a' + rand() % 26));
+        } else if (op == 2) {
+            string more(rand() % 10, static_cast<char>('A' + rand() % 26));
+            list.insert(list.at(pos), more.begin(), more.end());
+        } else if (pos < list.size()) {
+            int count = rand() % (list.size() - pos + 1);
+            list.erase(list.at(pos), list.at(pos + count));
+        }
+        if (!list.empty() && step % 7 == 0) {
+            list.front() = '<';
+            list.erase(list.at(list.size() - 1));
+        }
+    }
+    for (size_t i = 0; i < copies.size(); ++i) {
+        ASSERT_EQUAL(forward_contents(copies[i]), expected[i]);
+        ASSERT_EQUAL(backward_contents(copies[i]), expected[i]);
+        ASSERT_EQUAL(copies[i].size(), static_cast<int>(expected[i].size()));
+    }
+}
+
+TEST(test_at) {
+    SmallList list;
+    for (char c = 'a'; c <= 'z'; ++c) {
+        list.push_back(c);
+    }
+    list.erase(list.at(5));     // leaves chunks of different sizes
+    list.insert(list.at(20), '!');
+    string expected = "abcdeghijklmnopqrstu!vwxyz";
+    ASSERT_EQUAL(forward_contents(list), expected);
+    for (int i = 0; i < list.size(); ++i) {
+        ASSERT_EQUAL(*list.at(i), expected[i]);
+    }
+    ASSERT_TRUE(list.at(list.size()) == list.end());
+}
+
+TEST(test_random_edits_match_std_list) {
+    srand(280);
+    SmallList list;
+    std::list<char> reference;
+    SmallList::Iterator it = list.begin();
+    std::list<char>::iterator ref_it = reference.begin();
+    for (int step = 0; step < 20000; ++step) {
+        int op = rand() % 4;
+        if (op == 0 && ref_it != reference.end()) {
+            it = list.erase(it);
+            ref_it = reference.erase(ref_it);
+        } else if (op == 1) {
+            char c = static_cast<char>('a' + rand() % 26);
+            it = list.insert(it, c);
+            ref_it = reference.insert(ref_it, c);
+        } else if (op == 2 && ref_it != reference.end()) {
+            ++it;
+            ++ref_it;
+        } else if (op == 3 && ref_it != reference.begin()) {
+            --it;
+            --ref_it;
+        }
+        ASSERT_EQUAL(list.size(), static_cast<int>(reference.size()));
+        ASSERT_EQUAL(it == list.end(), ref_it == reference.end());
+        if (ref_it != reference.end()) {
+            ASSERT_EQUAL(*it, *ref_it);
+        }
+    }
+    string expected(reference.begin(), reference.end());
+    ASSERT_EQUAL(forward_contents(list), expected);
+    ASSERT_EQUAL(backward_contents(list), expected);
+}
+
+TEST(test_random_range_edits_match_std_list) {
+    srand(281);
+    SmallList list;
+    std::list<char> reference;
+    for (int step = 0; step < 2000; ++step) {
+        int size = static_cast<int>(reference.size());
+        int pos = rand() % (size + 1);
+        std::list<char>::iterator ref_it = reference.begin();
+        advance(ref_it, pos);
+        if (rand() % 2 == 0) {
+            string text(rand() % 12, static_cast<char>('a' + step % 26));
+            SmallList::Iterator it = list.insert(list.at(pos), text.begin(),
+                                                 text.end());
+            reference.insert(ref_it, text.begin(), text.end());
+            ASSERT_TRUE(it == list.at(pos));
+        } else {
+            int count = rand() % (size - pos + 1);
+            std::list<char>::iterator ref_last = ref_it;
+            advance(ref_last, count);
+            SmallList::Iterator it = list.erase(list.at(pos),
+                                                list.at(pos + count));
+            reference.erase(ref_it, ref_last);
+            ASSERT_TRUE(it == list.at(pos));
+        }
+        ASSERT_EQUAL(list.size(), static_cast<int>(reference.size()));
+    }
+    string expected(reference.begin(), reference.end());
+    ASSERT_EQUAL(forward_contents(list), expected);
+    ASSERT_EQUAL(backward_contents(list), expected);
+}
+
+TEST_MAIN()
@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <utility> // pair
 #include <ncurses.h>
 #include "TextBuffer.hpp"
@@ -40,53 +41,67 @@ void render_botbar(TextBuffer &buffer, WINDOW *window) {
   wattroff(window, A_REVERSE);
 }
 
+// Draws c, highlighted if it is at the cursor. Returns false once the
+// window is full.
+bool render_char(WINDOW *window, char c, bool at_cursor) {
+  // The display character is either ' ' (if it's a newline) or the char
+  // The display character is what gets highlighted if we're at the point
+  int display = c == '\n' ? ' ' : c;
+  if (at_cursor) display = display|A_STANDOUT;
+  int x, y;
+  getyx(window, y, x);
+  if (y == getmaxy(window) - 1) {
+    // Special corner cases: last line of the buffer
+    if (c != '\n' && x < getmaxx(window) - 1) {
+      waddch(window, display); // Show a regular character (common case)
+    } else {
+      if (c == '\n') waddch(window, display);
+      getyx(window,y,x);
+      while (x != getmaxx(window) - 1){
+        waddch(window, ' ');
+        getyx(window, y, x);
+      }
+      waddch(window, '>');
+      return false;
+    }
+  } else {
+    // Normal cases: in the buffer
+    getyx(window, y, x);
+    if (c != '\n' && x < getmaxx(window) - 1) {
+      waddch(window, display); // Show a regular character (common case)
+    } else if (c == '\n' && x < getmaxx(window) - 1) {
+      waddch(window, display); // Newline (common case)
+      waddch(window, '\n');
+    } else if (c == '\n') {
+      waddch(window, display); // Newline (edge case, newline at end of line)
+    } else {
+      waddch(window, '\\');
+      waddch(window, display); // Wrap to the next line
+    }
+  }
+  return true;
+}
+
 void render_buf(TextBuffer &buffer, WINDOW *window) {
   wmove(window, 0, 0);
   werase(window);
 
-  std::string data = buffer.stringify();
+  // Read the buffer in place, and only as far as fits on the window
   int cursor = buffer.get_index();
-  for (int i = 0; i < static_cast<int>(data.size()); ++i) {
-    char c = data[i];
-    // The display character is either ' ' (if it's a newline) or the char
-    // The display character is what gets highlighted if we're at the point
-    int display = c == '\n' ? ' ' : c;
-    if (i == cursor) display = display|A_STANDOUT;
-    int x, y;
-    getyx(window, y, x);
-    if (y == getmaxy(window) - 1) {
-      // Special corner cases: last line of the buffer
-      if (c != '\n' && x < getmaxx(window) - 1) {
-        waddch(window, display); // Show a regular character (common case)
-      } else {
-        if (c == '\n') waddch(window, display);
-        getyx(window,y,x);
-        while (x != getmaxx(window) - 1){
-          waddch(window, ' ');
-          getyx(window, y, x);
-        }
-        waddch(window, '>');
-        return;
-      }
-    } else {
-      // Normal cases: in the buffer
-      getyx(window, y, x);
-      if (c != '\n' && x < getmaxx(window) - 1) {
-        waddch(window, display); // Show a regular character (common case)
-      } else if (c == '\n' && x < getmaxx(window) - 1) {
-        waddch(window, display); // Newline (common case)
-        waddch(window, '\n');
-      } else if (c == '\n') {
-        waddch(window, display); // Newline (edge case, newline at end of line)
-      } else {
-        waddch(window, '\\');
-        waddch(window, display); // Wrap to the next line
+  int i = 0;
+  bool full = false;
+  buffer.for_each_chunk([&](std::string_view chunk) {
+    for (char c : chunk) {
+      if (!render_char(window, c, i++ == cursor)) {
+        full = true;
+        return false;
       }
     }
-  }
+    return true;
+  });
 
   // We're at the end of the buffer. This only matters if end = cursor
-  if (buffer.is_at_end()) {
+  if (!full && buffer.is_at_end()) {
     waddch(window,' '|A_STANDOUT);
   }
 }
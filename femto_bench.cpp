@@ -0,0 +1,270 @@
+/* femto_bench.cpp
+ *
+ * Latency of the editor itself: replays scripted key sequences (typing,
+ * paging, searching forward and backward for a string or a regular
+ * expression, replacing every "the " in one go, cutting and uncutting,
+ * going to lines, saving) against a large synthetic file on a headless
+ * display, through the same interact() loop and handle_edit_input()
+ * that femto runs on a terminal. Each key's latency runs from reading it
+ * to asking for the next one and is split into render time (drawing and
+ * presenting frames) and edit time (everything else). A key typed at a
+ * ^F or ^G prompt is a key of its own. After the first search, the
+ * matches on screen are found in the background; the time spent on
+ * that is reported at the end. Like femto, the benchmark edits a file
+ * of FemtoEditor::LARGE_FILE or more in a piece table over the mapping.
+ *
+ * Usage: ./femto_bench.exe [megabytes] [rows] [cols]
+ *        (default 100 MB on a 50x120 display)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "FemtoEditor.hpp"
+
+using namespace std;
+
+static const int CTRL_E = 5;
+static const int CTRL_F = 6;
+static const int CTRL_G = 7;
+static const int CTRL_K = 11;
+static const int CTRL_R = 18;
+static const int CTRL_S = 19;
+static const int CTRL_T = 20;
+static const int CTRL_U = 21;
+
+// EFFECTS: Returns n bytes of text with lines of 20-120 chars, made of
+//          words; one line in every 200 or so holds the word "needle".
+static string synthetic_text(size_t n) {
+  static const char *const words[] = {
+    "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog",
+    "int", "return", "while", "std::string", "{", "}", "//", "buffer"
+  };
+  string text;
+  text.reserve(n + 128);
+  mt19937 gen(280);
+  while (text.size() < n) {
+    size_t line_end = text.size() + 20 + gen() % 100;
+    if (gen() % 200 == 0) {
+      text += "needle ";
+    }
+    while (text.size() < line_end) {
+      text += words[gen() % 16];
+      text.push_back(' ');
+    }
+    text.back() = '\n';
+  }
+  text.resize(n);
+  return text;
+}
+
+// A headless display that times every key from when the editor reads
+// it to when the editor asks for the next one.
+class TimingDisplay : public HeadlessDisplay {
+public:
+  // render_seconds returns the editor's total render time so far.
+  TimingDisplay(int rows, int cols, function<double()> render_seconds_in)
+    : HeadlessDisplay(rows, cols), render_seconds(render_seconds_in),
+      pending(false), key_render(0) {}
+
+  int read_key() override {
+    auto now = chrono::steady_clock::now();
+    if (pending) {
+      double total = chrono::duration<double, micro>(now - key_start)
+                       .count();
+      double render = (render_seconds() - key_render) * 1e6;
+      render_us.push_back(render);
+      edit_us.push_back(max(total - render, 0.0));
+      pending = false;
+    }
+    int key = HeadlessDisplay::read_key(); // throws at the end
+    pending = true;
+    key_render = render_seconds();
+    key_start = chrono::steady_clock::now();
+    return key;
+  }
+
+  // EFFECTS: Prints the latencies recorded since the last report and
+  //          forgets them.
+  void report(const char *what) {
+    printf("%s: %zu keys\n", what, edit_us.size());
+    vector<double> total(edit_us.size());
+    for (size_t i = 0; i < total.size(); ++i) {
+      total[i] = edit_us[i] + render_us[i];
+    }
+    print("edit", edit_us);
+    print("render", render_us);
+    print("total", total);
+    fflush(stdout);
+    edit_us.clear();
+    render_us.clear();
+  }
+
+private:
+  function<double()> render_seconds;
+  bool pending;               // whether a key is being handled
+  chrono::steady_clock::time_point key_start;
+  double key_render;          // render seconds when the key was read
+  vector<double> edit_us, render_us;
+
+  static void print(const char *what, vector<double> samples) {
+    if (samples.empty()) {
+      return;
+    }
+    sort(samples.begin(), samples.end());
+    printf("  %-8s p50 %10.2f us  p99 %10.2f us  max %10.2f us\n", what,
+           samples[samples.size() / 2], samples[samples.size() * 99 / 100],
+           samples.back());
+  }
+};
+
+// EFFECTS: Replays the keys queued on display through editor and
+//          reports their latencies.
+template <typename Editor>
+static void replay(Editor &editor, TimingDisplay &display,
+                   const char *what) {
+  editor.interact();
+  display.report(what);
+}
+
+// EFFECTS: Loads the file of megabytes MB and lines lines into an Editor
+//          on a rows x cols display and runs every scenario on it.
+template <typename Editor>
+static void run(const char *filename, size_t megabytes, int lines,
+                int rows, int cols) {
+  const FemtoEditor::RenderStats *stats_of = nullptr;
+  TimingDisplay display(rows, cols, [&stats_of]() {
+    return stats_of ? stats_of->seconds : 0.0;
+  });
+  auto start = chrono::steady_clock::now();
+  Editor editor(filename, FemtoEditor::RAW, display);
+  double load = chrono::duration<double>(chrono::steady_clock::now()
+                                        - start).count();
+  printf("loaded %d lines in %.2f s (%.0f MB/s)\n", lines, load,
+         megabytes / load);
+  stats_of = &editor.render_stats();
+  mt19937 gen(2800);
+
+  // typing a few paragraphs in the middle of the file
+  display.press(CTRL_G);
+  display.type(to_string(lines / 2) + "\n");
+  for (int i = 0; i < 2000; ++i) {
+    display.press(i % 60 == 59 ? '\n' : "the quick brown fox "[i % 20]);
+  }
+  for (int i = 0; i < 200; ++i) {
+    display.press(KEY_BACKSPACE);
+  }
+  replay(editor, display, "typing");
+
+  for (int i = 0; i < 500; ++i) {
+    display.press(KEY_NPAGE);
+  }
+  for (int i = 0; i < 500; ++i) {
+    display.press(KEY_PPAGE);
+  }
+  replay(editor, display, "page down/up");
+
+  for (int i = 0; i < 100; ++i) {
+    display.press(CTRL_F);
+    if (i % 2 == 0) {
+      display.type("needle");
+    }
+    display.press('\n'); // odd searches repeat the previous one
+  }
+  replay(editor, display, "search ^F");
+
+  for (int i = 0; i < 100; ++i) {
+    display.press(CTRL_R);
+    display.press('\n'); // backward, for the previous search
+  }
+  replay(editor, display, "search back ^R");
+
+  display.press(CTRL_F);
+  display.press(CTRL_T);
+  display.type("needle \\w+\n");
+  for (int i = 0; i < 99; ++i) {
+    display.press(CTRL_F);
+    display.press('\n'); // still a regular expression
+  }
+  replay(editor, display, "regex search ^F ^T");
+
+  // over a million matches in the default 100 MB; the max is the ^E
+  // prompt's last \n, which finds and replaces them all
+  display.press(CTRL_E);
+  display.press(CTRL_T); // back to a string
+  display.type("the \na \n");
+  replay(editor, display, "replace all ^E");
+
+  // the same typing as at first, now with each edit restarting the scan
+  // for the matches on screen
+  for (int i = 0; i < 2000; ++i) {
+    display.press(i % 60 == 59 ? '\n' : "the quick brown fox "[i % 20]);
+  }
+  replay(editor, display, "typing, matches highlighted");
+
+  for (int i = 0; i < 50; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      display.press(CTRL_K);
+    }
+    display.press(CTRL_U);
+    display.press(KEY_DOWN);
+  }
+  replay(editor, display, "cut/uncut ^K ^U");
+
+  for (int i = 0; i < 200; ++i) {
+    display.press(CTRL_G);
+    display.type(to_string(1 + gen() % lines) + "\n");
+  }
+  replay(editor, display, "goto ^G");
+
+  for (int i = 0; i < 3; ++i) {
+    display.press(CTRL_S);
+    display.press('\n'); // over the file it was loaded from
+  }
+  replay(editor, display, "save ^S");
+
+  const FemtoEditor::RenderStats &stats = editor.render_stats();
+  printf("%ld frames, %ld bytes, %.2f s rendering\n", stats.frames,
+         stats.bytes, stats.seconds);
+  Highlighter::Stats scans = editor.highlight_stats();
+  printf("%ld highlight scans, %ld cancelled, %.3f s scanning in the "
+         "background (%.1f us per scan)\n", scans.scans, scans.cancelled,
+         scans.seconds, scans.seconds * 1e6
+                        / max(scans.scans + scans.cancelled, 1L));
+}
+
+int main(int argc, char **argv) {
+  size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100;
+  int rows = argc > 2 ? atoi(argv[2]) : 50;
+  int cols = argc > 3 ? atoi(argv[3]) : 120;
+  printf("femto replay benchmark, %zu MB of synthetic text on %dx%d\n",
+         megabytes, rows, cols);
+
+  string text = synthetic_text(megabytes << 20);
+  int lines = count(text.begin(), text.end(), '\n') + 1;
+  char filename[] = "/tmp/femto_bench_XXXXXX";
+  int fd = mkstemp(filename);
+  if (fd < 0) {
+    perror("mkstemp");
+    return 1;
+  }
+  close(fd);
+  ofstream(filename, ios::binary).write(text.data(), text.size());
+  text = string(); // release the source text
+
+  if (FemtoEditor::is_large_file(filename)) {
+    printf("editing it in a piece table over the mapped file\n");
+    run<BasicFemtoEditor<BasicTextBuffer<PieceTable<char>>>>(
+      filename, megabytes, lines, rows, cols);
+  } else {
+    run<FemtoEditor>(filename, megabytes, lines, rows, cols);
+  }
+  unlink(filename);
+}
@@ -9,23 +9,26 @@
 #include <stdio.h>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include "TextBuffer.hpp"
 
 using namespace std;
 
-// REQUIRES: start >= 0 and end <= text.size()
 // MODIFIES: cout
-// EFFECTS:  Prints out the characters from text in the range [start,
-//           end) to cout, replacing newline characters with the \n
-//           escape sequence.
-void print_range(string text, int start, int end) {
-  for (int i = start; i < end; ++i) {
-    if (text[i] == '\n') {
-      cout << "\\n";
-    } else {
-      cout << text[i];
+// EFFECTS:  Prints out the characters from the buffer in the range
+//           [start, end) to cout, replacing newline characters with the
+//           \n escape sequence. Reads the buffer in place.
+void print_range(const TextBuffer &buffer, int start, int end) {
+  buffer.for_each_chunk(start, end, [](string_view chunk) {
+    for (char c : chunk) {
+      if (c == '\n') {
+        cout << "\\n";
+      } else {
+        cout << c;
+      }
     }
-  }
+    return true;
+  });
 }
 
 // MODIFIES: cout
@@ -34,11 +37,10 @@ void print_range(string text, int start, int end) {
 //           the cursor position is signified by a | character. Also
 //           prints out the cursor row and column.
 void visualize_buffer(TextBuffer &buffer) {
-  string text = buffer.stringify();
   int index = buffer.get_index();
-  print_range(text, 0, index);
+  print_range(buffer, 0, index);
   cout << '|';
-  print_range(text, index, text.size());
+  print_range(buffer, index, buffer.size());
   cout << "\t:(" << buffer.get_row() << "," << buffer.get_column()
        << " )\n";
 }